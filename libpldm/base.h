@@ -147,6 +147,122 @@ int pack_pldm_header(const struct pldm_header_info *hdr,
 int unpack_pldm_header(const struct pldm_msg_hdr *msg,
 		       struct pldm_header_info *hdr);
 
+/**
+ * @brief Create a PLDM response message containing only the completion code
+ *
+ * @param[in] instance_id - Message's instance id
+ * @param[in] type - PLDM type of the request
+ * @param[in] command - PLDM command of the request
+ * @param[in] completion_code - PLDM completion code
+ * @param[out] msg - Message will be written to this
+ *
+ * @return pldm_completion_codes
+ * @note  Caller is responsible for memory alloc and dealloc of param 'msg'
+ */
+int encode_cc_only_resp(uint8_t instance_id, uint8_t type, uint8_t command,
+			uint8_t completion_code, struct pldm_msg *msg);
+
+/* Requester */
+
+/**
+ * @brief Create a PLDM request message for GetPLDMTypes
+ *
+ * @param[in] instance_id - Message's instance id
+ * @param[in,out] msg - Message will be written to this
+ *
+ * @return pldm_completion_codes
+ * @note  Caller is responsible for memory alloc and dealloc of param 'msg'
+ */
+int encode_get_types_req(uint8_t instance_id, struct pldm_msg *msg);
+
+/**
+ * @brief Decode a GetPLDMTypes response message
+ *
+ * @param[in] msg - Pointer to PLDM response message payload
+ * @param[in] payload_length - Length of response payload
+ * @param[out] completion_code - PLDM completion code
+ * @param[out] types - pointer to array bitfield8_t[8] containing supported
+ *             types (MAX_TYPES/8) = 8), as per DSP0240
+ *
+ * @return pldm_completion_codes
+ */
+int decode_get_types_resp(const uint8_t *msg, size_t payload_length,
+			  uint8_t *completion_code, bitfield8_t *types);
+
+/**
+ * @brief Create a PLDM request message for GetPLDMCommands
+ *
+ * @param[in] instance_id - Message's instance id
+ * @param[in] type - PLDM Type
+ * @param[in] version - Version for PLDM Type
+ * @param[in,out] msg - Message will be written to this
+ *
+ * @return pldm_completion_codes
+ * @note  Caller is responsible for memory alloc and dealloc of param 'msg'
+ */
+int encode_get_commands_req(uint8_t instance_id, uint8_t type, ver32_t version,
+			    struct pldm_msg *msg);
+
+/**
+ * @brief Decode a GetPLDMCommands response message
+ *
+ * @param[in] msg - Pointer to PLDM response message payload
+ * @param[in] payload_length - Length of response payload
+ * @param[out] completion_code - PLDM completion code
+ * @param[out] commands - pointer to array bitfield8_t[32] containing
+ *             supported commands (PLDM_MAX_CMDS_PER_TYPE/8) = 32), as per
+ *             DSP0240
+ *
+ * @return pldm_completion_codes
+ */
+int decode_get_commands_resp(const uint8_t *msg, size_t payload_length,
+			     uint8_t *completion_code, bitfield8_t *commands);
+
+/* Responder */
+
+/**
+ * @brief Create a PLDM response message for GetPLDMTypes
+ *
+ * @param[in] instance_id - Message's instance id
+ * @param[in] completion_code - PLDM completion code
+ * @param[in] types - pointer to array bitfield8_t[8] containing supported
+ *            types (MAX_TYPES/8) = 8), as per DSP0240
+ * @param[in,out] msg - Message will be written to this
+ *
+ * @return pldm_completion_codes
+ * @note  Caller is responsible for memory alloc and dealloc of param 'msg'
+ */
+int encode_get_types_resp(uint8_t instance_id, uint8_t completion_code,
+			  const bitfield8_t *types, struct pldm_msg *msg);
+
+/**
+ * @brief Decode a GetPLDMCommands request message
+ *
+ * @param[in] msg - Pointer to PLDM request message payload
+ * @param[in] payload_length - Length of request payload
+ * @param[out] type - PLDM Type
+ * @param[out] version - Version for PLDM Type
+ *
+ * @return pldm_completion_codes
+ */
+int decode_get_commands_req(const uint8_t *msg, size_t payload_length,
+			    uint8_t *type, ver32_t *version);
+
+/**
+ * @brief Create a PLDM response message for GetPLDMCommands
+ *
+ * @param[in] instance_id - Message's instance id
+ * @param[in] completion_code - PLDM completion code
+ * @param[in] commands - pointer to array bitfield8_t[32] containing supported
+ *            commands (PLDM_MAX_CMDS_PER_TYPE/8) = 32), as per DSP0240
+ * @param[in,out] msg - Message will be written to this
+ *
+ * @return pldm_completion_codes
+ * @note  Caller is responsible for memory alloc and dealloc of param 'msg'
+ */
+int encode_get_commands_resp(uint8_t instance_id, uint8_t completion_code,
+			     const bitfield8_t *commands, struct pldm_msg *msg);
+
 #ifdef __cplusplus
 }
 #endif
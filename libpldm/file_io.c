@@ -45,7 +45,8 @@ int encode_rw_file_memory_resp(uint8_t instance_id, uint8_t command,
 	struct pldm_read_write_file_memory_resp *response =
 	    (struct pldm_read_write_file_memory_resp *)msg->payload;
 	response->completion_code = completion_code;
-	if (response->completion_code == PLDM_SUCCESS) {
+	if (response->completion_code == PLDM_SUCCESS ||
+	    response->completion_code == PLDM_PARTIAL_TRANSFER) {
 		response->length = htole32(length);
 	}
 
@@ -95,7 +96,8 @@ int decode_rw_file_memory_resp(const uint8_t *msg, size_t payload_length,
 	struct pldm_read_write_file_memory_resp *response =
 	    (struct pldm_read_write_file_memory_resp *)msg;
 	*completion_code = response->completion_code;
-	if (*completion_code == PLDM_SUCCESS) {
+	if (*completion_code == PLDM_SUCCESS ||
+	    *completion_code == PLDM_PARTIAL_TRANSFER) {
 		*length = le32toh(response->length);
 	}
 
@@ -154,3 +156,652 @@ int encode_get_file_table_resp(uint8_t instance_id, uint8_t completion_code,
 
 	return PLDM_SUCCESS;
 }
+
+int encode_get_file_table_req(uint8_t instance_id, uint32_t transfer_handle,
+			      uint8_t transfer_opflag, uint8_t table_type,
+			      struct pldm_msg *msg)
+{
+	struct pldm_header_info header = {0};
+	int rc = PLDM_SUCCESS;
+	if (msg == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	header.msg_type = PLDM_REQUEST;
+	header.instance = instance_id;
+	header.pldm_type = PLDM_IBM_OEM_TYPE;
+	header.command = PLDM_GET_FILE_TABLE;
+
+	if ((rc = pack_pldm_header(&header, &(msg->hdr))) > PLDM_SUCCESS) {
+		return rc;
+	}
+
+	struct pldm_get_file_table_req *request =
+	    (struct pldm_get_file_table_req *)msg->payload;
+	request->transfer_handle = htole32(transfer_handle);
+	request->operation_flag = transfer_opflag;
+	request->table_type = table_type;
+
+	return PLDM_SUCCESS;
+}
+
+int decode_get_file_table_resp(const uint8_t *msg, size_t payload_length,
+			       uint8_t *completion_code,
+			       uint32_t *next_transfer_handle,
+			       uint8_t *transfer_flag,
+			       size_t *table_data_offset, size_t *table_length)
+{
+	if (msg == NULL || completion_code == NULL ||
+	    next_transfer_handle == NULL || transfer_flag == NULL ||
+	    table_data_offset == NULL || table_length == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	if (payload_length < 1) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_get_file_table_resp *response =
+	    (struct pldm_get_file_table_resp *)msg;
+	*completion_code = response->completion_code;
+	if (*completion_code != PLDM_SUCCESS) {
+		return PLDM_SUCCESS;
+	}
+
+	if (payload_length < PLDM_GET_FILE_TABLE_MIN_RESP_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	*next_transfer_handle = le32toh(response->next_transfer_handle);
+	*transfer_flag = response->transfer_flag;
+	*table_data_offset = PLDM_GET_FILE_TABLE_MIN_RESP_BYTES;
+	*table_length = payload_length - PLDM_GET_FILE_TABLE_MIN_RESP_BYTES;
+
+	return PLDM_SUCCESS;
+}
+
+int decode_read_file_req(const uint8_t *msg, size_t payload_length,
+			 uint32_t *file_handle, uint32_t *offset,
+			 uint32_t *length)
+{
+	if (msg == NULL || file_handle == NULL || offset == NULL ||
+	    length == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	if (payload_length != PLDM_READ_FILE_REQ_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_read_file_req *request = (struct pldm_read_file_req *)msg;
+
+	*file_handle = le32toh(request->file_handle);
+	*offset = le32toh(request->offset);
+	*length = le32toh(request->length);
+
+	return PLDM_SUCCESS;
+}
+
+int encode_read_file_req(uint8_t instance_id, uint32_t file_handle,
+			 uint32_t offset, uint32_t length,
+			 struct pldm_msg *msg)
+{
+	struct pldm_header_info header = {0};
+	int rc = PLDM_SUCCESS;
+	if (msg == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	header.msg_type = PLDM_REQUEST;
+	header.instance = instance_id;
+	header.pldm_type = PLDM_IBM_OEM_TYPE;
+	header.command = PLDM_READ_FILE;
+
+	if ((rc = pack_pldm_header(&header, &(msg->hdr))) > PLDM_SUCCESS) {
+		return rc;
+	}
+
+	struct pldm_read_file_req *request =
+	    (struct pldm_read_file_req *)msg->payload;
+	request->file_handle = htole32(file_handle);
+	request->offset = htole32(offset);
+	request->length = htole32(length);
+
+	return PLDM_SUCCESS;
+}
+
+int encode_read_file_resp(uint8_t instance_id, uint8_t completion_code,
+			  uint32_t length, struct pldm_msg *msg)
+{
+	struct pldm_header_info header = {0};
+	int rc = PLDM_SUCCESS;
+	if (msg == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	header.msg_type = PLDM_RESPONSE;
+	header.instance = instance_id;
+	header.pldm_type = PLDM_IBM_OEM_TYPE;
+	header.command = PLDM_READ_FILE;
+
+	if ((rc = pack_pldm_header(&header, &(msg->hdr))) > PLDM_SUCCESS) {
+		return rc;
+	}
+
+	struct pldm_read_file_resp *response =
+	    (struct pldm_read_file_resp *)msg->payload;
+	response->completion_code = completion_code;
+	if (response->completion_code == PLDM_SUCCESS) {
+		response->length = htole32(length);
+	}
+
+	return PLDM_SUCCESS;
+}
+
+int decode_read_file_resp(const uint8_t *msg, size_t payload_length,
+			  uint8_t *completion_code, uint32_t *length,
+			  size_t *file_data_offset)
+{
+	if (msg == NULL || completion_code == NULL || length == NULL ||
+	    file_data_offset == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	if (payload_length < PLDM_READ_FILE_RESP_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_read_file_resp *response =
+	    (struct pldm_read_file_resp *)msg;
+	*completion_code = response->completion_code;
+	if (*completion_code == PLDM_SUCCESS) {
+		*length = le32toh(response->length);
+		if (*length != payload_length - PLDM_READ_FILE_RESP_BYTES) {
+			return PLDM_ERROR_INVALID_LENGTH;
+		}
+		*file_data_offset = PLDM_READ_FILE_RESP_BYTES;
+	}
+
+	return PLDM_SUCCESS;
+}
+
+int decode_write_file_req(const uint8_t *msg, size_t payload_length,
+			  uint32_t *file_handle, uint32_t *offset,
+			  uint32_t *length, size_t *file_data_offset)
+{
+	if (msg == NULL || file_handle == NULL || offset == NULL ||
+	    length == NULL || file_data_offset == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	if (payload_length < PLDM_WRITE_FILE_REQ_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_write_file_req *request =
+	    (struct pldm_write_file_req *)msg;
+
+	*file_handle = le32toh(request->file_handle);
+	*offset = le32toh(request->offset);
+	*length = le32toh(request->length);
+	if (*length != payload_length - PLDM_WRITE_FILE_REQ_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+	*file_data_offset = PLDM_WRITE_FILE_REQ_BYTES;
+
+	return PLDM_SUCCESS;
+}
+
+int encode_write_file_req(uint8_t instance_id, uint32_t file_handle,
+			  uint32_t offset, uint32_t length,
+			  struct pldm_msg *msg)
+{
+	struct pldm_header_info header = {0};
+	int rc = PLDM_SUCCESS;
+	if (msg == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	header.msg_type = PLDM_REQUEST;
+	header.instance = instance_id;
+	header.pldm_type = PLDM_IBM_OEM_TYPE;
+	header.command = PLDM_WRITE_FILE;
+
+	if ((rc = pack_pldm_header(&header, &(msg->hdr))) > PLDM_SUCCESS) {
+		return rc;
+	}
+
+	struct pldm_write_file_req *request =
+	    (struct pldm_write_file_req *)msg->payload;
+	request->file_handle = htole32(file_handle);
+	request->offset = htole32(offset);
+	request->length = htole32(length);
+
+	return PLDM_SUCCESS;
+}
+
+int encode_write_file_resp(uint8_t instance_id, uint8_t completion_code,
+			   uint32_t length, struct pldm_msg *msg)
+{
+	struct pldm_header_info header = {0};
+	int rc = PLDM_SUCCESS;
+	if (msg == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	header.msg_type = PLDM_RESPONSE;
+	header.instance = instance_id;
+	header.pldm_type = PLDM_IBM_OEM_TYPE;
+	header.command = PLDM_WRITE_FILE;
+
+	if ((rc = pack_pldm_header(&header, &(msg->hdr))) > PLDM_SUCCESS) {
+		return rc;
+	}
+
+	struct pldm_write_file_resp *response =
+	    (struct pldm_write_file_resp *)msg->payload;
+	response->completion_code = completion_code;
+	if (response->completion_code == PLDM_SUCCESS) {
+		response->length = htole32(length);
+	}
+
+	return PLDM_SUCCESS;
+}
+
+int decode_write_file_resp(const uint8_t *msg, size_t payload_length,
+			   uint8_t *completion_code, uint32_t *length)
+{
+	if (msg == NULL || completion_code == NULL || length == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	if (payload_length != PLDM_WRITE_FILE_RESP_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_write_file_resp *response =
+	    (struct pldm_write_file_resp *)msg;
+	*completion_code = response->completion_code;
+	if (*completion_code == PLDM_SUCCESS) {
+		*length = le32toh(response->length);
+	}
+
+	return PLDM_SUCCESS;
+}
+
+int decode_get_changed_blocks_req(const uint8_t *msg, size_t payload_length,
+				  uint32_t *file_handle, uint32_t *offset,
+				  uint64_t *generation)
+{
+	if (msg == NULL || file_handle == NULL || offset == NULL ||
+	    generation == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	if (payload_length != PLDM_GET_CHANGED_BLOCKS_REQ_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_get_changed_blocks_req *request =
+	    (struct pldm_get_changed_blocks_req *)msg;
+
+	*file_handle = le32toh(request->file_handle);
+	*offset = le32toh(request->offset);
+	*generation = le64toh(request->generation);
+
+	return PLDM_SUCCESS;
+}
+
+int encode_get_changed_blocks_req(uint8_t instance_id, uint32_t file_handle,
+				  uint32_t offset, uint64_t generation,
+				  struct pldm_msg *msg)
+{
+	struct pldm_header_info header = {0};
+	int rc = PLDM_SUCCESS;
+	if (msg == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	header.msg_type = PLDM_REQUEST;
+	header.instance = instance_id;
+	header.pldm_type = PLDM_IBM_OEM_TYPE;
+	header.command = PLDM_GET_CHANGED_BLOCKS;
+
+	if ((rc = pack_pldm_header(&header, &(msg->hdr))) > PLDM_SUCCESS) {
+		return rc;
+	}
+
+	struct pldm_get_changed_blocks_req *request =
+	    (struct pldm_get_changed_blocks_req *)msg->payload;
+	request->file_handle = htole32(file_handle);
+	request->offset = htole32(offset);
+	request->generation = htole64(generation);
+
+	return PLDM_SUCCESS;
+}
+
+int encode_get_changed_blocks_resp(uint8_t instance_id,
+				   uint8_t completion_code,
+				   uint64_t generation, uint32_t file_size,
+				   uint32_t next_offset,
+				   const struct pldm_changed_range *ranges,
+				   uint16_t range_count, struct pldm_msg *msg)
+{
+	struct pldm_header_info header = {0};
+	int rc = PLDM_SUCCESS;
+	if (msg == NULL || (range_count && ranges == NULL)) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	header.msg_type = PLDM_RESPONSE;
+	header.instance = instance_id;
+	header.pldm_type = PLDM_IBM_OEM_TYPE;
+	header.command = PLDM_GET_CHANGED_BLOCKS;
+
+	if ((rc = pack_pldm_header(&header, &(msg->hdr))) > PLDM_SUCCESS) {
+		return rc;
+	}
+
+	struct pldm_get_changed_blocks_resp *response =
+	    (struct pldm_get_changed_blocks_resp *)msg->payload;
+	response->completion_code = completion_code;
+	if (response->completion_code == PLDM_SUCCESS) {
+		response->generation = htole64(generation);
+		response->file_size = htole32(file_size);
+		response->next_offset = htole32(next_offset);
+		response->range_count = htole16(range_count);
+		for (uint16_t i = 0; i < range_count; i++) {
+			response->ranges[i].offset = htole32(ranges[i].offset);
+			response->ranges[i].length = htole32(ranges[i].length);
+		}
+	}
+
+	return PLDM_SUCCESS;
+}
+
+int decode_get_changed_blocks_resp(const uint8_t *msg, size_t payload_length,
+				   uint8_t *completion_code,
+				   uint64_t *generation, uint32_t *file_size,
+				   uint32_t *next_offset,
+				   uint16_t *range_count,
+				   size_t *ranges_offset)
+{
+	if (msg == NULL || completion_code == NULL || generation == NULL ||
+	    file_size == NULL || next_offset == NULL || range_count == NULL ||
+	    ranges_offset == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	if (payload_length < 1) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_get_changed_blocks_resp *response =
+	    (struct pldm_get_changed_blocks_resp *)msg;
+	*completion_code = response->completion_code;
+	if (*completion_code != PLDM_SUCCESS) {
+		return PLDM_SUCCESS;
+	}
+
+	if (payload_length < PLDM_GET_CHANGED_BLOCKS_MIN_RESP_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	*generation = le64toh(response->generation);
+	*file_size = le32toh(response->file_size);
+	*next_offset = le32toh(response->next_offset);
+	*range_count = le16toh(response->range_count);
+	if (payload_length != PLDM_GET_CHANGED_BLOCKS_MIN_RESP_BYTES +
+				  *range_count *
+				      sizeof(struct pldm_changed_range)) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+	*ranges_offset = PLDM_GET_CHANGED_BLOCKS_MIN_RESP_BYTES;
+
+	return PLDM_SUCCESS;
+}
+
+int decode_get_file_checksum_req(const uint8_t *msg, size_t payload_length,
+				 uint32_t *file_handle, uint32_t *offset,
+				 uint32_t *length, uint8_t *checksum_type)
+{
+	if (msg == NULL || file_handle == NULL || offset == NULL ||
+	    length == NULL || checksum_type == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	if (payload_length != PLDM_GET_FILE_CHECKSUM_REQ_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_get_file_checksum_req *request =
+	    (struct pldm_get_file_checksum_req *)msg;
+
+	*file_handle = le32toh(request->file_handle);
+	*offset = le32toh(request->offset);
+	*length = le32toh(request->length);
+	*checksum_type = request->checksum_type;
+
+	return PLDM_SUCCESS;
+}
+
+int encode_get_file_checksum_req(uint8_t instance_id, uint32_t file_handle,
+				 uint32_t offset, uint32_t length,
+				 uint8_t checksum_type, struct pldm_msg *msg)
+{
+	struct pldm_header_info header = {0};
+	int rc = PLDM_SUCCESS;
+	if (msg == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	header.msg_type = PLDM_REQUEST;
+	header.instance = instance_id;
+	header.pldm_type = PLDM_IBM_OEM_TYPE;
+	header.command = PLDM_GET_FILE_CHECKSUM;
+
+	if ((rc = pack_pldm_header(&header, &(msg->hdr))) > PLDM_SUCCESS) {
+		return rc;
+	}
+
+	struct pldm_get_file_checksum_req *request =
+	    (struct pldm_get_file_checksum_req *)msg->payload;
+	request->file_handle = htole32(file_handle);
+	request->offset = htole32(offset);
+	request->length = htole32(length);
+	request->checksum_type = checksum_type;
+
+	return PLDM_SUCCESS;
+}
+
+int encode_get_file_checksum_resp(uint8_t instance_id, uint8_t completion_code,
+				  uint32_t length, const uint8_t *digest,
+				  uint8_t digest_length, struct pldm_msg *msg)
+{
+	struct pldm_header_info header = {0};
+	int rc = PLDM_SUCCESS;
+	if (msg == NULL || (digest_length && digest == NULL) ||
+	    digest_length > PLDM_GET_FILE_CHECKSUM_MAX_DIGEST_BYTES) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	header.msg_type = PLDM_RESPONSE;
+	header.instance = instance_id;
+	header.pldm_type = PLDM_IBM_OEM_TYPE;
+	header.command = PLDM_GET_FILE_CHECKSUM;
+
+	if ((rc = pack_pldm_header(&header, &(msg->hdr))) > PLDM_SUCCESS) {
+		return rc;
+	}
+
+	struct pldm_get_file_checksum_resp *response =
+	    (struct pldm_get_file_checksum_resp *)msg->payload;
+	response->completion_code = completion_code;
+	if (response->completion_code == PLDM_SUCCESS) {
+		response->length = htole32(length);
+		response->digest_length = digest_length;
+		memcpy(response->digest, digest, digest_length);
+	}
+
+	return PLDM_SUCCESS;
+}
+
+int decode_get_file_checksum_resp(const uint8_t *msg, size_t payload_length,
+				  uint8_t *completion_code, uint32_t *length,
+				  uint8_t *digest_length,
+				  size_t *digest_offset)
+{
+	if (msg == NULL || completion_code == NULL || length == NULL ||
+	    digest_length == NULL || digest_offset == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	if (payload_length < 1) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_get_file_checksum_resp *response =
+	    (struct pldm_get_file_checksum_resp *)msg;
+	*completion_code = response->completion_code;
+	if (*completion_code != PLDM_SUCCESS) {
+		return PLDM_SUCCESS;
+	}
+
+	if (payload_length < PLDM_GET_FILE_CHECKSUM_MIN_RESP_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	*length = le32toh(response->length);
+	*digest_length = response->digest_length;
+	if (payload_length !=
+	    PLDM_GET_FILE_CHECKSUM_MIN_RESP_BYTES + *digest_length) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+	*digest_offset = PLDM_GET_FILE_CHECKSUM_MIN_RESP_BYTES;
+
+	return PLDM_SUCCESS;
+}
+
+int decode_follow_file_req(const uint8_t *msg, size_t payload_length,
+			   uint32_t *file_handle, uint32_t *cursor,
+			   uint32_t *file_id, uint32_t *length)
+{
+	if (msg == NULL || file_handle == NULL || cursor == NULL ||
+	    file_id == NULL || length == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	if (payload_length != PLDM_FOLLOW_FILE_REQ_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_follow_file_req *request =
+	    (struct pldm_follow_file_req *)msg;
+
+	*file_handle = le32toh(request->file_handle);
+	*cursor = le32toh(request->cursor);
+	*file_id = le32toh(request->file_id);
+	*length = le32toh(request->length);
+
+	return PLDM_SUCCESS;
+}
+
+int encode_follow_file_req(uint8_t instance_id, uint32_t file_handle,
+			   uint32_t cursor, uint32_t file_id, uint32_t length,
+			   struct pldm_msg *msg)
+{
+	struct pldm_header_info header = {0};
+	int rc = PLDM_SUCCESS;
+	if (msg == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	header.msg_type = PLDM_REQUEST;
+	header.instance = instance_id;
+	header.pldm_type = PLDM_IBM_OEM_TYPE;
+	header.command = PLDM_FOLLOW_FILE;
+
+	if ((rc = pack_pldm_header(&header, &(msg->hdr))) > PLDM_SUCCESS) {
+		return rc;
+	}
+
+	struct pldm_follow_file_req *request =
+	    (struct pldm_follow_file_req *)msg->payload;
+	request->file_handle = htole32(file_handle);
+	request->cursor = htole32(cursor);
+	request->file_id = htole32(file_id);
+	request->length = htole32(length);
+
+	return PLDM_SUCCESS;
+}
+
+int encode_follow_file_resp(uint8_t instance_id, uint8_t completion_code,
+			    uint32_t cursor, uint32_t file_id,
+			    uint32_t file_size, uint32_t length,
+			    struct pldm_msg *msg)
+{
+	struct pldm_header_info header = {0};
+	int rc = PLDM_SUCCESS;
+	if (msg == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	header.msg_type = PLDM_RESPONSE;
+	header.instance = instance_id;
+	header.pldm_type = PLDM_IBM_OEM_TYPE;
+	header.command = PLDM_FOLLOW_FILE;
+
+	if ((rc = pack_pldm_header(&header, &(msg->hdr))) > PLDM_SUCCESS) {
+		return rc;
+	}
+
+	struct pldm_follow_file_resp *response =
+	    (struct pldm_follow_file_resp *)msg->payload;
+	response->completion_code = completion_code;
+	if (response->completion_code == PLDM_SUCCESS) {
+		response->cursor = htole32(cursor);
+		response->file_id = htole32(file_id);
+		response->file_size = htole32(file_size);
+		response->length = htole32(length);
+	}
+
+	return PLDM_SUCCESS;
+}
+
+int decode_follow_file_resp(const uint8_t *msg, size_t payload_length,
+			    uint8_t *completion_code, uint32_t *cursor,
+			    uint32_t *file_id, uint32_t *file_size,
+			    uint32_t *length, size_t *file_data_offset)
+{
+	if (msg == NULL || completion_code == NULL || cursor == NULL ||
+	    file_id == NULL || file_size == NULL || length == NULL ||
+	    file_data_offset == NULL) {
+		return PLDM_ERROR_INVALID_DATA;
+	}
+
+	if (payload_length < 1) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	struct pldm_follow_file_resp *response =
+	    (struct pldm_follow_file_resp *)msg;
+	*completion_code = response->completion_code;
+	if (*completion_code != PLDM_SUCCESS) {
+		return PLDM_SUCCESS;
+	}
+
+	if (payload_length < PLDM_FOLLOW_FILE_MIN_RESP_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+
+	*cursor = le32toh(response->cursor);
+	*file_id = le32toh(response->file_id);
+	*file_size = le32toh(response->file_size);
+	*length = le32toh(response->length);
+	if (*length != payload_length - PLDM_FOLLOW_FILE_MIN_RESP_BYTES) {
+		return PLDM_ERROR_INVALID_LENGTH;
+	}
+	*file_data_offset = PLDM_FOLLOW_FILE_MIN_RESP_BYTES;
+
+	return PLDM_SUCCESS;
+}
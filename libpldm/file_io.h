@@ -16,8 +16,13 @@ extern "C" {
  */
 enum pldm_fileio_commands {
 	PLDM_GET_FILE_TABLE = 0x1,
+	PLDM_READ_FILE = 0x4,
+	PLDM_WRITE_FILE = 0x5,
 	PLDM_READ_FILE_INTO_MEMORY = 0x6,
 	PLDM_WRITE_FILE_FROM_MEMORY = 0x7,
+	PLDM_GET_CHANGED_BLOCKS = 0x20,
+	PLDM_GET_FILE_CHECKSUM = 0x21,
+	PLDM_FOLLOW_FILE = 0x22,
 };
 
 /** @brief PLDM Command specific codes
@@ -29,6 +34,11 @@ enum pldm_fileio_completion_codes {
 	PLDM_INVALID_WRITE_LENGTH = 0x83,
 	PLDM_FILE_TABLE_UNAVAILABLE = 0x84,
 	PLDM_INVALID_FILE_TABLE_TYPE = 0x85,
+	/* ReadFileIntoMemory or WriteFileFromMemory failed after moving the
+	 * number of bytes in the response, the requester may resume the
+	 * transfer at offset + length */
+	PLDM_PARTIAL_TRANSFER = 0x86,
+	PLDM_INVALID_CHECKSUM_TYPE = 0x87,
 };
 
 /** @brief PLDM File I/O table types
@@ -38,10 +48,30 @@ enum pldm_fileio_table_type {
 	PLDM_OEM_FILE_ATTRIBUTE_TABLE = 1,
 };
 
+/** @brief PLDM File I/O checksum types
+ */
+enum pldm_fileio_checksum_type {
+	/* CRC-32 (IEEE 802.3) of the range, 4 bytes little endian */
+	PLDM_CHECKSUM_CRC32 = 0,
+	/* SHA-256 of the range, 32 bytes */
+	PLDM_CHECKSUM_SHA256 = 1,
+};
+
 #define PLDM_RW_FILE_MEM_REQ_BYTES 20
 #define PLDM_RW_FILE_MEM_RESP_BYTES 5
 #define PLDM_GET_FILE_TABLE_REQ_BYTES 6
 #define PLDM_GET_FILE_TABLE_MIN_RESP_BYTES 6
+#define PLDM_READ_FILE_REQ_BYTES 12
+#define PLDM_READ_FILE_RESP_BYTES 5
+#define PLDM_WRITE_FILE_REQ_BYTES 12
+#define PLDM_WRITE_FILE_RESP_BYTES 5
+#define PLDM_GET_CHANGED_BLOCKS_REQ_BYTES 16
+#define PLDM_GET_CHANGED_BLOCKS_MIN_RESP_BYTES 19
+#define PLDM_GET_FILE_CHECKSUM_REQ_BYTES 13
+#define PLDM_GET_FILE_CHECKSUM_MIN_RESP_BYTES 6
+#define PLDM_GET_FILE_CHECKSUM_MAX_DIGEST_BYTES 32
+#define PLDM_FOLLOW_FILE_REQ_BYTES 16
+#define PLDM_FOLLOW_FILE_MIN_RESP_BYTES 17
 
 /** @struct pldm_read_write_file_memory_req
  *
@@ -88,7 +118,8 @@ int decode_rw_file_memory_req(const uint8_t *msg, size_t payload_length,
  *  @param[in] command - PLDM command
  *  @param[in] completion_code - PLDM completion code
  *  @param[in] length - Number of bytes read. This could be less than
- *                      what the  requester asked for.
+ *                      what the  requester asked for. Encoded for
+ *                      PLDM_SUCCESS and PLDM_PARTIAL_TRANSFER.
  *  @param[out] msg - Message will be written to this
  *  @return pldm_completion_codes
  *  @note  Caller is responsible for memory alloc and dealloc of param 'msg'
@@ -121,7 +152,8 @@ int encode_rw_file_memory_req(uint8_t instance_id, uint8_t command,
  *  @param[in] msg - pointer to PLDM response message payload
  *  @param[in] payload_length - Length of response payload
  *  @param[out] completion_code - PLDM completion code
- *  @param[out] length - Number of bytes to be read/written
+ *  @param[out] length - Number of bytes to be read/written, or moved before
+ *                       the failure for PLDM_PARTIAL_TRANSFER
  *  @return pldm_completion_codes
  */
 int decode_rw_file_memory_resp(const uint8_t *msg, size_t payload_length,
@@ -148,6 +180,26 @@ struct pldm_get_file_table_resp {
 	uint8_t table_data[1];	 //!< Table Data
 } __attribute__((packed));
 
+/** @struct pldm_oem_file_attr_entry
+ *
+ *  Structure representing an entry in the OEM file attribute table. The
+ *  entries are followed by pad bytes and a CRC-32 checksum, as in the file
+ *  attribute table.
+ *
+ *  The generation starts from the time the responder started, in seconds
+ *  since the Epoch, so it is not reused across restarts of the responder
+ *  unless the files changed faster than once a second. A host should only
+ *  skip re-reading a file if both its generation and checksum match the
+ *  ones it read the file with.
+ */
+struct pldm_oem_file_attr_entry {
+	uint32_t file_handle; //!< A Handle to the file
+	uint32_t checksum;    //!< CRC-32 of the file contents
+	uint64_t mtime;       //!< Modification time in ns since the Epoch
+	uint32_t generation;  //!< Incremented when the file contents change
+	uint32_t alignment;   //!< Preferred transfer alignment in bytes
+} __attribute__((packed));
+
 /** @brief Decode GetFileTable command request data
  *
  *  @param[in] msg - Pointer to PLDM request message payload
@@ -179,6 +231,464 @@ int encode_get_file_table_resp(uint8_t instance_id, uint8_t completion_code,
 			       uint8_t transfer_flag, const uint8_t *table_data,
 			       size_t table_size, struct pldm_msg *msg);
 
+/** @brief Encode GetFileTable command request data
+ *
+ *  @param[in] instance_id - Message's instance id
+ *  @param[in] transfer_handle - the handle of data
+ *  @param[in] transfer_opflag - Transfer operation flag
+ *  @param[in] table_type - the type of file table
+ *  @param[out] msg - Message will be written to this
+ *  @return pldm_completion_codes
+ */
+int encode_get_file_table_req(uint8_t instance_id, uint32_t transfer_handle,
+			      uint8_t transfer_opflag, uint8_t table_type,
+			      struct pldm_msg *msg);
+
+/** @brief Decode GetFileTable command response data
+ *
+ *  @param[in] msg - Pointer to PLDM response message payload
+ *  @param[in] payload_length - Length of response payload
+ *  @param[out] completion_code - PLDM completion code
+ *  @param[out] next_transfer_handle - Handle to identify next portion of
+ *              data transfer
+ *  @param[out] transfer_flag - Represents the part of transfer
+ *  @param[out] table_data_offset - Offset of the table data in the payload
+ *  @param[out] table_length - Length of the table data
+ *  @return pldm_completion_codes
+ */
+int decode_get_file_table_resp(const uint8_t *msg, size_t payload_length,
+			       uint8_t *completion_code,
+			       uint32_t *next_transfer_handle,
+			       uint8_t *transfer_flag,
+			       size_t *table_data_offset, size_t *table_length);
+
+/** @struct pldm_read_file_req
+ *
+ *  Structure representing ReadFile request
+ */
+struct pldm_read_file_req {
+	uint32_t file_handle; //!< A Handle to the file
+	uint32_t offset;      //!< Offset to the file
+	uint32_t length;      //!< Number of bytes to be read
+} __attribute__((packed));
+
+/** @struct pldm_read_file_resp
+ *
+ *  Structure representing ReadFile response data
+ */
+struct pldm_read_file_resp {
+	uint8_t completion_code; //!< Completion code
+	uint32_t length;	 //!< Number of bytes read
+	uint8_t file_data[1];    //!< Address of this is where file data starts
+} __attribute__((packed));
+
+/** @struct pldm_write_file_req
+ *
+ *  Structure representing WriteFile request
+ */
+struct pldm_write_file_req {
+	uint32_t file_handle; //!< A Handle to the file
+	uint32_t offset;      //!< Offset to the file
+	uint32_t length;      //!< Number of bytes to be written
+	uint8_t file_data[1]; //!< Address of this is where file data starts
+} __attribute__((packed));
+
+/** @struct pldm_write_file_resp
+ *
+ *  Structure representing WriteFile response data
+ */
+struct pldm_write_file_resp {
+	uint8_t completion_code; //!< Completion code
+	uint32_t length;	 //!< Number of bytes written
+} __attribute__((packed));
+
+/** @brief Decode ReadFile command request data
+ *
+ *  @param[in] msg - Pointer to PLDM request message payload
+ *  @param[in] payload_length - Length of request payload
+ *  @param[out] file_handle - A handle to the file
+ *  @param[out] offset - Offset to the file at which the read should begin
+ *  @param[out] length - Number of bytes to be read
+ *  @return pldm_completion_codes
+ */
+int decode_read_file_req(const uint8_t *msg, size_t payload_length,
+			 uint32_t *file_handle, uint32_t *offset,
+			 uint32_t *length);
+
+/** @brief Encode ReadFile command request data
+ *
+ *  @param[in] instance_id - Message's instance id
+ *  @param[in] file_handle - A handle to the file
+ *  @param[in] offset - Offset to the file at which the read should begin
+ *  @param[in] length - Number of bytes to be read
+ *  @param[out] msg - Message will be written to this
+ *  @return pldm_completion_codes
+ */
+int encode_read_file_req(uint8_t instance_id, uint32_t file_handle,
+			 uint32_t offset, uint32_t length,
+			 struct pldm_msg *msg);
+
+/** @brief Create a PLDM response for ReadFile
+ *
+ *  @param[in] instance_id - Message's instance id
+ *  @param[in] completion_code - PLDM completion code
+ *  @param[in] length - Number of bytes read. This could be less than what the
+ *                      requester asked for.
+ *  @param[in,out] msg - Message will be written to this
+ *  @return pldm_completion_codes
+ *  @note  Caller is responsible for memory alloc and dealloc of param 'msg',
+ *         and for filling in the file data after the fixed response fields
+ */
+int encode_read_file_resp(uint8_t instance_id, uint8_t completion_code,
+			  uint32_t length, struct pldm_msg *msg);
+
+/** @brief Decode ReadFile command response data
+ *
+ *  @param[in] msg - Pointer to PLDM response message payload
+ *  @param[in] payload_length - Length of response payload
+ *  @param[out] completion_code - PLDM completion code
+ *  @param[out] length - Number of bytes read
+ *  @param[out] file_data_offset - Offset of the file data in the payload
+ *  @return pldm_completion_codes
+ */
+int decode_read_file_resp(const uint8_t *msg, size_t payload_length,
+			  uint8_t *completion_code, uint32_t *length,
+			  size_t *file_data_offset);
+
+/** @brief Decode WriteFile command request data
+ *
+ *  @param[in] msg - Pointer to PLDM request message payload
+ *  @param[in] payload_length - Length of request payload
+ *  @param[out] file_handle - A handle to the file
+ *  @param[out] offset - Offset to the file at which the write should begin
+ *  @param[out] length - Number of bytes to be written
+ *  @param[out] file_data_offset - Offset of the file data in the payload
+ *  @return pldm_completion_codes
+ */
+int decode_write_file_req(const uint8_t *msg, size_t payload_length,
+			  uint32_t *file_handle, uint32_t *offset,
+			  uint32_t *length, size_t *file_data_offset);
+
+/** @brief Encode WriteFile command request data
+ *
+ *  @param[in] instance_id - Message's instance id
+ *  @param[in] file_handle - A handle to the file
+ *  @param[in] offset - Offset to the file at which the write should begin
+ *  @param[in] length - Number of bytes to be written
+ *  @param[in,out] msg - Message will be written to this
+ *  @return pldm_completion_codes
+ *  @note  Caller is responsible for memory alloc and dealloc of param 'msg',
+ *         and for filling in the file data after the fixed request fields
+ */
+int encode_write_file_req(uint8_t instance_id, uint32_t file_handle,
+			  uint32_t offset, uint32_t length,
+			  struct pldm_msg *msg);
+
+/** @brief Create a PLDM response for WriteFile
+ *
+ *  @param[in] instance_id - Message's instance id
+ *  @param[in] completion_code - PLDM completion code
+ *  @param[in] length - Number of bytes written
+ *  @param[out] msg - Message will be written to this
+ *  @return pldm_completion_codes
+ *  @note  Caller is responsible for memory alloc and dealloc of param 'msg'
+ */
+int encode_write_file_resp(uint8_t instance_id, uint8_t completion_code,
+			   uint32_t length, struct pldm_msg *msg);
+
+/** @brief Decode WriteFile command response data
+ *
+ *  @param[in] msg - Pointer to PLDM response message payload
+ *  @param[in] payload_length - Length of response payload
+ *  @param[out] completion_code - PLDM completion code
+ *  @param[out] length - Number of bytes written
+ *  @return pldm_completion_codes
+ */
+int decode_write_file_resp(const uint8_t *msg, size_t payload_length,
+			   uint8_t *completion_code, uint32_t *length);
+
+/** @struct pldm_get_changed_blocks_req
+ *
+ *  Structure representing GetChangedBlocks request
+ */
+struct pldm_get_changed_blocks_req {
+	uint32_t file_handle; //!< A Handle to the file
+	uint32_t offset;      //!< Offset to the file to start looking at, 0
+			      //!< to start a scan
+	uint64_t generation;  //!< Generation returned by an earlier scan, 0
+			      //!< for the whole file
+} __attribute__((packed));
+
+/** @struct pldm_changed_range
+ *
+ *  Structure representing a range of a file that changed
+ */
+struct pldm_changed_range {
+	uint32_t offset; //!< Offset to the file
+	uint32_t length; //!< Number of bytes
+} __attribute__((packed));
+
+/** @struct pldm_get_changed_blocks_resp
+ *
+ *  Structure representing GetChangedBlocks response data
+ *
+ *  A scan of the file starts with a request for offset 0 and follows
+ *  next_offset until it equals file_size. Only the first page of a scan
+ *  returns the current generation. Later pages return the generation of the
+ *  request, which is no newer than that of the first page, so that blocks
+ *  that change while the host pages through the ranges are reported again
+ *  by the next scan. The host should pass the generation of the first page
+ *  in the first request of its next scan.
+ */
+struct pldm_get_changed_blocks_resp {
+	uint8_t completion_code; //!< Completion code
+	uint64_t generation;     //!< Generation to pass in the first request
+				 //!< of the next scan, see above
+	uint32_t file_size;      //!< Current size of the file
+	uint32_t next_offset;    //!< Offset to pass in the request for the
+				 //!< next ranges, file_size if there are none
+	uint16_t range_count;    //!< Number of ranges that follow
+	struct pldm_changed_range ranges[1]; //!< Changed ranges
+} __attribute__((packed));
+
+/** @brief Decode GetChangedBlocks command request data
+ *
+ *  @param[in] msg - Pointer to PLDM request message payload
+ *  @param[in] payload_length - Length of request payload
+ *  @param[out] file_handle - A handle to the file
+ *  @param[out] offset - Offset to the file to start looking at
+ *  @param[out] generation - Generation the changes are wanted since
+ *  @return pldm_completion_codes
+ */
+int decode_get_changed_blocks_req(const uint8_t *msg, size_t payload_length,
+				  uint32_t *file_handle, uint32_t *offset,
+				  uint64_t *generation);
+
+/** @brief Encode GetChangedBlocks command request data
+ *
+ *  @param[in] instance_id - Message's instance id
+ *  @param[in] file_handle - A handle to the file
+ *  @param[in] offset - Offset to the file to start looking at
+ *  @param[in] generation - Generation the changes are wanted since
+ *  @param[out] msg - Message will be written to this
+ *  @return pldm_completion_codes
+ */
+int encode_get_changed_blocks_req(uint8_t instance_id, uint32_t file_handle,
+				  uint32_t offset, uint64_t generation,
+				  struct pldm_msg *msg);
+
+/** @brief Create a PLDM response for GetChangedBlocks
+ *
+ *  @param[in] instance_id - Message's instance id
+ *  @param[in] completion_code - PLDM completion code
+ *  @param[in] generation - Current generation
+ *  @param[in] file_size - Current size of the file
+ *  @param[in] next_offset - Offset to continue at
+ *  @param[in] ranges - Changed ranges, in host byte order
+ *  @param[in] range_count - Number of changed ranges
+ *  @param[out] msg - Message will be written to this
+ *  @return pldm_completion_codes
+ *  @note  Caller is responsible for memory alloc and dealloc of param 'msg'
+ */
+int encode_get_changed_blocks_resp(uint8_t instance_id,
+				   uint8_t completion_code,
+				   uint64_t generation, uint32_t file_size,
+				   uint32_t next_offset,
+				   const struct pldm_changed_range *ranges,
+				   uint16_t range_count, struct pldm_msg *msg);
+
+/** @brief Decode GetChangedBlocks command response data
+ *
+ *  @param[in] msg - Pointer to PLDM response message payload
+ *  @param[in] payload_length - Length of response payload
+ *  @param[out] completion_code - PLDM completion code
+ *  @param[out] generation - Current generation
+ *  @param[out] file_size - Current size of the file
+ *  @param[out] next_offset - Offset to continue at
+ *  @param[out] range_count - Number of changed ranges
+ *  @param[out] ranges_offset - Offset of the ranges in the payload, which
+ *                              are little endian pldm_changed_range
+ *  @return pldm_completion_codes
+ */
+int decode_get_changed_blocks_resp(const uint8_t *msg, size_t payload_length,
+				   uint8_t *completion_code,
+				   uint64_t *generation, uint32_t *file_size,
+				   uint32_t *next_offset,
+				   uint16_t *range_count,
+				   size_t *ranges_offset);
+
+/** @struct pldm_get_file_checksum_req
+ *
+ *  Structure representing GetFileChecksum request
+ */
+struct pldm_get_file_checksum_req {
+	uint32_t file_handle;  //!< A Handle to the file
+	uint32_t offset;       //!< Offset to the file
+	uint32_t length;       //!< Number of bytes, clipped to the end of the
+			       //!< file
+	uint8_t checksum_type; //!< pldm_fileio_checksum_type
+} __attribute__((packed));
+
+/** @struct pldm_get_file_checksum_resp
+ *
+ *  Structure representing GetFileChecksum response data
+ */
+struct pldm_get_file_checksum_resp {
+	uint8_t completion_code; //!< Completion code
+	uint32_t length;         //!< Number of bytes the checksum covers
+	uint8_t digest_length;   //!< Number of bytes of digest that follow
+	uint8_t digest[1];       //!< Digest
+} __attribute__((packed));
+
+/** @brief Decode GetFileChecksum command request data
+ *
+ *  @param[in] msg - Pointer to PLDM request message payload
+ *  @param[in] payload_length - Length of request payload
+ *  @param[out] file_handle - A handle to the file
+ *  @param[out] offset - Offset to the file
+ *  @param[out] length - Number of bytes to checksum
+ *  @param[out] checksum_type - pldm_fileio_checksum_type
+ *  @return pldm_completion_codes
+ */
+int decode_get_file_checksum_req(const uint8_t *msg, size_t payload_length,
+				 uint32_t *file_handle, uint32_t *offset,
+				 uint32_t *length, uint8_t *checksum_type);
+
+/** @brief Encode GetFileChecksum command request data
+ *
+ *  @param[in] instance_id - Message's instance id
+ *  @param[in] file_handle - A handle to the file
+ *  @param[in] offset - Offset to the file
+ *  @param[in] length - Number of bytes to checksum
+ *  @param[in] checksum_type - pldm_fileio_checksum_type
+ *  @param[out] msg - Message will be written to this
+ *  @return pldm_completion_codes
+ */
+int encode_get_file_checksum_req(uint8_t instance_id, uint32_t file_handle,
+				 uint32_t offset, uint32_t length,
+				 uint8_t checksum_type, struct pldm_msg *msg);
+
+/** @brief Create a PLDM response for GetFileChecksum
+ *
+ *  @param[in] instance_id - Message's instance id
+ *  @param[in] completion_code - PLDM completion code
+ *  @param[in] length - Number of bytes the checksum covers
+ *  @param[in] digest - Digest
+ *  @param[in] digest_length - Number of bytes of digest
+ *  @param[out] msg - Message will be written to this
+ *  @return pldm_completion_codes
+ *  @note  Caller is responsible for memory alloc and dealloc of param 'msg'
+ */
+int encode_get_file_checksum_resp(uint8_t instance_id, uint8_t completion_code,
+				  uint32_t length, const uint8_t *digest,
+				  uint8_t digest_length, struct pldm_msg *msg);
+
+/** @brief Decode GetFileChecksum command response data
+ *
+ *  @param[in] msg - Pointer to PLDM response message payload
+ *  @param[in] payload_length - Length of response payload
+ *  @param[out] completion_code - PLDM completion code
+ *  @param[out] length - Number of bytes the checksum covers
+ *  @param[out] digest_length - Number of bytes of digest
+ *  @param[out] digest_offset - Offset of the digest in the payload
+ *  @return pldm_completion_codes
+ */
+int decode_get_file_checksum_resp(const uint8_t *msg, size_t payload_length,
+				  uint8_t *completion_code, uint32_t *length,
+				  uint8_t *digest_length,
+				  size_t *digest_offset);
+
+/** @struct pldm_follow_file_req
+ *
+ *  Structure representing FollowFile request
+ */
+struct pldm_follow_file_req {
+	uint32_t file_handle; //!< A Handle to the file
+	uint32_t cursor;      //!< Cursor returned by an earlier request, 0 for
+			      //!< the start of the file
+	uint32_t file_id;     //!< File id returned with the cursor, 0 for the
+			      //!< first request
+	uint32_t length;      //!< Largest number of bytes to return
+} __attribute__((packed));
+
+/** @struct pldm_follow_file_resp
+ *
+ *  Structure representing FollowFile response data
+ */
+struct pldm_follow_file_resp {
+	uint8_t completion_code; //!< Completion code
+	uint32_t cursor;	 //!< Cursor to pass in the next request
+	uint32_t file_id;	 //!< Id of the file the cursor is in, changes
+				 //!< when the file is replaced
+	uint32_t file_size;      //!< Current size of the file, more data is
+				 //!< pending if it is past the cursor
+	uint32_t length;	 //!< Number of bytes that follow
+	uint8_t file_data[1];    //!< Address of this is where file data starts
+} __attribute__((packed));
+
+/** @brief Decode FollowFile command request data
+ *
+ *  @param[in] msg - Pointer to PLDM request message payload
+ *  @param[in] payload_length - Length of request payload
+ *  @param[out] file_handle - A handle to the file
+ *  @param[out] cursor - Offset to the file of the first byte to return
+ *  @param[out] file_id - Id of the file the cursor is in, 0 if unknown
+ *  @param[out] length - Largest number of bytes to return
+ *  @return pldm_completion_codes
+ */
+int decode_follow_file_req(const uint8_t *msg, size_t payload_length,
+			   uint32_t *file_handle, uint32_t *cursor,
+			   uint32_t *file_id, uint32_t *length);
+
+/** @brief Encode FollowFile command request data
+ *
+ *  @param[in] instance_id - Message's instance id
+ *  @param[in] file_handle - A handle to the file
+ *  @param[in] cursor - Offset to the file of the first byte to return
+ *  @param[in] file_id - Id of the file the cursor is in, 0 if unknown
+ *  @param[in] length - Largest number of bytes to return
+ *  @param[out] msg - Message will be written to this
+ *  @return pldm_completion_codes
+ */
+int encode_follow_file_req(uint8_t instance_id, uint32_t file_handle,
+			   uint32_t cursor, uint32_t file_id, uint32_t length,
+			   struct pldm_msg *msg);
+
+/** @brief Create a PLDM response for FollowFile
+ *
+ *  @param[in] instance_id - Message's instance id
+ *  @param[in] completion_code - PLDM completion code
+ *  @param[in] cursor - Cursor to pass in the next request
+ *  @param[in] file_id - Id of the file the cursor is in
+ *  @param[in] file_size - Current size of the file
+ *  @param[in] length - Number of bytes returned
+ *  @param[in,out] msg - Message will be written to this
+ *  @return pldm_completion_codes
+ *  @note  Caller is responsible for memory alloc and dealloc of param 'msg',
+ *         and for filling in the file data after the fixed response fields
+ */
+int encode_follow_file_resp(uint8_t instance_id, uint8_t completion_code,
+			    uint32_t cursor, uint32_t file_id,
+			    uint32_t file_size, uint32_t length,
+			    struct pldm_msg *msg);
+
+/** @brief Decode FollowFile command response data
+ *
+ *  @param[in] msg - Pointer to PLDM response message payload
+ *  @param[in] payload_length - Length of response payload
+ *  @param[out] completion_code - PLDM completion code
+ *  @param[out] cursor - Cursor to pass in the next request
+ *  @param[out] file_id - Id of the file the cursor is in
+ *  @param[out] file_size - Current size of the file
+ *  @param[out] length - Number of bytes returned
+ *  @param[out] file_data_offset - Offset of the file data in the payload
+ *  @return pldm_completion_codes
+ */
+int decode_follow_file_resp(const uint8_t *msg, size_t payload_length,
+			    uint8_t *completion_code, uint32_t *cursor,
+			    uint32_t *file_id, uint32_t *file_size,
+			    uint32_t *length, size_t *file_data_offset);
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,6 +10,7 @@ typedef union {
 		uint8_t bit1 : 1;
 		uint8_t bit2 : 1;
 		uint8_t bit3 : 1;
+		uint8_t bit4 : 1;
 		uint8_t bit5 : 1;
 		uint8_t bit6 : 1;
 		uint8_t bit7 : 1;
@@ -0,0 +1,101 @@
+#include "config.h"
+
+#include "admission.hpp"
+
+#include "metrics.hpp"
+
+#include <algorithm>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace
+{
+
+// Bytes DMA transfers have in flight at once, see --with-dma-budget
+#ifdef DMA_BUDGET
+constexpr uint64_t dmaBudget = DMA_BUDGET;
+#else
+constexpr uint64_t dmaBudget = 64 * 1024 * 1024;
+#endif
+
+// Longest time a chunk waits to be admitted, well below the time the host
+// waits for a response
+constexpr std::chrono::milliseconds admissionTimeout(100);
+
+} // namespace
+
+AdmissionController::Reservation AdmissionController::admit(uint64_t bytes)
+{
+    metrics::Timer timer;
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!released.wait_for(lock, timeout, [&] { return fits(bytes); }))
+    {
+        lock.unlock();
+        metrics::recordAdmission(timer.elapsed(), false);
+        return Reservation(nullptr, 0);
+    }
+    inFlightBytes += bytes;
+    lock.unlock();
+    metrics::recordAdmission(timer.elapsed(), true);
+    return Reservation(this, bytes);
+}
+
+bool AdmissionController::tryAdmit(uint64_t bytes,
+                                   std::chrono::nanoseconds waited,
+                                   Waiter wake)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!fits(bytes))
+        {
+            if (wake)
+            {
+                waiters.push_back(std::move(wake));
+            }
+            return false;
+        }
+        inFlightBytes += bytes;
+    }
+    metrics::recordAdmission(waited, true);
+    return true;
+}
+
+void AdmissionController::release(uint64_t bytes)
+{
+    std::vector<Waiter> woken;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        inFlightBytes -= std::min(bytes, inFlightBytes);
+        woken.swap(waiters);
+    }
+    released.notify_all();
+
+    for (auto& wake : woken)
+    {
+        wake();
+    }
+}
+
+void AdmissionController::reject(std::chrono::nanoseconds waited)
+{
+    metrics::recordAdmission(waited, false);
+}
+
+uint64_t AdmissionController::inFlight()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return inFlightBytes;
+}
+
+AdmissionController& admission()
+{
+    static AdmissionController controller(dmaBudget, admissionTimeout);
+    return controller;
+}
+
+} // namespace responder
+} // namespace pldm
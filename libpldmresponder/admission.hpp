@@ -0,0 +1,169 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+/** @class AdmissionController
+ *
+ *  AdmissionController bounds the number of bytes that DMA transfers have in
+ *  flight at once, across all transfers. Each DMA chunk stages up to its
+ *  length in a buffer and maps as much of the XDMA window, so the budget
+ *  bounds the memory that concurrent transfers pin. A chunk is admitted once
+ *  its length fits in what is left of the budget; a chunk larger than the
+ *  whole budget is admitted when nothing else is in flight, so that it does
+ *  not wait forever.
+ *
+ *  Chunks that wait longer than the timeout are not admitted, and the
+ *  request is answered with PLDM_ERROR_NOT_READY so that the host retries
+ *  later instead of waiting on a reply that may come after its own timeout.
+ *  The time chunks wait is recorded in the metrics.
+ */
+class AdmissionController
+{
+  public:
+    /** @class Reservation
+     *
+     *  Returns the bytes of an admitted chunk to the budget when it goes out
+     *  of scope
+     */
+    class Reservation
+    {
+      public:
+        Reservation(AdmissionController* controller, uint64_t bytes) :
+            controller(controller), bytes(bytes)
+        {
+        }
+
+        Reservation() = delete;
+        Reservation(const Reservation&) = delete;
+        Reservation& operator=(const Reservation&) = delete;
+
+        Reservation(Reservation&& other) :
+            controller(other.controller), bytes(other.bytes)
+        {
+            other.controller = nullptr;
+        }
+
+        Reservation& operator=(Reservation&&) = delete;
+
+        ~Reservation()
+        {
+            if (controller)
+            {
+                controller->release(bytes);
+            }
+        }
+
+        /** @brief Check if the chunk was admitted */
+        explicit operator bool() const
+        {
+            return controller != nullptr;
+        }
+
+      private:
+        AdmissionController* controller;
+        uint64_t bytes;
+    };
+
+    /** @brief Create an admission controller
+     *
+     * @param[in] budget - number of bytes admitted at once
+     * @param[in] timeout - longest time a chunk waits to be admitted
+     */
+    AdmissionController(uint64_t budget, std::chrono::milliseconds timeout) :
+        budgetBytes(budget), timeout(timeout)
+    {
+    }
+
+    AdmissionController() = delete;
+    ~AdmissionController() = default;
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    /** @brief Admit a chunk, waiting up to the timeout for room in the budget
+     *
+     * @param[in] bytes - length of the chunk
+     *
+     * @return Reservation - returns the bytes when destroyed, false if the
+     *                       chunk was not admitted in time
+     */
+    Reservation admit(uint64_t bytes);
+
+    /** @brief Called when bytes may have been returned, see tryAdmit */
+    using Waiter = std::function<void()>;
+
+    /** @brief Try to admit a chunk without waiting
+     *
+     * @param[in] bytes - length of the chunk
+     * @param[in] waited - time the chunk has waited so far, recorded in the
+     *                     metrics if it is admitted
+     * @param[in] wake - if the chunk is not admitted, called once on the
+     *                   thread that next returns bytes to the budget
+     *
+     * @return bool - true if the chunk was admitted and the bytes must be
+     *                returned with release, false if there is no room
+     */
+    bool tryAdmit(uint64_t bytes, std::chrono::nanoseconds waited,
+                  Waiter wake = nullptr);
+
+    /** @brief Return the bytes of a chunk admitted with tryAdmit
+     *
+     * @param[in] bytes - length of the chunk
+     */
+    void release(uint64_t bytes);
+
+    /** @brief Record that a chunk gave up waiting, for callers of tryAdmit
+     *
+     * @param[in] waited - time the chunk waited
+     */
+    void reject(std::chrono::nanoseconds waited);
+
+    /** @brief Get the longest time a chunk waits to be admitted */
+    std::chrono::milliseconds maxWait() const
+    {
+        return timeout;
+    }
+
+    /** @brief Get the number of bytes admitted and not yet released */
+    uint64_t inFlight();
+
+  private:
+    /** @brief Check if a chunk fits in the budget, with the mutex held */
+    bool fits(uint64_t bytes) const
+    {
+        return !inFlightBytes || inFlightBytes + bytes <= budgetBytes;
+    }
+
+    uint64_t budgetBytes;
+    std::chrono::milliseconds timeout;
+
+    /** @brief bytes admitted and not yet released */
+    uint64_t inFlightBytes = 0;
+
+    /** @brief callers of tryAdmit waiting for bytes to be returned */
+    std::vector<Waiter> waiters;
+
+    std::mutex mutex;
+    std::condition_variable released;
+};
+
+/** @brief Get the admission controller of the DMA transfers, with the budget
+ *         set by --with-dma-budget
+ *
+ *  @return AdmissionController& - Reference to instance of the controller
+ */
+AdmissionController& admission();
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,243 @@
+#include "block_hashes.hpp"
+
+#include "crc32.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace
+{
+
+// Number of files whose block hashes are kept
+constexpr size_t blockHashesCapacity = 16;
+
+uint64_t modificationTime(const struct stat& st)
+{
+    return static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000 +
+           st.st_mtim.tv_nsec;
+}
+
+size_t blockCount(const struct stat& st)
+{
+    return (st.st_size + dedupBlockSize - 1) / dedupBlockSize;
+}
+
+/** @brief Write all of a buffer at an offset */
+int writeAll(int fd, const char* data, size_t length, uint64_t offset)
+{
+    size_t count = 0;
+    while (count < length)
+    {
+        auto rc = pwrite(fd, data + count, length - count, offset + count);
+        if (rc < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (rc < 0)
+        {
+            return -errno;
+        }
+        count += rc;
+    }
+    return 0;
+}
+
+/** @brief Check if a block of the file holds the given data */
+bool unchanged(int fd, const char* data, uint64_t offset)
+{
+    char current[dedupBlockSize];
+    size_t count = 0;
+    while (count < dedupBlockSize)
+    {
+        auto rc = pread(fd, current + count, dedupBlockSize - count,
+                        offset + count);
+        if (rc < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (rc <= 0)
+        {
+            return false;
+        }
+        count += rc;
+    }
+    return memcmp(current, data, dedupBlockSize) == 0;
+}
+
+} // namespace
+
+BlockHashes::Entry& BlockHashes::find(const fs::path& path)
+{
+    std::string key = path.string();
+    auto iter = entries.find(key);
+    if (iter != entries.end())
+    {
+        return iter->second;
+    }
+
+    if (entries.size() >= capacity)
+    {
+        auto oldest = std::min_element(
+            entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+                return a.second.lastUse < b.second.lastUse;
+            });
+        entries.erase(oldest);
+    }
+    return entries[key];
+}
+
+BlockHashes::Entry& BlockHashes::lookup(const fs::path& path,
+                                        const struct stat& st)
+{
+    auto& entry = find(path);
+    if (entry.inode != st.st_ino || entry.size != st.st_size ||
+        entry.mtime != modificationTime(st))
+    {
+        entry.hashes.assign(blockCount(st), 0);
+        entry.inode = st.st_ino;
+        entry.size = st.st_size;
+        entry.mtime = modificationTime(st);
+    }
+    entry.lastUse = ++accessCount;
+    return entry;
+}
+
+std::vector<BlockHashes::Hash> BlockHashes::get(const fs::path& path,
+                                                const struct stat& st,
+                                                size_t first, size_t count)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = lookup(path, st);
+
+    std::vector<Hash> hashes(count);
+    for (size_t i = first; i < std::min(first + count, entry.hashes.size());
+         ++i)
+    {
+        hashes[i - first] = entry.hashes[i];
+    }
+    return hashes;
+}
+
+void BlockHashes::set(const fs::path& path, const struct stat& st,
+                      size_t first, const std::vector<Hash>& hashes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = find(path);
+    if (entry.inode != st.st_ino)
+    {
+        entry.hashes.clear();
+        entry.inode = st.st_ino;
+    }
+
+    // The write may have grown the file, the hashes of the other blocks are
+    // still those of their contents
+    entry.hashes.resize(blockCount(st), 0);
+    entry.size = st.st_size;
+    entry.mtime = modificationTime(st);
+    entry.lastUse = ++accessCount;
+    for (size_t i = 0; i < hashes.size() && first + i < entry.hashes.size();
+         ++i)
+    {
+        entry.hashes[first + i] = hashes[i];
+    }
+}
+
+BlockHashes& blockHashes()
+{
+    static BlockHashes hashes(blockHashesCapacity);
+    return hashes;
+}
+
+ssize_t writeChanged(int fd, const fs::path& path, uint64_t offset,
+                     uint32_t length, const char* data)
+{
+    struct stat st
+    {
+    };
+    if (fstat(fd, &st) < 0)
+    {
+        return -errno;
+    }
+
+    uint64_t end = offset + length;
+    size_t first = (offset + dedupBlockSize - 1) / dedupBlockSize;
+    size_t last = end / dedupBlockSize;
+    if (first >= last)
+    {
+        auto rc = writeAll(fd, data, length, offset);
+        return rc < 0 ? rc : 0;
+    }
+
+    auto known = blockHashes().get(path, st, first, last - first);
+    std::vector<BlockHashes::Hash> hashes(known.size());
+
+    // Changed blocks are written in runs, starting with the partial block
+    // at the start of the range
+    uint64_t runStart = offset;
+    bool inRun = offset < first * dedupBlockSize;
+    size_t skipped = 0;
+    for (size_t i = 0; i < known.size(); ++i)
+    {
+        uint64_t blockOffset = (first + i) * dedupBlockSize;
+        const char* block = data + (blockOffset - offset);
+        hashes[i] = BlockHashes::hash(crc32::compute(block, dedupBlockSize));
+
+        bool same = (known[i] == 0 || known[i] == hashes[i]) &&
+                    unchanged(fd, block, blockOffset);
+        if (!same)
+        {
+            if (!inRun)
+            {
+                runStart = blockOffset;
+                inRun = true;
+            }
+            continue;
+        }
+
+        skipped += dedupBlockSize;
+        if (inRun)
+        {
+            auto rc = writeAll(fd, data + (runStart - offset),
+                               blockOffset - runStart, runStart);
+            if (rc < 0)
+            {
+                return rc;
+            }
+            inRun = false;
+        }
+    }
+
+    // The partial block at the end of the range is always written
+    if (!inRun && end > last * dedupBlockSize)
+    {
+        runStart = last * dedupBlockSize;
+        inRun = true;
+    }
+    if (inRun)
+    {
+        auto rc = writeAll(fd, data + (runStart - offset), end - runStart,
+                           runStart);
+        if (rc < 0)
+        {
+            return rc;
+        }
+    }
+
+    if (fstat(fd, &st) == 0)
+    {
+        blockHashes().set(path, st, first, hashes);
+    }
+    return skipped;
+}
+
+} // namespace responder
+} // namespace pldm
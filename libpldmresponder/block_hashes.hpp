@@ -0,0 +1,156 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace fs = std::filesystem;
+
+/** @brief Size of the blocks written files are compared in */
+constexpr size_t dedupBlockSize = 4096;
+
+/** @class BlockHashes
+ *
+ *  BlockHashes keeps the CRC-32 of every block of the files written from the
+ *  host, so that a rewrite of a block whose hash changed goes to storage
+ *  without reading the old contents first. The hashes of a file are dropped
+ *  when its inode, size or modification time differ from the ones they were
+ *  taken with, so changes made by other writers are picked up. A hash is
+ *  never trusted to skip a write on its own, a match is confirmed against
+ *  the contents of the file.
+ */
+class BlockHashes
+{
+  public:
+    /** @brief Hash of a block, with the known flag set, or 0 if unknown */
+    using Hash = uint64_t;
+
+    /** @brief Create the hash cache
+     *
+     * @param[in] capacity - number of files whose hashes are kept
+     */
+    explicit BlockHashes(size_t capacity) : capacity(capacity)
+    {
+    }
+
+    BlockHashes() = delete;
+    ~BlockHashes() = default;
+    BlockHashes(const BlockHashes&) = delete;
+    BlockHashes& operator=(const BlockHashes&) = delete;
+
+    /** @brief Make the hash of a block from its CRC-32 */
+    static constexpr Hash hash(uint32_t crc)
+    {
+        return (Hash(1) << 32) | crc;
+    }
+
+    /** @brief Get the hashes of a range of blocks of a file
+     *
+     * @param[in] path - pathname of the file
+     * @param[in] st - status of the file
+     * @param[in] first - index of the first block
+     * @param[in] count - number of blocks
+     *
+     * @return count hashes, 0 for blocks whose hash is unknown
+     */
+    std::vector<Hash> get(const fs::path& path, const struct stat& st,
+                          size_t first, size_t count);
+
+    /** @brief Set the hashes of a range of blocks of a file after it was
+     *         written
+     *
+     * @param[in] path - pathname of the file
+     * @param[in] st - status of the file after the write
+     * @param[in] first - index of the first block
+     * @param[in] hashes - hashes of the blocks
+     */
+    void set(const fs::path& path, const struct stat& st, size_t first,
+             const std::vector<Hash>& hashes);
+
+    /** @brief Drop all the hashes
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+    }
+
+  private:
+    /** @struct Entry
+     *
+     *  Hashes of the blocks of a file and the state of the file they were
+     *  taken from
+     */
+    struct Entry
+    {
+        std::vector<Hash> hashes; //!< Hash of each block
+        ino_t inode = 0;          //!< Inode number
+        off_t size = 0;           //!< Size in bytes
+        uint64_t mtime = 0;       //!< Modification time in ns
+        uint64_t lastUse = 0;     //!< Access counter value at last use
+    };
+
+    /** @brief Get the entry of a file, creating it if needed, with the lock
+     *         held. The least recently used entry is evicted to make room.
+     */
+    Entry& find(const fs::path& path);
+
+    /** @brief Get the entry of a file, with the lock held. The hashes are
+     *         dropped if the file changed since they were taken.
+     */
+    Entry& lookup(const fs::path& path, const struct stat& st);
+
+    /** @brief number of files whose hashes are kept */
+    size_t capacity;
+
+    /** @brief incremented on every access, to find the least recently used
+     *         entry */
+    uint64_t accessCount = 0;
+
+    /** @brief file pathname to the hashes of the file */
+    std::unordered_map<std::string, Entry> entries;
+
+    std::mutex mutex;
+};
+
+/** @brief Get the block hashes of the responder
+ *
+ *  @return BlockHashes& - Reference to instance of block hashes
+ */
+BlockHashes& blockHashes();
+
+/** @brief Write a range of a file, skipping the blocks whose contents are
+ *         unchanged
+ *
+ *  The whole blocks in the range are compared against the file, the ones
+ *  that differ are written in runs of adjacent blocks. A block whose hash
+ *  differs from the one of the data is written without reading it, the
+ *  others are read and compared. Partial blocks at the ends of the range are
+ *  always written.
+ *
+ *  @param[in] fd - the file, open for reading and writing
+ *  @param[in] path - pathname of the file
+ *  @param[in] offset - offset in the file
+ *  @param[in] length - number of bytes to write
+ *  @param[in] data - data to write
+ *
+ *  @return number of bytes that did not need to be written, or negative
+ *          errno on failure
+ */
+ssize_t writeChanged(int fd, const fs::path& path, uint64_t offset,
+                     uint32_t length, const char* data);
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,114 @@
+#include "capture.hpp"
+
+#include <endian.h>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace
+{
+
+// Larger messages are taken as a corrupt file
+constexpr uint32_t maxMessageLength = 1024 * 1024;
+
+} // namespace
+
+bool CaptureWriter::open(const fs::path& path)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    stream = std::ofstream(path, std::ios::out | std::ios::trunc |
+                                     std::ios::binary);
+    if (!stream)
+    {
+        return false;
+    }
+
+    uint32_t version = htole32(captureVersion);
+    stream.write(captureMagic.data(), captureMagic.size());
+    stream.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    start = std::chrono::steady_clock::now();
+    active.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void CaptureWriter::close()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    active.store(false, std::memory_order_relaxed);
+    if (stream.is_open())
+    {
+        stream.close();
+    }
+}
+
+void CaptureWriter::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stream.is_open())
+    {
+        stream.flush();
+    }
+}
+
+void CaptureWriter::write(uint8_t eid, const uint8_t* message, size_t length)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!stream.is_open())
+    {
+        return;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start);
+    uint64_t time = htole64(elapsed.count());
+    uint32_t messageLength = htole32(length);
+
+    stream.write(reinterpret_cast<const char*>(&time), sizeof(time));
+    stream.write(reinterpret_cast<const char*>(&eid), sizeof(eid));
+    stream.write(reinterpret_cast<const char*>(&messageLength),
+                 sizeof(messageLength));
+    stream.write(reinterpret_cast<const char*>(message), length);
+}
+
+bool CaptureReader::open(const fs::path& path)
+{
+    stream = std::ifstream(path, std::ios::in | std::ios::binary);
+
+    std::array<char, captureMagic.size()> magic{};
+    uint32_t version = 0;
+    stream.read(magic.data(), magic.size());
+    stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+    return stream && magic == captureMagic &&
+           le32toh(version) == captureVersion;
+}
+
+bool CaptureReader::next(CaptureRecord& record)
+{
+    uint64_t time = 0;
+    uint32_t length = 0;
+    stream.read(reinterpret_cast<char*>(&time), sizeof(time));
+    stream.read(reinterpret_cast<char*>(&record.eid), sizeof(record.eid));
+    stream.read(reinterpret_cast<char*>(&length), sizeof(length));
+    length = le32toh(length);
+    if (!stream || length > maxMessageLength)
+    {
+        return false;
+    }
+
+    record.time = le64toh(time);
+    record.message.resize(length);
+    stream.read(reinterpret_cast<char*>(record.message.data()), length);
+    return static_cast<bool>(stream);
+}
+
+CaptureWriter& captureWriter()
+{
+    static CaptureWriter writer;
+    return writer;
+}
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace fs = std::filesystem;
+
+/** @brief Magic number at the start of a capture file, followed by the
+ *         version of the format
+ */
+constexpr std::array<char, 8> captureMagic = {'P', 'L', 'D', 'M',
+                                              'C', 'A', 'P', '\0'};
+constexpr uint32_t captureVersion = 1;
+
+/** @struct CaptureRecord
+ *
+ *  A request message as received by the responder. In the file each record
+ *  is the time (8 bytes), the endpoint id (1 byte) and the length of the
+ *  message (4 bytes), followed by the message. Numbers are little endian.
+ */
+struct CaptureRecord
+{
+    uint64_t time = 0;            //!< Time since the capture started, in ns
+    uint8_t eid = 0;              //!< MCTP endpoint id of the requester
+    std::vector<uint8_t> message; //!< PLDM message, including the header
+};
+
+/** @class CaptureWriter
+ *
+ *  Records the request messages the responder receives to a file, so that the
+ *  load can be replayed later. Recording is off until a file is opened, and
+ *  then costs a lock and a buffered write per request.
+ */
+class CaptureWriter
+{
+  public:
+    CaptureWriter() = default;
+    ~CaptureWriter() = default;
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    /** @brief Start recording to a file, replacing its contents
+     *
+     * @param[in] path - pathname of the capture file
+     *
+     * @return bool - true if the file was opened
+     */
+    bool open(const fs::path& path);
+
+    /** @brief Stop recording and flush the file
+     */
+    void close();
+
+    /** @brief Flush the recorded messages to the file
+     */
+    void flush();
+
+    /** @brief Check if messages are being recorded */
+    bool isOpen() const
+    {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Record a request message, if recording
+     *
+     * @param[in] eid - MCTP endpoint id of the requester
+     * @param[in] message - PLDM message, including the header
+     * @param[in] length - length of the message
+     */
+    void record(uint8_t eid, const uint8_t* message, size_t length)
+    {
+        if (isOpen())
+        {
+            write(eid, message, length);
+        }
+    }
+
+  private:
+    void write(uint8_t eid, const uint8_t* message, size_t length);
+
+    std::atomic<bool> active{false};
+    std::chrono::steady_clock::time_point start;
+    std::ofstream stream;
+    std::mutex mutex;
+};
+
+/** @class CaptureReader
+ *
+ *  Reads the records of a capture file in order
+ */
+class CaptureReader
+{
+  public:
+    /** @brief Open a capture file
+     *
+     * @param[in] path - pathname of the capture file
+     *
+     * @return bool - true if the file is a capture file of a known version
+     */
+    bool open(const fs::path& path);
+
+    /** @brief Read the next record
+     *
+     * @param[out] record - the record
+     *
+     * @return bool - true if a record was read, false at the end of the file
+     *                or on a truncated record
+     */
+    bool next(CaptureRecord& record);
+
+  private:
+    std::ifstream stream;
+};
+
+/** @brief Get the capture writer of the responder
+ *
+ *  @return CaptureWriter& - Reference to instance of capture writer
+ */
+CaptureWriter& captureWriter();
+
+} // namespace responder
+} // namespace pldm
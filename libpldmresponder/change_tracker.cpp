@@ -0,0 +1,409 @@
+#include "change_tracker.hpp"
+
+#include "crc32.hpp"
+#include "executor.hpp"
+#include "file_io.hpp"
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+
+namespace pldm
+{
+
+namespace filetable
+{
+
+using namespace pldm::responder;
+
+namespace
+{
+
+// Events that mean the contents of a watched file may have changed
+constexpr uint32_t modifyEvents = IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB;
+
+// Events that mean the watched file is gone
+constexpr uint32_t goneEvents = IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED;
+
+uint64_t modificationTime(const struct stat& st)
+{
+    return static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000 +
+           st.st_mtim.tv_nsec;
+}
+
+size_t blockCount(uint32_t size)
+{
+    return (size + changeBlockSize - 1) / changeBlockSize;
+}
+
+} // namespace
+
+ChangeTracker::ChangeTracker() :
+    lastGeneration(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+                   .count())
+{
+}
+
+ChangeTracker::~ChangeTracker()
+{
+    if (inotifyFd >= 0)
+    {
+        close(inotifyFd);
+    }
+}
+
+int ChangeTracker::read(const fs::path& path, size_t first, size_t count,
+                        Scan& scan)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+    utils::CustomFD file(fd);
+
+    // Take the state before reading, so that a change made while the file
+    // is read shows up as a newer modification time
+    struct stat st
+    {
+    };
+    if (fstat(file(), &st) < 0)
+    {
+        return -errno;
+    }
+    scan.inode = st.st_ino;
+    scan.size = static_cast<uint32_t>(st.st_size);
+    scan.mtime = modificationTime(st);
+
+    auto blocks = blockCount(scan.size);
+    count = std::min(count, blocks - std::min(first, blocks));
+    scan.crcs.resize(count);
+    std::vector<char> buffer(changeBlockSize);
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto rc = pread(file(), buffer.data(), changeBlockSize,
+                        (first + i) * changeBlockSize);
+        if (rc < 0)
+        {
+            return -errno;
+        }
+        scan.crcs[i] = crc32::compute(buffer.data(), rc);
+    }
+    return 0;
+}
+
+int ChangeTracker::refresh(Handle handle, const fs::path& path)
+{
+    struct stat st
+    {
+    };
+    if (stat(path.c_str(), &st) < 0)
+    {
+        return -errno;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto iter = entries.find(handle);
+        if (iter != entries.end() && iter->second.path == path &&
+            iter->second.scan.inode == st.st_ino &&
+            iter->second.scan.size == static_cast<uint32_t>(st.st_size) &&
+            iter->second.scan.mtime == modificationTime(st))
+        {
+            return 0;
+        }
+    }
+
+    Scan scan{};
+    auto rc = read(path, 0, SIZE_MAX, scan);
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = entries.find(handle);
+    if (iter != entries.end() &&
+        (iter->second.path != path || iter->second.scan.inode != scan.inode))
+    {
+        erase(handle);
+        iter = entries.end();
+    }
+
+    if (iter == entries.end())
+    {
+        auto& entry = entries[handle];
+        entry.path = path;
+        entry.base = ++lastGeneration;
+        entry.generations.assign(scan.crcs.size(), entry.base);
+        entry.scan = std::move(scan);
+        if (inotifyFd >= 0)
+        {
+            entry.watch = inotify_add_watch(inotifyFd, path.c_str(),
+                                            modifyEvents | goneEvents);
+            if (entry.watch >= 0)
+            {
+                watches[entry.watch] = handle;
+            }
+        }
+        return 0;
+    }
+
+    // Blocks whose CRC changed, and blocks past the old end of the file,
+    // changed in a new generation
+    auto& entry = iter->second;
+    uint64_t changed = 0;
+    entry.generations.resize(scan.crcs.size());
+    for (size_t i = 0; i < scan.crcs.size(); ++i)
+    {
+        if (i >= entry.scan.crcs.size() || entry.scan.crcs[i] != scan.crcs[i])
+        {
+            if (!changed)
+            {
+                changed = ++lastGeneration;
+            }
+            entry.generations[i] = changed;
+        }
+    }
+    entry.scan = std::move(scan);
+    return 0;
+}
+
+void ChangeTracker::recordWrite(Handle handle, const fs::path& path,
+                                uint32_t offset, uint32_t length)
+{
+    if (!length)
+    {
+        return;
+    }
+    {
+        // Files that are not tracked yet count as changed as a whole
+        std::lock_guard<std::mutex> lock(mutex);
+        auto iter = entries.find(handle);
+        if (iter == entries.end() || iter->second.path != path)
+        {
+            return;
+        }
+    }
+
+    size_t first = offset / changeBlockSize;
+    size_t count = blockCount(offset + length) - first;
+    Scan scan{};
+    if (read(path, first, count, scan) < 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = entries.find(handle);
+    if (iter == entries.end() || iter->second.scan.inode != scan.inode)
+    {
+        return;
+    }
+
+    auto& entry = iter->second;
+    auto written = ++lastGeneration;
+    auto blocks = blockCount(scan.size);
+    entry.generations.resize(blocks, written);
+    entry.scan.crcs.resize(blocks);
+    for (size_t i = 0; i < scan.crcs.size(); ++i)
+    {
+        entry.generations[first + i] = written;
+        entry.scan.crcs[first + i] = scan.crcs[i];
+    }
+    entry.scan.size = scan.size;
+    entry.scan.mtime = scan.mtime;
+}
+
+int ChangeTracker::changes(Handle handle, const fs::path& path,
+                           uint64_t since, uint32_t offset, size_t maxRanges,
+                           Changes& changes)
+{
+    auto rc = refresh(handle, path);
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = entries.find(handle);
+    if (iter == entries.end())
+    {
+        return -ENOENT;
+    }
+
+    // Generations from before the file was tracked cover the whole file, as
+    // do generations not handed out yet, which come from an earlier run
+    // whose clock was ahead of this one
+    const auto& entry = iter->second;
+    bool all = since < entry.base || since > lastGeneration;
+
+    // The pages after the first of a scan must not return a generation newer
+    // than the first one did, or the blocks that changed in between on the
+    // pages already read would be missed
+    if (offset == 0)
+    {
+        changes.generation = lastGeneration;
+    }
+    else
+    {
+        changes.generation = since > lastGeneration ? 0 : since;
+    }
+    changes.fileSize = entry.scan.size;
+    changes.nextOffset = entry.scan.size;
+    changes.ranges.clear();
+    for (size_t i = offset / changeBlockSize; i < entry.generations.size();
+         ++i)
+    {
+        if (!all && entry.generations[i] <= since)
+        {
+            continue;
+        }
+
+        uint32_t start = i * changeBlockSize;
+        uint32_t end = std::min<uint32_t>(start + changeBlockSize,
+                                          entry.scan.size);
+        if (!changes.ranges.empty() &&
+            changes.ranges.back().offset + changes.ranges.back().length ==
+                start)
+        {
+            changes.ranges.back().length += end - start;
+            continue;
+        }
+        if (changes.ranges.size() == maxRanges)
+        {
+            changes.nextOffset = start;
+            break;
+        }
+        changes.ranges.push_back({start, end - start});
+    }
+    return 0;
+}
+
+uint64_t ChangeTracker::generation()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastGeneration;
+}
+
+int ChangeTracker::watch(EventLoop& loop)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (inotifyFd >= 0)
+    {
+        return -EALREADY;
+    }
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+    auto rc = loop.addIO(fd, EPOLLIN, [this](uint32_t) { handleEvents(); });
+    if (rc < 0)
+    {
+        close(fd);
+        return rc;
+    }
+    inotifyFd = fd;
+
+    for (auto& [handle, entry] : entries)
+    {
+        entry.watch = inotify_add_watch(inotifyFd, entry.path.c_str(),
+                                        modifyEvents | goneEvents);
+        if (entry.watch >= 0)
+        {
+            watches[entry.watch] = handle;
+        }
+    }
+    return 0;
+}
+
+void ChangeTracker::handleEvents()
+{
+    alignas(inotify_event) char buffer[4096];
+    std::vector<std::pair<Handle, fs::path>> modified;
+    for (;;)
+    {
+        auto count = ::read(inotifyFd, buffer, sizeof(buffer));
+        if (count <= 0)
+        {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (char* p = buffer; p < buffer + count;)
+        {
+            auto event = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + event->len;
+
+            auto watch = watches.find(event->wd);
+            if (watch == watches.end())
+            {
+                continue;
+            }
+            auto handle = watch->second;
+            if (event->mask & goneEvents)
+            {
+                // Tracked again from scratch if the file comes back
+                erase(handle);
+                continue;
+            }
+
+            const auto& path = entries.at(handle).path;
+            if (std::find(modified.begin(), modified.end(),
+                          std::make_pair(handle, path)) == modified.end())
+            {
+                modified.emplace_back(handle, path);
+            }
+        }
+    }
+
+    // Compare the blocks once per file, however many events it had. The
+    // file is read on a worker, after the file commands queued for it.
+    for (const auto& [handle, path] : modified)
+    {
+        executor().post(handle, [this, handle = handle, path = path]() {
+            refresh(handle, path);
+        });
+    }
+}
+
+void ChangeTracker::erase(Handle handle)
+{
+    auto iter = entries.find(handle);
+    if (iter == entries.end())
+    {
+        return;
+    }
+    if (iter->second.watch >= 0)
+    {
+        watches.erase(iter->second.watch);
+        inotify_rm_watch(inotifyFd, iter->second.watch);
+    }
+    entries.erase(iter);
+}
+
+void ChangeTracker::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    while (!entries.empty())
+    {
+        erase(entries.begin()->first);
+    }
+}
+
+ChangeTracker& changeTracker()
+{
+    static ChangeTracker tracker;
+    return tracker;
+}
+
+} // namespace filetable
+} // namespace pldm
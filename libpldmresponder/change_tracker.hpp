@@ -0,0 +1,197 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "event_loop.hpp"
+#include "file_table.hpp"
+
+namespace pldm
+{
+
+namespace filetable
+{
+
+/** @brief Size of the blocks changes are tracked in */
+constexpr uint32_t changeBlockSize = 4096;
+
+/** @struct ChangedRange
+ *
+ *  A range of a file that changed
+ */
+struct ChangedRange
+{
+    uint32_t offset = 0; //!< Offset of the first byte
+    uint32_t length = 0; //!< Number of bytes
+};
+
+/** @struct Changes
+ *
+ *  The ranges of a file that changed since a generation
+ */
+struct Changes
+{
+    uint64_t generation = 0;          //!< Generation to pass next time
+    uint32_t fileSize = 0;            //!< Current size of the file
+    uint32_t nextOffset = 0;          //!< Where the next ranges start, the
+                                      //!< file size if there are none
+    std::vector<ChangedRange> ranges; //!< Changed ranges, in file order
+};
+
+/** @class ChangeTracker
+ *
+ *  ChangeTracker records the generation in which each block of a file last
+ *  changed, so that the host can re-read only the blocks that changed since
+ *  it last read a file. Generations are taken from one counter for all the
+ *  files, seeded with the time the responder started in ns, so that a
+ *  generation handed out before a restart is older than anything tracked
+ *  after it. A file is tracked from the first time it is asked about, the
+ *  whole file counts as changed for older generations and for generations
+ *  newer than the last one handed out, which a restart after the clock was
+ *  set back leaves behind.
+ *
+ *  Writes by the responder mark the blocks they wrote. Changes made by local
+ *  writers are found by comparing the CRC-32 of every block with the one
+ *  recorded, on an executor worker when inotify reports that the file was
+ *  modified or, without inotify, when the file is asked about and its
+ *  inode, size or modification time changed.
+ */
+class ChangeTracker
+{
+  public:
+    ChangeTracker();
+    ~ChangeTracker();
+    ChangeTracker(const ChangeTracker&) = delete;
+    ChangeTracker& operator=(const ChangeTracker&) = delete;
+
+    /** @brief Record a write by the responder to a range of a file
+     *
+     * @param[in] handle - file handle
+     * @param[in] path - pathname of the file
+     * @param[in] offset - offset in the file
+     * @param[in] length - number of bytes written
+     */
+    void recordWrite(Handle handle, const fs::path& path, uint32_t offset,
+                     uint32_t length);
+
+    /** @brief Get the ranges of a file that changed since a generation
+     *
+     * @param[in] handle - file handle
+     * @param[in] path - pathname of the file
+     * @param[in] since - generation returned by an earlier call, 0 for the
+     *                    whole file, unknown generations get the whole file
+     * @param[in] offset - offset in the file to start looking at, 0 to
+     *                     start a scan. Only the first page of a scan
+     *                     returns the current generation, later ones return
+     *                     since, so that changes made between the pages are
+     *                     returned again whichever generation is kept.
+     * @param[in] maxRanges - largest number of ranges to return
+     * @param[out] changes - the changed ranges
+     *
+     * @return 0 on success, negative errno on failure
+     */
+    int changes(Handle handle, const fs::path& path, uint64_t since,
+                uint32_t offset, size_t maxRanges, Changes& changes);
+
+    /** @brief Get the last generation handed out */
+    uint64_t generation();
+
+    /** @brief Watch the tracked files with inotify from an event loop, so
+     *         that changes by local writers are picked up as they happen
+     *
+     * @param[in] loop - event loop to read the inotify events on
+     *
+     * @return 0 on success, negative errno on failure
+     */
+    int watch(responder::EventLoop& loop);
+
+    /** @brief Stop tracking all the files
+     */
+    void clear();
+
+  private:
+    /** @struct Scan
+     *
+     *  State of a file and the CRC-32 of each of its blocks
+     */
+    struct Scan
+    {
+        ino_t inode = 0;            //!< Inode number
+        uint32_t size = 0;          //!< Size in bytes
+        uint64_t mtime = 0;         //!< Modification time in ns
+        std::vector<uint32_t> crcs; //!< CRC-32 of each block
+    };
+
+    /** @struct Entry
+     *
+     *  A tracked file
+     */
+    struct Entry
+    {
+        fs::path path;                     //!< Pathname of the file
+        uint64_t base = 0;                 //!< Generation tracking started
+        Scan scan;                         //!< State of the file
+        std::vector<uint64_t> generations; //!< Generation of each block
+        int watch = -1;                    //!< inotify watch descriptor
+    };
+
+    /** @brief Read a file and hash its blocks, without the lock held
+     *
+     * @param[in] path - pathname of the file
+     * @param[in] first - first block to hash
+     * @param[in] count - number of blocks to hash, at most up to the end of
+     *                    the file
+     * @param[out] scan - the state of the file and the CRCs of the blocks
+     *
+     * @return 0 on success, negative errno on failure
+     */
+    static int read(const fs::path& path, size_t first, size_t count,
+                    Scan& scan);
+
+    /** @brief Bring the entry of a file up to date, starting to track it if
+     *         needed
+     *
+     * @param[in] handle - file handle
+     * @param[in] path - pathname of the file
+     *
+     * @return 0 on success, negative errno on failure
+     */
+    int refresh(Handle handle, const fs::path& path);
+
+    /** @brief Stop tracking a file, with the lock held */
+    void erase(Handle handle);
+
+    /** @brief Read the pending inotify events, and queue the files they
+     *         report as modified to be compared on the executor
+     */
+    void handleEvents();
+
+    /** @brief last generation handed out */
+    uint64_t lastGeneration;
+
+    /** @brief file handle to tracked file */
+    std::unordered_map<Handle, Entry> entries;
+
+    /** @brief inotify watch descriptor to file handle */
+    std::unordered_map<int, Handle> watches;
+
+    /** @brief inotify instance, -1 when not watching */
+    int inotifyFd = -1;
+
+    std::mutex mutex;
+};
+
+/** @brief Get the change tracker of the responder
+ *
+ *  @return ChangeTracker& - Reference to instance of change tracker
+ */
+ChangeTracker& changeTracker();
+
+} // namespace filetable
+} // namespace pldm
@@ -0,0 +1,329 @@
+#include "crc32.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace pldm
+{
+
+namespace crc32
+{
+
+namespace
+{
+
+// Reflected form of the CRC-32 polynomial 0x04C11DB7
+constexpr uint32_t poly = 0xEDB88320;
+
+using SliceTable = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr SliceTable makeSliceTable()
+{
+    SliceTable table{};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+        table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        for (size_t slice = 1; slice < table.size(); ++slice)
+        {
+            auto prev = table[slice - 1][i];
+            table[slice][i] = (prev >> 8) ^ table[0][prev & 0xFF];
+        }
+    }
+    return table;
+}
+
+constexpr SliceTable sliceTable = makeSliceTable();
+
+/** @brief Multiply two polynomials modulo the CRC polynomial, both in the
+ *         reflected bit order used by the CRC state.
+ */
+constexpr uint32_t multModP(uint32_t a, uint32_t b)
+{
+    uint32_t m = uint32_t(1) << 31;
+    uint32_t p = 0;
+    while (m)
+    {
+        if (a & m)
+        {
+            p ^= b;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ poly : b >> 1;
+    }
+    return p;
+}
+
+using PowerTable = std::array<uint32_t, 32>;
+
+// x^(2^n) modulo the CRC polynomial for n in [0, 32)
+constexpr PowerTable makePowerTable()
+{
+    PowerTable table{};
+    // x^1
+    table[0] = uint32_t(1) << 30;
+    for (size_t n = 1; n < table.size(); ++n)
+    {
+        table[n] = multModP(table[n - 1], table[n - 1]);
+    }
+    return table;
+}
+
+constexpr PowerTable powerTable = makePowerTable();
+
+/** @brief x^(8 * length) modulo the CRC polynomial, the operator that appends
+ *         length zero bytes to a raw CRC state.
+ */
+uint32_t zerosOperator(size_t length)
+{
+    // x^0
+    uint32_t p = uint32_t(1) << 31;
+    // Start at x^(2^3), one byte is 8 bits
+    size_t k = 3;
+    while (length)
+    {
+        if (length & 1)
+        {
+            p = multModP(powerTable[k % powerTable.size()], p);
+        }
+        length >>= 1;
+        ++k;
+    }
+    return p;
+}
+
+uint32_t sliceBy8(uint32_t state, const uint8_t* data, size_t length)
+{
+    const auto& t = sliceTable;
+
+    while (length && (reinterpret_cast<uintptr_t>(data) & 7))
+    {
+        state = t[0][(state ^ *data++) & 0xFF] ^ (state >> 8);
+        --length;
+    }
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (length >= 8)
+    {
+        uint32_t lo = 0;
+        uint32_t hi = 0;
+        memcpy(&lo, data, sizeof(lo));
+        memcpy(&hi, data + sizeof(lo), sizeof(hi));
+        lo ^= state;
+        state = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+                t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^ t[3][hi & 0xFF] ^
+                t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^
+                t[0][hi >> 24];
+        data += 8;
+        length -= 8;
+    }
+#endif
+
+    while (length--)
+    {
+        state = t[0][(state ^ *data++) & 0xFF] ^ (state >> 8);
+    }
+    return state;
+}
+
+#if defined(__ARM_FEATURE_CRC32)
+
+uint32_t armv8(uint32_t state, const uint8_t* data, size_t length)
+{
+    while (length && (reinterpret_cast<uintptr_t>(data) & 7))
+    {
+        state = __crc32b(state, *data++);
+        --length;
+    }
+    while (length >= 8)
+    {
+        uint64_t value = 0;
+        memcpy(&value, data, sizeof(value));
+        state = __crc32d(state, value);
+        data += 8;
+        length -= 8;
+    }
+    while (length--)
+    {
+        state = __crc32b(state, *data++);
+    }
+    return state;
+}
+
+uint32_t update(uint32_t state, const uint8_t* data, size_t length)
+{
+    return armv8(state, data, length);
+}
+
+#elif defined(__x86_64__) || defined(__i386__)
+
+// The SSE4.2 CRC32 instruction implements CRC-32C (Castagnoli), which is not
+// the polynomial of the file attribute table checksum, so only the carry-less
+// multiply folding is usable on x86.
+constexpr size_t foldMinLength = 64;
+
+/** @brief Fold a multiple of 16 bytes, at least 64, with PCLMULQDQ
+ *
+ *  Based on "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+ *  Instruction" (Intel, 2009), using the bit-reflected constants for the
+ *  CRC-32 polynomial.
+ */
+__attribute__((target("pclmul,sse4.1"))) uint32_t
+    pclmul(uint32_t state, const uint8_t* data, size_t length)
+{
+    alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const uint64_t barrett[] = {0x01db710641,
+                                                   0x01f7011641};
+
+    auto load = [](const uint8_t* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = load(data + 0x00);
+    x2 = load(data + 0x10);
+    x3 = load(data + 0x20);
+    x4 = load(data + 0x30);
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(state));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    data += 64;
+    length -= 64;
+
+    // Fold 64 bytes at a time into four accumulators
+    while (length >= 64)
+    {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), load(data + 0x00));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), load(data + 0x10));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), load(data + 0x20));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), load(data + 0x30));
+
+        data += 64;
+        length -= 64;
+    }
+
+    // Fold the four accumulators into one
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    for (auto next : {x2, x3, x4})
+    {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, next), x5);
+    }
+
+    // Fold the remaining 16 byte blocks
+    while (length >= 16)
+    {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, load(data)), x5);
+        data += 16;
+        length -= 16;
+    }
+
+    // Fold 128 bits to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(barrett));
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return _mm_extract_epi32(x1, 1);
+}
+
+uint32_t update(uint32_t state, const uint8_t* data, size_t length)
+{
+    static const bool hasPclmul =
+        __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+
+    if (hasPclmul && length >= foldMinLength)
+    {
+        size_t folded = length & ~size_t(15);
+        state = pclmul(state, data, folded);
+        data += folded;
+        length -= folded;
+    }
+    return sliceBy8(state, data, length);
+}
+
+#else
+
+uint32_t update(uint32_t state, const uint8_t* data, size_t length)
+{
+    return sliceBy8(state, data, length);
+}
+
+#endif
+
+} // namespace
+
+uint32_t compute(const void* data, size_t length, uint32_t crc)
+{
+    return ~update(~crc, static_cast<const uint8_t*>(data), length);
+}
+
+uint32_t combine(uint32_t crc1, uint32_t crc2, size_t length2)
+{
+    return multModP(zerosOperator(length2), crc1) ^ crc2;
+}
+
+uint32_t patch(uint32_t crc, size_t length, size_t offset, const void* oldData,
+               const void* newData, size_t patchLength)
+{
+    auto oldBytes = static_cast<const uint8_t*>(oldData);
+    auto newBytes = static_cast<const uint8_t*>(newData);
+
+    // The CRC of the XOR of two equal length messages is the XOR of their
+    // CRCs and the raw CRC (no pre or post inversion) of the difference. The
+    // leading zero bytes of the difference do not change a raw CRC, so only
+    // the changed range and the trailing zero bytes need to be accounted for.
+    uint32_t delta = 0;
+    for (size_t i = 0; i < patchLength; ++i)
+    {
+        delta = sliceTable[0][(delta ^ oldBytes[i] ^ newBytes[i]) & 0xFF] ^
+                (delta >> 8);
+    }
+
+    return crc ^ multModP(zerosOperator(length - offset - patchLength), delta);
+}
+
+} // namespace crc32
+} // namespace pldm
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pldm
+{
+
+namespace crc32
+{
+
+/** @brief Compute the CRC-32 (IEEE 802.3) of a buffer
+ *
+ *  The result is identical to boost::crc_32_type and zlib's crc32(). The
+ *  implementation uses the ARMv8 CRC32 instructions when the target supports
+ *  them, carry-less multiplication on x86 CPUs with PCLMULQDQ, and falls back
+ *  to slicing-by-8 otherwise.
+ *
+ *  @param[in] data - pointer to the data
+ *  @param[in] length - number of bytes in data
+ *  @param[in] crc - CRC of the preceding data, to continue a running CRC
+ *
+ *  @return CRC-32 of the preceding data followed by data
+ */
+uint32_t compute(const void* data, size_t length, uint32_t crc = 0);
+
+/** @brief Combine the CRCs of two adjacent blocks of data
+ *
+ *  @param[in] crc1 - CRC-32 of the first block
+ *  @param[in] crc2 - CRC-32 of the second block
+ *  @param[in] length2 - length of the second block in bytes
+ *
+ *  @return CRC-32 of the first block followed by the second block
+ */
+uint32_t combine(uint32_t crc1, uint32_t crc2, size_t length2);
+
+/** @brief Update the CRC of a buffer after a range of it was overwritten
+ *
+ *  CRC-32 is linear, so the new CRC can be derived from the old CRC and the
+ *  bytes that changed, without rehashing the rest of the buffer.
+ *
+ *  @param[in] crc - CRC-32 of the buffer before the change
+ *  @param[in] length - total length of the buffer in bytes
+ *  @param[in] offset - offset of the changed range in the buffer
+ *  @param[in] oldData - contents of the range before the change
+ *  @param[in] newData - contents of the range after the change
+ *  @param[in] patchLength - length of the changed range in bytes
+ *
+ *  @return CRC-32 of the buffer after the change
+ */
+uint32_t patch(uint32_t crc, size_t length, size_t offset, const void* oldData,
+               const void* newData, size_t patchLength);
+
+} // namespace crc32
+} // namespace pldm
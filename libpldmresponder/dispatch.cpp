@@ -0,0 +1,551 @@
+#include "dispatch.hpp"
+
+#include "capture.hpp"
+#include "metrics.hpp"
+#include "replay_cache.hpp"
+
+#include <endian.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+#include "libpldm/file_io.h"
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace dispatch
+{
+
+namespace
+{
+
+int getPLDMTypes(const uint8_t* request, size_t payloadLength,
+                 uint8_t* response, size_t& responseLength);
+
+int getPLDMCommands(const uint8_t* request, size_t payloadLength,
+                    uint8_t* response, size_t& responseLength);
+
+using HandlerTable =
+    std::array<std::array<EncodeHandler, PLDM_MAX_CMDS_PER_TYPE>,
+               PLDM_MAX_TYPES>;
+
+constexpr HandlerTable makeHandlerTable()
+{
+    HandlerTable table{};
+
+    table[PLDM_BASE][PLDM_GET_PLDM_TYPES] = getPLDMTypes;
+    table[PLDM_BASE][PLDM_GET_PLDM_COMMANDS] = getPLDMCommands;
+
+    table[PLDM_IBM_OEM_TYPE][PLDM_GET_FILE_TABLE] = getFileTable;
+    table[PLDM_IBM_OEM_TYPE][PLDM_READ_FILE] = readFile;
+    table[PLDM_IBM_OEM_TYPE][PLDM_WRITE_FILE] = writeFile;
+    table[PLDM_IBM_OEM_TYPE][PLDM_READ_FILE_INTO_MEMORY] = readFileIntoMemory;
+    table[PLDM_IBM_OEM_TYPE][PLDM_WRITE_FILE_FROM_MEMORY] =
+        writeFileFromMemory;
+    table[PLDM_IBM_OEM_TYPE][PLDM_GET_CHANGED_BLOCKS] = getChangedBlocks;
+    table[PLDM_IBM_OEM_TYPE][PLDM_GET_FILE_CHECKSUM] = getFileChecksum;
+    table[PLDM_IBM_OEM_TYPE][PLDM_FOLLOW_FILE] = followFile;
+
+    return table;
+}
+
+constexpr HandlerTable handlers = makeHandlerTable();
+
+using TypeBits = std::array<uint8_t, PLDM_MAX_TYPES / 8>;
+using CommandBits = std::array<uint8_t, PLDM_MAX_CMDS_PER_TYPE / 8>;
+
+constexpr CommandBits makeCommandBits(uint8_t type)
+{
+    CommandBits bits{};
+    for (size_t command = 0; command < PLDM_MAX_CMDS_PER_TYPE; ++command)
+    {
+        if (handlers[type][command])
+        {
+            bits[command / 8] |= 1 << (command % 8);
+        }
+    }
+    return bits;
+}
+
+constexpr std::array<CommandBits, PLDM_MAX_TYPES> makeAllCommandBits()
+{
+    std::array<CommandBits, PLDM_MAX_TYPES> all{};
+    for (size_t type = 0; type < PLDM_MAX_TYPES; ++type)
+    {
+        all[type] = makeCommandBits(type);
+    }
+    return all;
+}
+
+// The GetPLDMCommands response of every type
+constexpr std::array<CommandBits, PLDM_MAX_TYPES> commandBits =
+    makeAllCommandBits();
+
+constexpr TypeBits makeTypeBits()
+{
+    TypeBits bits{};
+    for (size_t type = 0; type < PLDM_MAX_TYPES; ++type)
+    {
+        for (auto byte : commandBits[type])
+        {
+            if (byte)
+            {
+                bits[type / 8] |= 1 << (type % 8);
+                break;
+            }
+        }
+    }
+    return bits;
+}
+
+// The GetPLDMTypes response
+constexpr TypeBits typeBits = makeTypeBits();
+
+constexpr bool isTypeSupported(uint8_t type)
+{
+    return typeBits[type / 8] & (1 << (type % 8));
+}
+
+std::array<std::atomic<uint64_t>, PLDM_MAX_TYPES * PLDM_MAX_CMDS_PER_TYPE>
+    requestCounts{};
+
+int getPLDMTypes(const uint8_t* /*request*/, size_t /*payloadLength*/,
+                 uint8_t* response, size_t& responseLength)
+{
+    constexpr size_t encodedLength =
+        sizeof(pldm_msg_hdr) + PLDM_GET_TYPES_RESP_BYTES;
+    if (responseLength < encodedLength)
+    {
+        responseLength = encodedLength;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+    responseLength = encodedLength;
+    memset(response, 0, responseLength);
+
+    encode_get_types_resp(0, PLDM_SUCCESS,
+                          reinterpret_cast<const bitfield8_t*>(typeBits.data()),
+                          reinterpret_cast<pldm_msg*>(response));
+    return PLDM_SUCCESS;
+}
+
+int getPLDMCommands(const uint8_t* request, size_t payloadLength,
+                    uint8_t* response, size_t& responseLength)
+{
+    uint8_t type = 0;
+    ver32_t version{};
+
+    constexpr size_t encodedLength =
+        sizeof(pldm_msg_hdr) + PLDM_GET_COMMANDS_RESP_BYTES;
+    if (responseLength < encodedLength)
+    {
+        responseLength = encodedLength;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+    responseLength = encodedLength;
+    memset(response, 0, responseLength);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response);
+
+    auto rc = decode_get_commands_req(request, payloadLength, &type, &version);
+    if (rc)
+    {
+        encode_get_commands_resp(0, rc, nullptr, responsePtr);
+        return PLDM_SUCCESS;
+    }
+
+    // Only one version of each type is supported, so the version is not
+    // checked
+    if (type >= PLDM_MAX_TYPES || !isTypeSupported(type))
+    {
+        encode_get_commands_resp(0, PLDM_ERROR_INVALID_PLDM_TYPE, nullptr,
+                                 responsePtr);
+        return PLDM_SUCCESS;
+    }
+
+    encode_get_commands_resp(
+        0, PLDM_SUCCESS,
+        reinterpret_cast<const bitfield8_t*>(commandBits[type].data()),
+        responsePtr);
+    return PLDM_SUCCESS;
+}
+
+/** @brief Parse the header of a request and count it
+ *
+ *  @param[in] request - PLDM request message, including the header
+ *  @param[in] requestLength - length of the request message
+ *  @param[out] header - the unpacked header
+ *
+ *  @return bool - true if the message is a request to be answered
+ */
+bool accept(const pldm_msg* request, size_t requestLength,
+            pldm_header_info& header)
+{
+    if (request == nullptr || requestLength < sizeof(pldm_msg_hdr) ||
+        unpack_pldm_header(&request->hdr, &header) != PLDM_SUCCESS ||
+        header.msg_type != PLDM_REQUEST)
+    {
+        return false;
+    }
+
+    requestCounts[header.pldm_type * PLDM_MAX_CMDS_PER_TYPE + header.command]
+        .fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+/** @brief Run the handler of an accepted request */
+int invoke(const pldm_header_info& header, const pldm_msg* request,
+           size_t requestLength, uint8_t* response, size_t& responseLength)
+{
+    auto handler = handlers[header.pldm_type][header.command];
+    if (!handler)
+    {
+        constexpr size_t encodedLength = sizeof(pldm_msg_hdr) + 1;
+        if (responseLength < encodedLength)
+        {
+            responseLength = encodedLength;
+            return PLDM_ERROR_INVALID_LENGTH;
+        }
+        responseLength = encodedLength;
+
+        uint8_t completionCode = isTypeSupported(header.pldm_type)
+                                     ? PLDM_ERROR_UNSUPPORTED_PLDM_CMD
+                                     : PLDM_ERROR_INVALID_PLDM_TYPE;
+        return encode_cc_only_resp(header.instance, header.pldm_type,
+                                   header.command, completionCode,
+                                   reinterpret_cast<pldm_msg*>(response));
+    }
+
+    auto rc = handler(request->payload, requestLength - sizeof(pldm_msg_hdr),
+                      response, responseLength);
+    if (rc == PLDM_SUCCESS)
+    {
+        reinterpret_cast<pldm_msg*>(response)->hdr.instance_id =
+            header.instance;
+    }
+    return rc;
+}
+
+/** @brief Run the handler of an accepted request, encoding the response into
+ *         the per-thread arena
+ */
+std::pair<const uint8_t*, size_t> invoke(const pldm_header_info& header,
+                                         const pldm_msg* request,
+                                         size_t requestLength)
+{
+    // Replies from the replay cache may have shrunk the arena without
+    // releasing its storage. Handlers check the size of the buffer before
+    // doing any work, so a request is safe to run again once the arena has
+    // grown.
+    auto& arena = responseArena();
+    arena.resize(arena.capacity());
+    for (int attempt = 0; attempt < maxEncodeAttempts; ++attempt)
+    {
+        size_t length = arena.size();
+        if (invoke(header, request, requestLength, arena.data(), length) !=
+            PLDM_ERROR_INVALID_LENGTH)
+        {
+            return {arena.data(), std::min(length, arena.size())};
+        }
+        arena.resize(length);
+    }
+
+    // The response kept outgrowing the arena, the file kept growing
+    constexpr size_t errorLength = sizeof(pldm_msg_hdr) + 1;
+    arena.resize(std::max(arena.size(), errorLength));
+    encode_cc_only_resp(header.instance, header.pldm_type, header.command,
+                        PLDM_ERROR, reinterpret_cast<pldm_msg*>(arena.data()));
+    return {arena.data(), errorLength};
+}
+
+/** @brief Record the latency of a request by its completion code */
+void recordLatency(const pldm_header_info& header, const uint8_t* response,
+                   size_t responseLength, const metrics::Timer& timer)
+{
+    if (responseLength > sizeof(pldm_msg_hdr))
+    {
+        metrics::recordCommand(header.pldm_type, header.command,
+                               response[sizeof(pldm_msg_hdr)],
+                               timer.elapsed());
+    }
+}
+
+/** @brief Remember a response in the replay cache
+ *
+ *  Failed requests are not remembered, so that a later retry runs the command
+ *  again and has a chance to succeed. Retries that arrived while the request
+ *  ran get its response either way.
+ */
+void remember(uint8_t eid, const pldm_msg* request, size_t requestLength,
+              const uint8_t* response, size_t responseLength)
+{
+    bool success = responseLength > sizeof(pldm_msg_hdr) &&
+                   response[sizeof(pldm_msg_hdr)] == PLDM_SUCCESS;
+    replayCache().finish(eid, request, requestLength, response, responseLength,
+                         success);
+}
+
+/** @brief Handler of a command whose DMA transfer runs on an event loop */
+using AsyncHandler = void (*)(EventLoop& loop, const uint8_t* request,
+                              size_t payloadLength, dma::Completion done);
+
+/** @brief Get the event loop form of the handler of a command
+ *
+ *  @return the handler, or nullptr if the command only has a synchronous
+ *          handler
+ */
+AsyncHandler asyncHandler(const pldm_header_info& header)
+{
+    if (header.pldm_type != PLDM_IBM_OEM_TYPE)
+    {
+        return nullptr;
+    }
+
+    switch (header.command)
+    {
+        case PLDM_READ_FILE_INTO_MEMORY:
+            return readFileIntoMemory;
+        case PLDM_WRITE_FILE_FROM_MEMORY:
+            return writeFileFromMemory;
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace
+
+int handle(const pldm_msg* request, size_t requestLength, uint8_t* response,
+           size_t& responseLength)
+{
+    metrics::Timer timer;
+    pldm_header_info header{};
+    if (!accept(request, requestLength, header))
+    {
+        return PLDM_ERROR_INVALID_DATA;
+    }
+
+    auto rc = invoke(header, request, requestLength, response, responseLength);
+    if (rc == PLDM_SUCCESS)
+    {
+        recordLatency(header, response, responseLength, timer);
+    }
+    return rc;
+}
+
+std::pair<const uint8_t*, size_t> handle(const pldm_msg* request,
+                                         size_t requestLength)
+{
+    metrics::Timer timer;
+    pldm_header_info header{};
+    if (!accept(request, requestLength, header))
+    {
+        return {nullptr, 0};
+    }
+
+    auto [response, length] = invoke(header, request, requestLength);
+    recordLatency(header, response, length, timer);
+    return {response, length};
+}
+
+std::pair<const uint8_t*, size_t>
+    handle(uint8_t eid, const pldm_msg* request, size_t requestLength)
+{
+    metrics::Timer timer;
+    pldm_header_info header{};
+    if (!accept(request, requestLength, header))
+    {
+        return {nullptr, 0};
+    }
+    captureWriter().record(eid, reinterpret_cast<const uint8_t*>(request),
+                           requestLength);
+
+    auto& cache = replayCache();
+    auto& arena = responseArena();
+    if (cache.lookup(eid, request, requestLength, arena))
+    {
+        recordLatency(header, arena.data(), arena.size(), timer);
+        return {arena.data(), arena.size()};
+    }
+
+    auto [response, length] = invoke(header, request, requestLength);
+    remember(eid, request, requestLength, response, length);
+    recordLatency(header, response, length, timer);
+    return {response, length};
+}
+
+std::optional<uint32_t> orderingKey(const pldm_msg* request,
+                                    size_t requestLength)
+{
+    if (requestLength < sizeof(pldm_msg_hdr) + sizeof(uint32_t) ||
+        request->hdr.type != PLDM_IBM_OEM_TYPE)
+    {
+        return std::nullopt;
+    }
+
+    switch (request->hdr.command)
+    {
+        case PLDM_READ_FILE:
+        case PLDM_WRITE_FILE:
+        case PLDM_READ_FILE_INTO_MEMORY:
+        case PLDM_WRITE_FILE_FROM_MEMORY:
+        case PLDM_GET_CHANGED_BLOCKS:
+        case PLDM_GET_FILE_CHECKSUM:
+        case PLDM_FOLLOW_FILE:
+        {
+            uint32_t fileHandle = 0;
+            memcpy(&fileHandle, request->payload, sizeof(fileHandle));
+            return le32toh(fileHandle);
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
+void submit(Executor& executor, uint8_t eid, std::vector<uint8_t> request,
+            ReplyHandler reply)
+{
+    auto message = reinterpret_cast<const pldm_msg*>(request.data());
+    auto key = orderingKey(message, request.size());
+
+    auto task = [eid, request = std::move(request),
+                 reply = std::move(reply)]() {
+        auto [response, length] =
+            handle(eid, reinterpret_cast<const pldm_msg*>(request.data()),
+                   request.size());
+        if (length)
+        {
+            reply(response, length);
+        }
+    };
+
+    if (key)
+    {
+        executor.post(*key, std::move(task));
+    }
+    else
+    {
+        executor.post(std::move(task));
+    }
+}
+
+void submit(EventLoop& loop, uint8_t eid, std::vector<uint8_t> request,
+            ReplyHandler reply)
+{
+    auto requestMsg =
+        std::make_shared<const std::vector<uint8_t>>(std::move(request));
+
+    // The latency includes the time the request waits on the loop
+    metrics::Timer timer;
+    loop.post([&loop, eid, requestMsg, timer, reply = std::move(reply)]() {
+        auto message = reinterpret_cast<const pldm_msg*>(requestMsg->data());
+        auto requestLength = requestMsg->size();
+
+        pldm_header_info header{};
+        if (!accept(message, requestLength, header))
+        {
+            return;
+        }
+        captureWriter().record(eid, requestMsg->data(), requestLength);
+
+        // A retry of a request that is still running, a DMA that outlasted
+        // the requester's timeout, is answered when the request finishes
+        auto waiter = [&loop, header, timer, reply](const Response& response) {
+            auto responseMsg = std::make_shared<Response>(response);
+            loop.post([header, timer, reply, responseMsg]() {
+                recordLatency(header, responseMsg->data(), responseMsg->size(),
+                              timer);
+                reply(responseMsg->data(), responseMsg->size());
+            });
+        };
+
+        auto& arena = responseArena();
+        auto start = replayCache().start(eid, message, requestLength, arena,
+                                         std::move(waiter));
+        if (start == ReplayCache::Start::Waiting)
+        {
+            return;
+        }
+        if (start == ReplayCache::Start::Replayed)
+        {
+            recordLatency(header, arena.data(), arena.size(), timer);
+            reply(arena.data(), arena.size());
+            return;
+        }
+
+        auto handler = asyncHandler(header);
+        auto key = orderingKey(message, requestLength);
+        if (!handler && !key)
+        {
+            auto [response, length] = invoke(header, message, requestLength);
+            remember(eid, message, requestLength, response, length);
+            recordLatency(header, response, length, timer);
+            reply(response, length);
+            return;
+        }
+
+        // Other file commands wait for their range lock, which a transfer on
+        // the loop may hold until its next step, so they must not run on the
+        // loop thread
+        if (!handler)
+        {
+            executor().post(*key, [&loop, eid, requestMsg, header, timer,
+                                   reply]() {
+                auto message =
+                    reinterpret_cast<const pldm_msg*>(requestMsg->data());
+                auto [response, length] =
+                    invoke(header, message, requestMsg->size());
+                recordLatency(header, response, length, timer);
+
+                // Reply before the retries that waited for the request
+                auto responseMsg =
+                    std::make_shared<Response>(response, response + length);
+                loop.post([responseMsg, reply]() {
+                    reply(responseMsg->data(), responseMsg->size());
+                });
+                remember(eid, message, requestMsg->size(), response, length);
+            });
+            return;
+        }
+
+        handler(loop, message->payload, requestLength - sizeof(pldm_msg_hdr),
+                [eid, requestMsg, header, timer,
+                 reply](const uint8_t* response, size_t length) {
+                    Response responseMsg(response, response + length);
+                    reinterpret_cast<pldm_msg*>(responseMsg.data())
+                        ->hdr.instance_id = header.instance;
+
+                    remember(eid,
+                             reinterpret_cast<const pldm_msg*>(
+                                 requestMsg->data()),
+                             requestMsg->size(), responseMsg.data(),
+                             responseMsg.size());
+                    recordLatency(header, responseMsg.data(),
+                                  responseMsg.size(), timer);
+                    reply(responseMsg.data(), responseMsg.size());
+                });
+    });
+}
+
+bool isSupported(uint8_t type, uint8_t command)
+{
+    return type < PLDM_MAX_TYPES && handlers[type][command];
+}
+
+uint64_t requestCount(uint8_t type, uint8_t command)
+{
+    if (type >= PLDM_MAX_TYPES)
+    {
+        return 0;
+    }
+    return requestCounts[type * PLDM_MAX_CMDS_PER_TYPE + command].load(
+        std::memory_order_relaxed);
+}
+
+} // namespace dispatch
+} // namespace responder
+} // namespace pldm
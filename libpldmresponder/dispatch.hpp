@@ -0,0 +1,152 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "event_loop.hpp"
+#include "executor.hpp"
+#include "file_io.hpp"
+#include "libpldm/base.h"
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace dispatch
+{
+
+/** @brief Handle a PLDM request message
+ *
+ *  The handler is looked up by the PLDM type and command in the header, in a
+ *  table indexed by both that is filled in at compile time. Requests for types
+ *  or commands without a handler are answered with
+ *  PLDM_ERROR_INVALID_PLDM_TYPE or PLDM_ERROR_UNSUPPORTED_PLDM_CMD. The
+ *  response carries the instance id of the request.
+ *
+ *  @param[in] request - PLDM request message, including the header
+ *  @param[in] requestLength - length of the request message
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[in,out] responseLength - size of the buffer on input. On output the
+ *                                  length of the encoded response message, or
+ *                                  the size needed if the buffer is too small
+ *
+ *  @return PLDM_SUCCESS if the response was encoded, PLDM_ERROR_INVALID_LENGTH
+ *          if the buffer is too small, PLDM_ERROR_INVALID_DATA if the message
+ *          is not a request and must not be answered
+ */
+int handle(const pldm_msg* request, size_t requestLength, uint8_t* response,
+           size_t& responseLength);
+
+/** @brief Handle a PLDM request message, encoding the response into the
+ *         per-thread arena
+ *
+ *  @param[in] request - PLDM request message, including the header
+ *  @param[in] requestLength - length of the request message
+ *
+ *  @return pointer to and length of the PLDM response message, valid until the
+ *          next response is encoded on the same thread. The length is 0 if
+ *          the message must not be answered.
+ */
+std::pair<const uint8_t*, size_t> handle(const pldm_msg* request,
+                                         size_t requestLength);
+
+/** @brief Handle a PLDM request message from a requester, answering retries
+ *         from the replay cache
+ *
+ *  A request that repeats the instance id, type, command and payload of a
+ *  request from the same requester that succeeded within the instance id
+ *  expiration interval is answered with the earlier response, without running
+ *  the command again.
+ *
+ *  @param[in] eid - MCTP endpoint id of the requester
+ *  @param[in] request - PLDM request message, including the header
+ *  @param[in] requestLength - length of the request message
+ *
+ *  @return pointer to and length of the PLDM response message, valid until the
+ *          next response is encoded on the same thread. The length is 0 if
+ *          the message must not be answered.
+ */
+std::pair<const uint8_t*, size_t>
+    handle(uint8_t eid, const pldm_msg* request, size_t requestLength);
+
+/** @brief Get the key that orders a request with respect to other requests
+ *
+ *  Commands that read or write a file are keyed by the file handle, so that
+ *  requests for a file run in the order they were received.
+ *
+ *  @param[in] request - PLDM request message, including the header
+ *  @param[in] requestLength - length of the request message
+ *
+ *  @return the file handle, or no key if the request can run in any order
+ */
+std::optional<uint32_t> orderingKey(const pldm_msg* request,
+                                    size_t requestLength);
+
+/** @brief Callback that sends a PLDM response message to the requester */
+using ReplyHandler =
+    std::function<void(const uint8_t* response, size_t responseLength)>;
+
+/** @brief Handle a PLDM request message on a worker of an executor
+ *
+ *  The request is posted with its ordering key, and reply is called on the
+ *  worker with the response. Messages that must not be answered are dropped
+ *  without calling reply.
+ *
+ *  @param[in] executor - executor to run the request on
+ *  @param[in] eid - MCTP endpoint id of the requester
+ *  @param[in] request - PLDM request message, including the header
+ *  @param[in] reply - callback that sends the response
+ */
+void submit(Executor& executor, uint8_t eid, std::vector<uint8_t> request,
+            ReplyHandler reply);
+
+/** @brief Handle a PLDM request message on an event loop
+ *
+ *  ReadFileIntoMemory and WriteFileFromMemory run their DMA transfers a
+ *  chunk at a time, each chunk on the DMA executor, waiting for their turn
+ *  on the loop in between. The other commands that read or write a file may
+ *  wait for a range lock held by one of those transfers, so they run on the
+ *  executor of the responder with their ordering key; the rest run when the
+ *  request is taken off the loop. reply is called on the loop thread with the
+ *  response. Retries are answered from the replay cache, and retries of a
+ *  request that is still running are answered with its response when it
+ *  finishes. Messages that must not be answered are dropped without calling
+ *  reply.
+ *
+ *  @param[in] loop - event loop to run the request on
+ *  @param[in] eid - MCTP endpoint id of the requester
+ *  @param[in] request - PLDM request message, including the header
+ *  @param[in] reply - callback that sends the response
+ */
+void submit(EventLoop& loop, uint8_t eid, std::vector<uint8_t> request,
+            ReplyHandler reply);
+
+/** @brief Check if there is a handler for a PLDM type and command
+ *
+ *  @param[in] type - PLDM type
+ *  @param[in] command - PLDM command
+ *
+ *  @return bool - true if the command is supported, false otherwise.
+ */
+bool isSupported(uint8_t type, uint8_t command);
+
+/** @brief Get the number of requests dispatched for a PLDM type and command
+ *
+ *  Requests for unsupported types and commands are counted as well.
+ *
+ *  @param[in] type - PLDM type
+ *  @param[in] command - PLDM command
+ *
+ *  @return number of requests received since the responder started
+ */
+uint64_t requestCount(uint8_t type, uint8_t command);
+
+} // namespace dispatch
+} // namespace responder
+} // namespace pldm
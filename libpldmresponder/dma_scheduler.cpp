@@ -0,0 +1,106 @@
+#include "dma_scheduler.hpp"
+
+#include <algorithm>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace
+{
+
+// Virtual time a byte takes at a weight of 1, scaled so that tags stay
+// integers for every weight up to the scale
+constexpr uint64_t costScale = 1 << 16;
+
+// Interactive chunks get 8 times the share of the engine of bulk chunks
+constexpr std::array<uint32_t, priorityCount> defaultWeights = {8, 1};
+
+} // namespace
+
+DMAScheduler::Ticket DMAScheduler::enqueue(Priority priority, uint64_t bytes)
+{
+    auto index = static_cast<size_t>(priority);
+
+    // When the engine is idle with nothing queued no class is behind, start
+    // the virtual clock over so that a class that was idle does not get
+    // credit for it
+    if (!busy && queue.empty())
+    {
+        virtualTime = 0;
+        lastTag.fill(0);
+    }
+
+    auto tag = std::max(virtualTime, lastTag[index]) +
+               bytes * costScale / weights[index];
+    lastTag[index] = tag;
+    queue.emplace(tag, ++lastTicket);
+    return lastTicket;
+}
+
+bool DMAScheduler::start(Ticket ticket)
+{
+    if (busy || queue.empty() || queue.begin()->second != ticket)
+    {
+        return false;
+    }
+    virtualTime = queue.begin()->first;
+    queue.erase(queue.begin());
+    busy = true;
+    return true;
+}
+
+DMAScheduler::Turn DMAScheduler::acquire(Priority priority, uint64_t bytes)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    auto ticket = enqueue(priority, bytes);
+    finished.wait(lock, [&] { return start(ticket); });
+    return Turn(this);
+}
+
+DMAScheduler::Ticket DMAScheduler::submit(Priority priority, uint64_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return enqueue(priority, bytes);
+}
+
+bool DMAScheduler::tryStart(Ticket ticket, Waiter wake)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (start(ticket))
+    {
+        return true;
+    }
+    if (wake)
+    {
+        waiters.push_back(std::move(wake));
+    }
+    return false;
+}
+
+void DMAScheduler::finish()
+{
+    std::vector<Waiter> woken;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        busy = false;
+        woken.swap(waiters);
+    }
+    finished.notify_all();
+
+    for (auto& wake : woken)
+    {
+        wake();
+    }
+}
+
+DMAScheduler& dmaScheduler()
+{
+    static DMAScheduler scheduler(defaultWeights);
+    return scheduler;
+}
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+/** @brief Scheduling class of a DMA transfer */
+enum class Priority
+{
+    Interactive, //!< Small transfers the host waits on, e.g. headers
+    Bulk,        //!< Large transfers, e.g. dump uploads
+};
+
+constexpr size_t priorityCount = 2;
+
+// Transfers up to this length are scheduled as interactive
+constexpr uint32_t interactiveMaxLength = 64 * 1024;
+
+/** @brief Get the scheduling class of a transfer
+ *
+ *  @param[in] length - length of the whole transfer
+ *
+ *  @return the class
+ */
+constexpr Priority classify(uint32_t length)
+{
+    return (length <= interactiveMaxLength) ? Priority::Interactive
+                                            : Priority::Bulk;
+}
+
+/** @class DMAScheduler
+ *
+ *  DMAScheduler orders the chunks of DMA transfers on the single DMA engine,
+ *  so that a bulk transfer does not hold up small transfers for its whole
+ *  length. Chunks wait in one queue and are started one at a time by
+ *  self-clocked weighted fair queueing: each chunk is tagged with the
+ *  virtual time its class would finish it at, given the weight of the class,
+ *  and the chunk with the smallest tag starts next. A small chunk that
+ *  arrives behind a backlog of bulk chunks starts after the chunk in
+ *  progress, while bulk transfers keep their share of the engine when both
+ *  classes are busy, so the engine is never left idle.
+ *
+ *  Chunks should hold their range lock before they queue, so that the chunk
+ *  on the engine never waits for a lock held by a queued chunk.
+ */
+class DMAScheduler
+{
+  public:
+    /** @brief Identifies a queued chunk, 0 is never a valid ticket */
+    using Ticket = uint64_t;
+
+    /** @class Turn
+     *
+     *  Frees the engine for the next chunk when it goes out of scope
+     */
+    class Turn
+    {
+      public:
+        Turn(DMAScheduler* scheduler) : scheduler(scheduler)
+        {
+        }
+
+        Turn() = delete;
+        Turn(const Turn&) = delete;
+        Turn& operator=(const Turn&) = delete;
+
+        Turn(Turn&& other) : scheduler(other.scheduler)
+        {
+            other.scheduler = nullptr;
+        }
+
+        Turn& operator=(Turn&&) = delete;
+
+        ~Turn()
+        {
+            if (scheduler)
+            {
+                scheduler->finish();
+            }
+        }
+
+      private:
+        DMAScheduler* scheduler;
+    };
+
+    /** @brief Create a scheduler
+     *
+     * @param[in] weights - share of the engine of each class, indexed by
+     *                      Priority
+     */
+    explicit DMAScheduler(std::array<uint32_t, priorityCount> weights) :
+        weights(weights)
+    {
+    }
+
+    DMAScheduler() = delete;
+    ~DMAScheduler() = default;
+    DMAScheduler(const DMAScheduler&) = delete;
+    DMAScheduler& operator=(const DMAScheduler&) = delete;
+
+    /** @brief Queue a chunk and wait until it is its turn on the engine
+     *
+     * @param[in] priority - class of the transfer
+     * @param[in] bytes - length of the chunk
+     *
+     * @return Turn - frees the engine when destroyed
+     */
+    Turn acquire(Priority priority, uint64_t bytes);
+
+    /** @brief Queue a chunk without waiting
+     *
+     * @param[in] priority - class of the transfer
+     * @param[in] bytes - length of the chunk
+     *
+     * @return ticket to pass to tryStart
+     */
+    Ticket submit(Priority priority, uint64_t bytes);
+
+    /** @brief Called when the engine may be free, see tryStart */
+    using Waiter = std::function<void()>;
+
+    /** @brief Start a queued chunk if it is its turn on the engine
+     *
+     * @param[in] ticket - ticket returned by submit
+     * @param[in] wake - if the chunk is not started, called once on the
+     *                   thread that next frees the engine
+     *
+     * @return bool - true if the chunk was started and the engine must be
+     *                freed with finish, false if it is not its turn yet
+     */
+    bool tryStart(Ticket ticket, Waiter wake = nullptr);
+
+    /** @brief Free the engine for the next chunk */
+    void finish();
+
+  private:
+    /** @brief Queue a chunk, with the mutex held */
+    Ticket enqueue(Priority priority, uint64_t bytes);
+
+    /** @brief Start a queued chunk if it is its turn, with the mutex held */
+    bool start(Ticket ticket);
+
+    /** @brief share of the engine of each class */
+    std::array<uint32_t, priorityCount> weights;
+
+    /** @brief virtual finish time of the last queued chunk of each class */
+    std::array<uint64_t, priorityCount> lastTag{};
+
+    /** @brief tag of the chunk on the engine, the virtual time */
+    uint64_t virtualTime = 0;
+
+    /** @brief last ticket handed out */
+    Ticket lastTicket = 0;
+
+    /** @brief whether a chunk is on the engine */
+    bool busy = false;
+
+    /** @brief queued chunks by tag, in arrival order for equal tags */
+    std::set<std::pair<uint64_t, Ticket>> queue;
+
+    /** @brief callers of tryStart waiting for the engine to be freed */
+    std::vector<Waiter> waiters;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+/** @brief Get the DMA scheduler of the responder
+ *
+ *  @return DMAScheduler& - Reference to instance of the scheduler
+ */
+DMAScheduler& dmaScheduler();
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,219 @@
+#include "event_loop.hpp"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <system_error>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+EventLoop::EventLoop()
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "epoll_create1");
+    }
+
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFd < 0)
+    {
+        auto error = errno;
+        close(epollFd);
+        throw std::system_error(error, std::generic_category(), "eventfd");
+    }
+
+    // steady_clock is CLOCK_MONOTONIC, so deadlines are set as they are
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (timerFd < 0)
+    {
+        auto error = errno;
+        close(wakeFd);
+        close(epollFd);
+        throw std::system_error(error, std::generic_category(),
+                                "timerfd_create");
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    event.data.fd = timerFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &event);
+}
+
+EventLoop::~EventLoop()
+{
+    close(timerFd);
+    close(wakeFd);
+    close(epollFd);
+}
+
+void EventLoop::post(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+
+    uint64_t one = 1;
+    auto rc = write(wakeFd, &one, sizeof(one));
+    (void)rc;
+}
+
+void EventLoop::postAfter(Clock::duration delay, Task task)
+{
+    if (delay <= Clock::duration::zero())
+    {
+        post(std::move(task));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto deadline = Clock::now() + delay;
+    bool earliest = timers.empty() || deadline < timers.begin()->first;
+    timers.emplace(deadline, std::move(task));
+    if (earliest)
+    {
+        armTimer();
+    }
+}
+
+void EventLoop::armTimer()
+{
+    itimerspec spec{};
+    if (!timers.empty())
+    {
+        auto deadline = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            timers.begin()->first.time_since_epoch())
+                            .count();
+        spec.it_value.tv_sec = deadline / 1000000000;
+        spec.it_value.tv_nsec = deadline % 1000000000;
+    }
+    timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+void EventLoop::expireTimers()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto now = Clock::now();
+    auto iter = timers.begin();
+    for (; iter != timers.end() && iter->first <= now; ++iter)
+    {
+        tasks.push_back(std::move(iter->second));
+    }
+    timers.erase(timers.begin(), iter);
+    armTimer();
+}
+
+int EventLoop::addIO(int fd, uint32_t events, IOHandler handler)
+{
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        return -errno;
+    }
+    handlers[fd] = std::move(handler);
+    return 0;
+}
+
+void EventLoop::removeIO(int fd)
+{
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    handlers.erase(fd);
+}
+
+size_t EventLoop::runTasks()
+{
+    // Tasks posted by the tasks run here wait for the next iteration, so
+    // that ready file descriptors are not starved
+    std::deque<Task> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.swap(tasks);
+    }
+
+    for (auto& task : ready)
+    {
+        task();
+    }
+    return ready.size();
+}
+
+size_t EventLoop::runOnce(int timeout)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!tasks.empty())
+        {
+            timeout = 0;
+        }
+    }
+
+    std::array<epoll_event, 16> events{};
+    auto count = epoll_wait(epollFd, events.data(), events.size(), timeout);
+
+    size_t ran = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        int fd = events[i].data.fd;
+        if (fd == wakeFd)
+        {
+            uint64_t value = 0;
+            auto rc = read(wakeFd, &value, sizeof(value));
+            (void)rc;
+            continue;
+        }
+        if (fd == timerFd)
+        {
+            uint64_t expirations = 0;
+            auto rc = read(timerFd, &expirations, sizeof(expirations));
+            (void)rc;
+            expireTimers();
+            continue;
+        }
+
+        // The handler may remove itself, so it is called on a copy
+        auto iter = handlers.find(fd);
+        if (iter != handlers.end())
+        {
+            auto handler = iter->second;
+            handler(events[i].events);
+            ran++;
+        }
+    }
+
+    return ran + runTasks();
+}
+
+void EventLoop::run()
+{
+    stopping = false;
+    while (true)
+    {
+        runOnce(-1);
+        if (stopping)
+        {
+            return;
+        }
+    }
+}
+
+void EventLoop::stop()
+{
+    post([this] { stopping = true; });
+}
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "executor.hpp"
+
+namespace pldm
+{
+
+namespace responder
+{
+
+/** @class EventLoop
+ *
+ *  Single threaded event loop on epoll. It runs posted tasks and callbacks
+ *  for file descriptors that become ready. Long running work, such as a
+ *  transfer of many DMA chunks, is split into tasks that each post the next
+ *  one, so that one loop thread interleaves any number of outstanding
+ *  requests without a thread per request. A task that has to wait, e.g. for
+ *  a retry backoff, is posted with a delay instead of posting itself again.
+ */
+class EventLoop
+{
+  public:
+    using IOHandler = std::function<void(uint32_t events)>;
+
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief Create the epoll instance, the eventfd that wakes the loop and
+     *         the timerfd of the delayed tasks
+     *
+     *  @throw std::system_error if any of them cannot be created
+     */
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /** @brief Run a task on the loop thread, may be called from any thread
+     *
+     * @param[in] task - task to run
+     */
+    void post(Task task);
+
+    /** @brief Run a task on the loop thread once a delay has passed, may be
+     *         called from any thread
+     *
+     * @param[in] delay - time to wait before the task is run
+     * @param[in] task - task to run
+     */
+    void postAfter(Clock::duration delay, Task task);
+
+    /** @brief Call a handler whenever a file descriptor is ready
+     *
+     * @param[in] fd - file descriptor to watch
+     * @param[in] events - epoll events to wait for
+     * @param[in] handler - called with the ready events on the loop thread
+     *
+     * @return 0 on success, negative errno on failure
+     */
+    int addIO(int fd, uint32_t events, IOHandler handler);
+
+    /** @brief Stop watching a file descriptor
+     *
+     * @param[in] fd - file descriptor to stop watching
+     */
+    void removeIO(int fd);
+
+    /** @brief Wait for events once and run the ready callbacks and the posted
+     *         tasks
+     *
+     * @param[in] timeout - time to wait in milliseconds, -1 waits forever
+     *
+     * @return number of callbacks and tasks run
+     */
+    size_t runOnce(int timeout);
+
+    /** @brief Run the loop until stop is called
+     */
+    void run();
+
+    /** @brief Make run return, may be called from any thread
+     */
+    void stop();
+
+  private:
+    /** @brief Run the tasks posted so far */
+    size_t runTasks();
+
+    /** @brief Move the delayed tasks that are due to the posted tasks */
+    void expireTimers();
+
+    /** @brief Set the timerfd to the earliest deadline, with the mutex held
+     */
+    void armTimer();
+
+    int epollFd = -1;
+    int wakeFd = -1;
+    int timerFd = -1;
+    bool stopping = false;
+
+    /** @brief file descriptor to its handler */
+    std::unordered_map<int, IOHandler> handlers;
+
+    std::mutex mutex;
+    std::deque<Task> tasks;
+
+    /** @brief delayed tasks by deadline */
+    std::multimap<Clock::time_point, Task> timers;
+};
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,274 @@
+#include "executor.hpp"
+
+#include "logging.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+using namespace phosphor::logging;
+
+TaskQueue::TaskQueue(size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+
+    cells = std::make_unique<Cell[]>(size);
+    mask = size - 1;
+    for (size_t i = 0; i < size; ++i)
+    {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool TaskQueue::push(Task& task)
+{
+    auto pos = enqueuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        auto& cell = cells[pos & mask];
+        auto sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff =
+            static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1))
+            {
+                cell.task = std::move(task);
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool TaskQueue::pop(Task& task)
+{
+    auto pos = dequeuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+        auto& cell = cells[pos & mask];
+        auto sequence = cell.sequence.load(std::memory_order_acquire);
+        auto diff =
+            static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0)
+        {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1))
+            {
+                task = std::move(cell.task);
+                cell.task = nullptr;
+                cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+Executor::Executor(size_t workerCount, size_t queueCapacity)
+{
+    workerCount = std::max<size_t>(workerCount, 1);
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(queueCapacity));
+    }
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        workers[i]->thread = std::thread(&Executor::run, this, i);
+    }
+}
+
+Executor::~Executor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker->thread.join();
+    }
+}
+
+void Executor::enqueue(TaskQueue& queue, Task& task)
+{
+    pending.fetch_add(1);
+    while (!queue.push(task))
+    {
+        std::this_thread::yield();
+    }
+
+    // A worker increments sleeping before it last checks the queues, so
+    // either it sees the task or the task's producer sees it asleep
+    if (sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        workAvailable.notify_all();
+    }
+}
+
+void Executor::post(Task task)
+{
+    auto index =
+        nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+    enqueue(workers[index]->shared, task);
+}
+
+void Executor::post(uint32_t key, Task task)
+{
+    pending.fetch_add(1);
+    {
+        // A strand with tasks already has its runner queued
+        std::lock_guard<std::mutex> lock(strandMutex);
+        auto& strand = strands[key];
+        strand.tasks.push_back(std::move(task));
+        if (strand.tasks.size() > 1)
+        {
+            return;
+        }
+    }
+    post([this, key] { runStrand(key); });
+}
+
+void Executor::runStrand(uint32_t key)
+{
+    Task task;
+    {
+        std::lock_guard<std::mutex> lock(strandMutex);
+        task = std::move(strands.at(key).tasks.front());
+    }
+
+    // The task stays at the front of its strand while it runs, so that tasks
+    // posted meanwhile wait for it
+    runTask(task);
+
+    {
+        std::lock_guard<std::mutex> lock(strandMutex);
+        auto iter = strands.find(key);
+        iter->second.tasks.pop_front();
+        if (iter->second.tasks.empty())
+        {
+            strands.erase(iter);
+            return;
+        }
+    }
+
+    // Queue the strand behind the work of other keys rather than running
+    // its tasks back to back
+    post([this, key] { runStrand(key); });
+}
+
+void Executor::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return pending.load() == 0; });
+}
+
+void Executor::runTask(Task& task)
+{
+    try
+    {
+        task();
+    }
+    catch (const std::exception& e)
+    {
+        PLDM_LOG(ERR, "Task failed", entry("ERROR=%s", e.what()));
+    }
+
+    if (pending.fetch_sub(1) == 1)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.notify_all();
+    }
+}
+
+bool Executor::runOne(size_t index)
+{
+    Task task;
+    bool found = false;
+    for (size_t i = 0; !found && i < workers.size(); ++i)
+    {
+        found = workers[(index + i) % workers.size()]->shared.pop(task);
+    }
+    if (!found)
+    {
+        return false;
+    }
+
+    runTask(task);
+    return true;
+}
+
+bool Executor::hasWork() const
+{
+    for (const auto& worker : workers)
+    {
+        if (!worker->shared.empty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Executor::run(size_t index)
+{
+    while (true)
+    {
+        if (runOne(index))
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        sleeping.fetch_add(1);
+        workAvailable.wait(lock,
+                           [&] { return stopping.load() || hasWork(); });
+        sleeping.fetch_sub(1);
+        if (stopping.load() && !hasWork())
+        {
+            return;
+        }
+    }
+}
+
+Executor& executor()
+{
+    static Executor executor(std::thread::hardware_concurrency());
+    return executor;
+}
+
+Executor& dmaExecutor()
+{
+    static Executor executor(1);
+    return executor;
+}
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+using Task = std::function<void()>;
+
+/** @class TaskQueue
+ *
+ *  Bounded lock-free queue of tasks with any number of producers and
+ *  consumers, after Dmitry Vyukov's bounded MPMC queue. Every cell carries a
+ *  sequence number that tells producers and consumers whether it is free or
+ *  full for their lap around the ring, so neither side takes a lock.
+ */
+class TaskQueue
+{
+  public:
+    /** @brief Create the queue
+     *
+     * @param[in] capacity - number of tasks the queue holds, rounded up to a
+     *                       power of two
+     */
+    explicit TaskQueue(size_t capacity);
+
+    TaskQueue() = delete;
+    ~TaskQueue() = default;
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
+
+    /** @brief Add a task to the tail of the queue
+     *
+     * @param[in] task - task to add, moved from on success only
+     *
+     * @return bool - true on success, false if the queue is full
+     */
+    bool push(Task& task);
+
+    /** @brief Remove the task at the head of the queue
+     *
+     * @param[out] task - the removed task
+     *
+     * @return bool - true on success, false if the queue is empty
+     */
+    bool pop(Task& task);
+
+    /** @brief Check if the queue looks empty, without synchronising with a
+     *         push or pop that is in progress
+     */
+    bool empty() const
+    {
+        return enqueuePos.load() == dequeuePos.load();
+    }
+
+  private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        Task task;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    // The producer and consumer positions are on separate cache lines so
+    // that the two sides do not contend for one line
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+};
+
+/** @class Executor
+ *
+ *  Executor runs tasks on a pool of worker threads. A task posted without a
+ *  key may run on any worker: it is queued on the workers in turn, and a
+ *  worker that runs out of work steals from the others. Tasks posted with a
+ *  key run one at a time in the order they were posted, so requests for one
+ *  file handle are not reordered. They wait in a strand per key, and a key
+ *  with waiting tasks has one unkeyed task queued that runs the next of them
+ *  and queues itself again, so any idle worker picks up any key and a slow
+ *  task only holds up the tasks of its own key.
+ *
+ *  Posting an unkeyed task is lock-free, posting a keyed task takes the lock
+ *  of the strands for as long as it takes to append to one. Idle workers
+ *  sleep on a condition variable, which is only signalled if a worker is
+ *  asleep.
+ */
+class Executor
+{
+  public:
+    /** @brief Start the worker threads
+     *
+     * @param[in] workerCount - number of worker threads, at least 1
+     * @param[in] queueCapacity - number of tasks each queue of a worker holds
+     */
+    explicit Executor(size_t workerCount, size_t queueCapacity = 1024);
+
+    /** @brief Run the tasks that are still queued, and stop the workers
+     */
+    ~Executor();
+
+    Executor() = delete;
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /** @brief Run a task on any worker
+     *
+     * @param[in] task - task to run
+     */
+    void post(Task task);
+
+    /** @brief Run a task after the tasks posted earlier with the same key
+     *
+     * @param[in] key - ordering key, e.g. a file handle
+     * @param[in] task - task to run
+     */
+    void post(uint32_t key, Task task);
+
+    /** @brief Wait until every task posted so far has run
+     */
+    void wait();
+
+    /** @brief Get the number of worker threads
+     */
+    size_t size() const
+    {
+        return workers.size();
+    }
+
+  private:
+    /** @struct Worker
+     *
+     *  Queues and thread of a worker
+     */
+    struct Worker
+    {
+        explicit Worker(size_t capacity) : shared(capacity)
+        {
+        }
+
+        TaskQueue shared;   //!< Tasks, stolen by other workers
+        std::thread thread; //!< The worker thread
+    };
+
+    /** @struct Strand
+     *
+     *  Keyed tasks waiting for the tasks posted before them with the key
+     */
+    struct Strand
+    {
+        std::deque<Task> tasks; //!< Tasks not run yet, in posting order
+    };
+
+    /** @brief Push a task to a queue and wake a sleeping worker */
+    void enqueue(TaskQueue& queue, Task& task);
+
+    /** @brief Run a task, logging what it throws, and count it as done */
+    void runTask(Task& task);
+
+    /** @brief Run the next task of a strand, and queue the strand again if
+     *         it has more */
+    void runStrand(uint32_t key);
+
+    /** @brief Run one task of a worker, stealing if it has none
+     *
+     * @return bool - true if a task was run
+     */
+    bool runOne(size_t index);
+
+    /** @brief Check if any worker has a task queued */
+    bool hasWork() const;
+
+    /** @brief Main loop of a worker thread */
+    void run(size_t index);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /** @brief worker the next unkeyed task is queued on */
+    std::atomic<size_t> nextWorker{0};
+
+    /** @brief number of tasks posted that have not run yet */
+    std::atomic<size_t> pending{0};
+
+    /** @brief number of workers waiting for work */
+    std::atomic<size_t> sleeping{0};
+
+    /** @brief key to strand, for keys with tasks waiting or running */
+    std::unordered_map<uint32_t, Strand> strands;
+
+    std::mutex strandMutex;
+
+    std::atomic<bool> stopping{false};
+
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable idle;
+};
+
+/** @brief Get the executor of the responder, with a worker per CPU
+ *
+ *  @return Executor& - Reference to instance of executor
+ */
+Executor& executor();
+
+/** @brief Get the executor DMA chunks run on, with one worker for the single
+ *         DMA engine
+ *
+ *  A chunk holds its range lock when it is posted, and the workers of
+ *  executor() may all be waiting for that lock, so chunks do not run there.
+ *
+ *  @return Executor& - Reference to instance of executor
+ */
+Executor& dmaExecutor();
+
+} // namespace responder
+} // namespace pldm
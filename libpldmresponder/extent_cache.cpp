@@ -0,0 +1,145 @@
+#include "extent_cache.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace
+{
+
+// Number of files whose extent maps are kept
+constexpr size_t extentCacheCapacity = 64;
+
+uint64_t modificationTime(const struct stat& st)
+{
+    return static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000 +
+           st.st_mtim.tv_nsec;
+}
+
+/** @brief Find the data extents of a file */
+ExtentCache::Extents mapExtents(int fd, off_t size)
+{
+    ExtentCache::Extents extents;
+    off_t position = 0;
+    while (position < size)
+    {
+        auto data = lseek(fd, position, SEEK_DATA);
+        if (data < 0)
+        {
+            // ENXIO: only a hole is left. Other errors: no hole support.
+            if (errno != ENXIO)
+            {
+                extents = {{0, static_cast<uint64_t>(size)}};
+            }
+            break;
+        }
+        auto hole = lseek(fd, data, SEEK_HOLE);
+        if (hole < 0 || hole > size)
+        {
+            hole = size;
+        }
+        extents.push_back(
+            {static_cast<uint64_t>(data), static_cast<uint64_t>(hole - data)});
+        position = hole;
+    }
+    return extents;
+}
+
+} // namespace
+
+std::shared_ptr<const ExtentCache::Extents>
+    ExtentCache::lookup(int fd, const fs::path& path, const struct stat& st)
+{
+    std::string key = path.string();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto iter = entries.find(key);
+        if (iter != entries.end() && iter->second.inode == st.st_ino &&
+            iter->second.size == st.st_size &&
+            iter->second.mtime == modificationTime(st))
+        {
+            iter->second.lastUse = ++accessCount;
+            return iter->second.extents;
+        }
+    }
+
+    // Map the file without the lock held, a racing lookup maps it as well
+    auto extents = std::make_shared<const Extents>(mapExtents(fd, st.st_size));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!entries.count(key) && entries.size() >= capacity)
+    {
+        auto oldest = std::min_element(
+            entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+                return a.second.lastUse < b.second.lastUse;
+            });
+        entries.erase(oldest);
+    }
+    auto& entry = entries[key];
+    entry.extents = extents;
+    entry.inode = st.st_ino;
+    entry.size = st.st_size;
+    entry.mtime = modificationTime(st);
+    entry.lastUse = ++accessCount;
+    return extents;
+}
+
+ExtentCache& extentCache()
+{
+    static ExtentCache cache(extentCacheCapacity);
+    return cache;
+}
+
+ssize_t readSparse(int fd, const fs::path& path, uint64_t offset,
+                   uint32_t length, char* buffer)
+{
+    struct stat st
+    {
+    };
+    if (fstat(fd, &st) < 0)
+    {
+        return -errno;
+    }
+    auto size = static_cast<uint64_t>(st.st_size);
+    if (offset >= size)
+    {
+        return 0;
+    }
+    auto end = std::min(offset + length, size);
+
+    auto extents = extentCache().lookup(fd, path, st);
+    for (const auto& extent : *extents)
+    {
+        auto start = std::max(extent.offset, offset);
+        auto stop = std::min(extent.offset + extent.length, end);
+        while (start < stop)
+        {
+            auto rc = pread(fd, buffer + (start - offset), stop - start, start);
+            if (rc < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (rc < 0)
+            {
+                return -errno;
+            }
+            if (rc == 0)
+            {
+                // The file shrank since it was mapped
+                return start - offset;
+            }
+            start += rc;
+        }
+    }
+    return end - offset;
+}
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace fs = std::filesystem;
+
+/** @struct Extent
+ *
+ *  A range of a file that holds data, as opposed to a hole
+ */
+struct Extent
+{
+    uint64_t offset = 0; //!< Offset of the first byte
+    uint64_t length = 0; //!< Number of bytes
+};
+
+/** @class ExtentCache
+ *
+ *  ExtentCache keeps the data extents of files, found with
+ *  lseek(SEEK_DATA/SEEK_HOLE), so that reads of sparse files such as NVRAM
+ *  and dump images only read the data and fill the holes with zeroes. The
+ *  map of a file is validated against its inode, size and modification time
+ *  on access, so changes made by other writers are picked up. On file
+ *  systems without hole support the whole file is one extent.
+ */
+class ExtentCache
+{
+  public:
+    using Extents = std::vector<Extent>;
+
+    /** @brief Create the extent cache
+     *
+     * @param[in] capacity - number of files whose maps are kept
+     */
+    explicit ExtentCache(size_t capacity) : capacity(capacity)
+    {
+    }
+
+    ExtentCache() = delete;
+    ~ExtentCache() = default;
+    ExtentCache(const ExtentCache&) = delete;
+    ExtentCache& operator=(const ExtentCache&) = delete;
+
+    /** @brief Get the data extents of a file, mapping them if needed
+     *
+     * @param[in] fd - the file, open for reading
+     * @param[in] path - pathname of the file
+     * @param[in] st - status of the file
+     *
+     * @return the data extents in file order
+     */
+    std::shared_ptr<const Extents> lookup(int fd, const fs::path& path,
+                                          const struct stat& st);
+
+    /** @brief Drop the map of a file
+     *
+     *  Called after the responder writes the file, the write may fill a hole
+     *  without changing the size or, within the timestamp granularity, the
+     *  modification time of the file.
+     *
+     * @param[in] path - pathname of the file
+     */
+    void invalidate(const fs::path& path)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.erase(path.string());
+    }
+
+    /** @brief Drop all the maps
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+    }
+
+  private:
+    /** @struct Entry
+     *
+     *  Map of a file and the state of the file it was taken from
+     */
+    struct Entry
+    {
+        std::shared_ptr<const Extents> extents; //!< Data extents
+        ino_t inode = 0;                        //!< Inode number
+        off_t size = 0;                         //!< Size in bytes
+        uint64_t mtime = 0;                     //!< Modification time in ns
+        uint64_t lastUse = 0; //!< Access counter value at last use
+    };
+
+    /** @brief number of files whose maps are kept */
+    size_t capacity;
+
+    /** @brief incremented on every access, to find the least recently used
+     *         entry */
+    uint64_t accessCount = 0;
+
+    /** @brief file pathname to the map of the file */
+    std::unordered_map<std::string, Entry> entries;
+
+    std::mutex mutex;
+};
+
+/** @brief Get the extent cache of the responder
+ *
+ *  @return ExtentCache& - Reference to instance of extent cache
+ */
+ExtentCache& extentCache();
+
+/** @brief Read a range of a file, reading only its data extents
+ *
+ *  The parts of the buffer over holes are left alone, so the buffer is
+ *  expected to be zeroed.
+ *
+ *  @param[in] fd - the file, open for reading
+ *  @param[in] path - pathname of the file
+ *  @param[in] offset - offset in the file
+ *  @param[in] length - number of bytes to read
+ *  @param[out] buffer - zeroed buffer of at least length bytes
+ *
+ *  @return number of bytes of the range within the file, holes included,
+ *          or negative errno on failure
+ */
+ssize_t readSparse(int fd, const fs::path& path, uint64_t offset,
+                   uint32_t length, char* buffer);
+
+} // namespace responder
+} // namespace pldm
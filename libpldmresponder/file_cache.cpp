@@ -0,0 +1,197 @@
+#include "file_cache.hpp"
+
+#include "file_io.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+namespace pldm
+{
+
+namespace filetable
+{
+
+using namespace pldm::responder;
+
+namespace
+{
+
+// Files up to this size are cached
+constexpr size_t cacheMaxFileSize = 64 * 1024;
+
+// Total number of bytes cached across files
+constexpr size_t cacheCapacity = 1024 * 1024;
+
+uint64_t modificationTime(const struct stat& st)
+{
+    return static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000 +
+           st.st_mtim.tv_nsec;
+}
+
+} // namespace
+
+std::shared_ptr<const std::vector<uint8_t>>
+    FileCache::lookup(Handle handle, const fs::path& path)
+{
+    struct stat st
+    {
+    };
+    bool found = stat(path.c_str(), &st) == 0;
+    size_t size = static_cast<size_t>(st.st_size);
+    bool cacheable = found && size <= maxFileSize && size <= capacity;
+
+    uint64_t writes = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto iter = entries.find(handle);
+        if (cacheable && iter != entries.end() &&
+            iter->second.mtime == modificationTime(st) &&
+            iter->second.data->size() == size)
+        {
+            iter->second.lastUse = ++accessCount;
+            return iter->second.data;
+        }
+        erase(handle);
+        writes = writeCount;
+    }
+    if (!cacheable)
+    {
+        return nullptr;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    utils::CustomFD file(fd);
+
+    auto data = std::make_shared<std::vector<uint8_t>>(size);
+    size_t count = 0;
+    while (count < size)
+    {
+        auto rc = pread(file(), data->data() + count, size - count, count);
+        if (rc <= 0)
+        {
+            return nullptr;
+        }
+        count += rc;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (writeCount != writes)
+    {
+        return nullptr;
+    }
+    erase(handle);
+    makeRoom(size);
+    auto& entry = entries[handle];
+    entry.data = std::move(data);
+    entry.mtime = modificationTime(st);
+    entry.lastUse = ++accessCount;
+    cachedBytes += size;
+    return entry.data;
+}
+
+void FileCache::makeRoom(size_t size)
+{
+    while (!entries.empty() && cachedBytes + size > capacity)
+    {
+        auto oldest = std::min_element(
+            entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+                return a.second.lastUse < b.second.lastUse;
+            });
+        erase(oldest->first);
+    }
+}
+
+ssize_t FileCache::read(Handle handle, const fs::path& path, uint32_t offset,
+                        uint32_t length, uint8_t* buffer)
+{
+    auto data = lookup(handle, path);
+    if (data)
+    {
+        if (offset >= data->size())
+        {
+            return 0;
+        }
+        size_t count = std::min<size_t>(length, data->size() - offset);
+        std::copy_n(data->begin() + offset, count, buffer);
+        return count;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+    utils::CustomFD file(fd);
+
+    auto rc = pread(file(), buffer, length, offset);
+    return (rc < 0) ? -errno : rc;
+}
+
+ssize_t FileCache::write(Handle handle, const fs::path& path, uint32_t offset,
+                         uint32_t length, const uint8_t* data)
+{
+    int fd = open(path.c_str(), O_WRONLY);
+    if (fd < 0)
+    {
+        auto rc = -errno;
+        invalidate(handle);
+        return rc;
+    }
+    utils::CustomFD file(fd);
+
+    size_t count = 0;
+    ssize_t rc = 0;
+    while (count < length)
+    {
+        rc = pwrite(file(), data + count, length - count, offset + count);
+        if (rc < 0)
+        {
+            rc = -errno;
+            break;
+        }
+        count += rc;
+    }
+
+    struct stat st
+    {
+    };
+    bool sized = rc >= 0 && fstat(file(), &st) == 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ++writeCount;
+    auto iter = entries.find(handle);
+    if (iter == entries.end())
+    {
+        return rc < 0 ? rc : static_cast<ssize_t>(length);
+    }
+
+    // Replace the cached copy with one that has the write if the write did
+    // not change the size of the file, otherwise the next read reloads it
+    auto& entry = iter->second;
+    if (!sized || static_cast<size_t>(st.st_size) != entry.data->size())
+    {
+        erase(handle);
+        return rc < 0 ? rc : static_cast<ssize_t>(length);
+    }
+    auto copy = std::make_shared<std::vector<uint8_t>>(*entry.data);
+    std::copy_n(data, length, copy->begin() + offset);
+    entry.data = std::move(copy);
+    entry.mtime = modificationTime(st);
+    return length;
+}
+
+FileCache& fileCache()
+{
+    static FileCache cache(cacheMaxFileSize, cacheCapacity);
+    return cache;
+}
+
+} // namespace filetable
+} // namespace pldm
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "file_table.hpp"
+
+namespace pldm
+{
+
+namespace filetable
+{
+
+/** @class FileCache
+ *
+ *  FileCache keeps the contents of small files in memory, so that the inline
+ *  ReadFile command is answered without touching storage. Each cached copy is
+ *  validated against the size and modification time of the file on access, so
+ *  changes made by other writers are picked up. Writes through the cache go
+ *  to the file and update the cached copy. Files larger than the per-file
+ *  limit are read and written directly. The lock only guards the map of
+ *  cached copies: files are checked and read without it, and a cached copy
+ *  is replaced rather than changed in place, so that readers copy from it
+ *  unlocked. A copy loaded while the responder wrote a file is not kept, it
+ *  may hold part of the write.
+ */
+class FileCache
+{
+  public:
+    /** @brief Create the file cache
+     *
+     * @param[in] maxFileSize - largest file that is cached, in bytes
+     * @param[in] capacity - total number of bytes cached across files
+     */
+    FileCache(size_t maxFileSize, size_t capacity) :
+        maxFileSize(maxFileSize), capacity(capacity)
+    {
+    }
+
+    FileCache() = delete;
+    ~FileCache() = default;
+    FileCache(const FileCache&) = delete;
+    FileCache& operator=(const FileCache&) = delete;
+
+    /** @brief Read data from a file
+     *
+     * @param[in] handle - file handle
+     * @param[in] path - pathname of the file
+     * @param[in] offset - offset in the file
+     * @param[in] length - number of bytes to read
+     * @param[out] buffer - buffer of at least length bytes
+     *
+     * @return number of bytes read on success, negative errno on failure
+     */
+    ssize_t read(Handle handle, const fs::path& path, uint32_t offset,
+                 uint32_t length, uint8_t* buffer);
+
+    /** @brief Write data to a file
+     *
+     * @param[in] handle - file handle
+     * @param[in] path - pathname of the file
+     * @param[in] offset - offset in the file
+     * @param[in] length - number of bytes to write
+     * @param[in] data - data to write
+     *
+     * @return number of bytes written on success, negative errno on failure
+     */
+    ssize_t write(Handle handle, const fs::path& path, uint32_t offset,
+                  uint32_t length, const uint8_t* data);
+
+    /** @brief Drop the cached copy of a file, for writers that bypass the
+     *         cache
+     *
+     * @param[in] handle - file handle
+     */
+    void invalidate(Handle handle)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        erase(handle);
+    }
+
+    /** @brief Drop all the cached copies
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        cachedBytes = 0;
+    }
+
+  private:
+    /** @struct Entry
+     *
+     *  Cached copy of a file and the state of the file it was taken from
+     */
+    struct Entry
+    {
+        std::shared_ptr<const std::vector<uint8_t>> data; //!< Contents
+        uint64_t mtime = 0;   //!< Modification time in ns
+        uint64_t lastUse = 0; //!< Access counter value at last use
+    };
+
+    /** @brief Get the up to date cached copy of a file, loading it if needed,
+     *         without the lock held
+     *
+     * @param[in] handle - file handle
+     * @param[in] path - pathname of the file
+     *
+     * @return pointer to the cached copy, or nullptr if the file is not
+     *         cacheable
+     */
+    std::shared_ptr<const std::vector<uint8_t>> lookup(Handle handle,
+                                                      const fs::path& path);
+
+    /** @brief Drop the cached copy of a file, with the lock held */
+    void erase(Handle handle)
+    {
+        auto iter = entries.find(handle);
+        if (iter != entries.end())
+        {
+            cachedBytes -= iter->second.data->size();
+            entries.erase(iter);
+        }
+    }
+
+    /** @brief Evict the least recently used entries until size more bytes
+     *         fit within the capacity
+     */
+    void makeRoom(size_t size);
+
+    /** @brief largest file that is cached, in bytes */
+    size_t maxFileSize;
+
+    /** @brief total number of bytes cached across files */
+    size_t capacity;
+
+    /** @brief number of bytes currently cached */
+    size_t cachedBytes = 0;
+
+    /** @brief incremented on every access, to find the least recently used
+     *         entry */
+    uint64_t accessCount = 0;
+
+    /** @brief incremented on every write, to find copies loaded while the
+     *         responder wrote a file */
+    uint64_t writeCount = 0;
+
+    /** @brief handle to cached copy of the file */
+    std::unordered_map<Handle, Entry> entries;
+
+    std::mutex mutex;
+};
+
+/** @brief Get the file cache of the responder
+ *
+ *  @return FileCache& - Reference to instance of file cache
+ */
+FileCache& fileCache();
+
+} // namespace filetable
+} // namespace pldm
@@ -0,0 +1,275 @@
+#include "file_digest.hpp"
+
+#include "crc32.hpp"
+#include "file_io.hpp"
+
+#include <endian.h>
+#include <fcntl.h>
+#include <openssl/evp.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+
+namespace pldm
+{
+
+namespace filetable
+{
+
+using namespace pldm::responder;
+
+namespace
+{
+
+uint64_t modificationTime(const struct stat& st)
+{
+    return static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000 +
+           st.st_mtim.tv_nsec;
+}
+
+size_t blockCount(uint32_t size)
+{
+    return (size + digestBlockSize - 1) / digestBlockSize;
+}
+
+/** @brief Read all of a range of a file */
+int readAll(int fd, char* buffer, size_t length, uint64_t offset)
+{
+    size_t count = 0;
+    while (count < length)
+    {
+        auto rc = pread(fd, buffer + count, length - count, offset + count);
+        if (rc < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (rc < 0)
+        {
+            return -errno;
+        }
+        if (rc == 0)
+        {
+            // The file shrank while it was read
+            return -EIO;
+        }
+        count += rc;
+    }
+    return 0;
+}
+
+} // namespace
+
+int DigestCache::digest(Handle handle, const fs::path& path, DigestType type,
+                        uint32_t offset, uint32_t& length, Digest& digest)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+    utils::CustomFD file(fd);
+
+    struct stat st
+    {
+    };
+    if (fstat(file(), &st) < 0)
+    {
+        return -errno;
+    }
+    uint32_t size = static_cast<uint32_t>(st.st_size);
+    if (offset >= size)
+    {
+        return -ERANGE;
+    }
+    length = std::min(length, size - offset);
+    uint32_t end = offset + length;
+
+    if (type == DigestType::SHA256)
+    {
+        return sha256(file(), offset, end, digest);
+    }
+
+    uint32_t value = 0;
+    auto rc = crc(handle, path, file(), st, offset, end, value);
+    if (rc < 0)
+    {
+        return rc;
+    }
+    value = htole32(value);
+    auto bytes = reinterpret_cast<const uint8_t*>(&value);
+    digest.assign(bytes, bytes + sizeof(value));
+    return 0;
+}
+
+int DigestCache::crc(Handle handle, const fs::path& path, int fd,
+                     const struct stat& st, uint32_t offset, uint32_t end,
+                     uint32_t& crc)
+{
+    uint32_t size = static_cast<uint32_t>(st.st_size);
+    size_t first = offset / digestBlockSize;
+    size_t last = (end - 1) / digestBlockSize;
+
+    // Take the CRCs of the blocks of the range that are current
+    std::vector<Block> blocks;
+    uint64_t version = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& entry = entries[handle];
+        if (entry.path != path || entry.inode != st.st_ino ||
+            entry.size != size || entry.mtime != modificationTime(st))
+        {
+            entry.path = path;
+            entry.inode = st.st_ino;
+            entry.size = size;
+            entry.mtime = modificationTime(st);
+            entry.blocks.assign(blockCount(size), {});
+            entry.version = ++versions;
+        }
+        blocks.assign(entry.blocks.begin() + first,
+                      entry.blocks.begin() + last + 1);
+        version = entry.version;
+    }
+
+    // Read the rest without the lock held
+    std::vector<char> buffer(digestBlockSize);
+    uint64_t bytes = 0;
+    for (size_t i = first; i <= last; ++i)
+    {
+        uint32_t blockStart = i * digestBlockSize;
+        uint32_t blockEnd = std::min(blockStart + digestBlockSize, size);
+        uint32_t pieceStart = std::max(blockStart, offset);
+        uint32_t pieceEnd = std::min(blockEnd, end);
+        uint32_t pieceLength = pieceEnd - pieceStart;
+
+        // Only whole blocks are cached, the first and last pieces of the
+        // range may be shorter
+        auto& block = blocks[i - first];
+        bool whole = pieceStart == blockStart && pieceEnd == blockEnd;
+        Block piece = whole ? block : Block{};
+        if (!piece.valid)
+        {
+            auto rc = readAll(fd, buffer.data(), pieceLength, pieceStart);
+            if (rc < 0)
+            {
+                return rc;
+            }
+            bytes += pieceLength;
+            piece.crc = crc32::compute(buffer.data(), pieceLength);
+            piece.valid = true;
+            if (whole)
+            {
+                block = piece;
+            }
+        }
+        crc = (pieceStart == offset)
+                  ? piece.crc
+                  : crc32::combine(crc, piece.crc, pieceLength);
+    }
+
+    // Store the CRCs unless the blocks were dropped while the file was read
+    std::lock_guard<std::mutex> lock(mutex);
+    hashed += bytes;
+    auto iter = entries.find(handle);
+    if (iter != entries.end() && iter->second.version == version)
+    {
+        std::copy(blocks.begin(), blocks.end(),
+                  iter->second.blocks.begin() + first);
+    }
+    return 0;
+}
+
+int DigestCache::sha256(int fd, uint32_t offset, uint32_t end,
+                        Digest& digest)
+{
+    std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> context(
+        EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    if (!context || !EVP_DigestInit_ex(context.get(), EVP_sha256(), nullptr))
+    {
+        return -ENOMEM;
+    }
+
+    std::vector<char> buffer(digestBlockSize);
+    for (uint32_t start = offset; start < end;)
+    {
+        uint32_t count = std::min<uint32_t>(digestBlockSize, end - start);
+        auto rc = readAll(fd, buffer.data(), count, start);
+        if (rc < 0)
+        {
+            return rc;
+        }
+        if (!EVP_DigestUpdate(context.get(), buffer.data(), count))
+        {
+            return -EINVAL;
+        }
+        start += count;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        hashed += end - offset;
+    }
+
+    digest.resize(maxDigestLength);
+    if (!EVP_DigestFinal_ex(context.get(), digest.data(), nullptr))
+    {
+        return -EINVAL;
+    }
+    return 0;
+}
+
+void DigestCache::invalidate(Handle handle, const fs::path& path,
+                             uint32_t offset, uint32_t length)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = entries.find(handle);
+    if (iter == entries.end())
+    {
+        return;
+    }
+
+    auto& entry = iter->second;
+    struct stat st
+    {
+    };
+    if (entry.path != path || stat(path.c_str(), &st) < 0 ||
+        entry.inode != st.st_ino)
+    {
+        entries.erase(iter);
+        return;
+    }
+
+    // The last block grows or shrinks with the file, and CRCs computed
+    // while the file was written are stale
+    entry.version = ++versions;
+    uint32_t size = static_cast<uint32_t>(st.st_size);
+    if (size != entry.size && !entry.blocks.empty())
+    {
+        entry.blocks.back() = {};
+    }
+    entry.blocks.resize(blockCount(size));
+
+    if (length)
+    {
+        for (size_t i = offset / digestBlockSize;
+             i <= (offset + length - 1) / digestBlockSize &&
+             i < entry.blocks.size();
+             ++i)
+        {
+            entry.blocks[i] = {};
+        }
+    }
+    entry.size = size;
+    entry.mtime = modificationTime(st);
+}
+
+DigestCache& fileDigests()
+{
+    static DigestCache cache;
+    return cache;
+}
+
+} // namespace filetable
+} // namespace pldm
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "file_table.hpp"
+
+namespace pldm
+{
+
+namespace filetable
+{
+
+/** @brief Size of the blocks whose digests are cached */
+constexpr uint32_t digestBlockSize = 64 * 1024;
+
+/** @brief Largest digest, that of SHA-256 */
+constexpr size_t maxDigestLength = 32;
+
+/** @brief Digest algorithms, with the values of pldm_fileio_checksum_type */
+enum class DigestType : uint8_t
+{
+    CRC32 = 0,  //!< CRC-32 (IEEE 802.3) of the range
+    SHA256 = 1, //!< SHA-256 of the range
+};
+
+using Digest = std::vector<uint8_t>;
+
+/** @class DigestCache
+ *
+ *  DigestCache keeps the CRC-32 of each block of the files the host asks
+ *  the checksum of, so that the CRC-32 of a file is computed on the BMC
+ *  without reading more than the blocks that changed since the last
+ *  request. The CRC-32 of a range is combined from the CRCs of its blocks
+ *  and of its first and last pieces, which may be shorter. Writes by the
+ *  responder drop the CRCs of the blocks they wrote. The CRCs of a file are
+ *  dropped when its inode, size or modification time differ from the ones
+ *  they were taken with otherwise.
+ *
+ *  SHA-256 digests do not combine, so the SHA-256 of a range is computed
+ *  from all of its bytes on every request.
+ *
+ *  The lock is only held to look up and store CRCs, the file is read
+ *  without it.
+ */
+class DigestCache
+{
+  public:
+    DigestCache() = default;
+    ~DigestCache() = default;
+    DigestCache(const DigestCache&) = delete;
+    DigestCache& operator=(const DigestCache&) = delete;
+
+    /** @brief Compute the digest of a range of a file
+     *
+     * @param[in] handle - file handle
+     * @param[in] path - pathname of the file
+     * @param[in] type - digest algorithm
+     * @param[in] offset - offset in the file
+     * @param[in,out] length - number of bytes on input, clipped to the end
+     *                         of the file on output
+     * @param[out] digest - the digest
+     *
+     * @return 0 on success, -ERANGE if offset is past the end of the file,
+     *         negative errno on other failures
+     */
+    int digest(Handle handle, const fs::path& path, DigestType type,
+               uint32_t offset, uint32_t& length, Digest& digest);
+
+    /** @brief Drop the CRCs of the blocks of a file written by the
+     *         responder
+     *
+     * @param[in] handle - file handle
+     * @param[in] path - pathname of the file
+     * @param[in] offset - offset in the file
+     * @param[in] length - number of bytes written
+     */
+    void invalidate(Handle handle, const fs::path& path, uint32_t offset,
+                    uint32_t length);
+
+    /** @brief Get the number of bytes hashed since the cache was created */
+    uint64_t bytesHashed()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hashed;
+    }
+
+    /** @brief Drop all the CRCs
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+    }
+
+  private:
+    /** @struct Block
+     *
+     *  CRC of a block
+     */
+    struct Block
+    {
+        bool valid = false; //!< crc is current
+        uint32_t crc = 0;   //!< CRC-32
+    };
+
+    /** @struct Entry
+     *
+     *  CRCs of the blocks of a file and the state of the file they were
+     *  taken from
+     */
+    struct Entry
+    {
+        fs::path path;             //!< Pathname of the file
+        ino_t inode = 0;           //!< Inode number
+        uint32_t size = 0;         //!< Size in bytes
+        uint64_t mtime = 0;        //!< Modification time in ns
+        uint64_t version = 0;      //!< Changed when blocks are dropped
+        std::vector<Block> blocks; //!< CRC of each block
+    };
+
+    /** @brief Compute the CRC-32 of a range of a file, from the cached CRCs
+     *         of its whole blocks where they are current
+     *
+     * @param[in] handle - file handle
+     * @param[in] path - pathname of the file
+     * @param[in] fd - the file, open for reading
+     * @param[in] st - status of the file
+     * @param[in] offset - offset in the file
+     * @param[in] end - end of the range, within the file
+     * @param[out] crc - the CRC-32
+     *
+     * @return 0 on success, negative errno on failure
+     */
+    int crc(Handle handle, const fs::path& path, int fd,
+            const struct stat& st, uint32_t offset, uint32_t end,
+            uint32_t& crc);
+
+    /** @brief Compute the SHA-256 of a range of a file
+     *
+     * @param[in] fd - the file, open for reading
+     * @param[in] offset - offset in the file
+     * @param[in] end - end of the range, within the file
+     * @param[out] digest - the SHA-256
+     *
+     * @return 0 on success, negative errno on failure
+     */
+    int sha256(int fd, uint32_t offset, uint32_t end, Digest& digest);
+
+    /** @brief file handle to CRCs of the file */
+    std::unordered_map<Handle, Entry> entries;
+
+    /** @brief last version given to an entry, unique across entries so
+     *         that CRCs of an entry that was dropped are not stored */
+    uint64_t versions = 0;
+
+    /** @brief number of bytes hashed */
+    uint64_t hashed = 0;
+
+    std::mutex mutex;
+};
+
+/** @brief Get the digest cache of the responder
+ *
+ *  @return DigestCache& - Reference to instance of digest cache
+ */
+DigestCache& fileDigests();
+
+} // namespace filetable
+} // namespace pldm
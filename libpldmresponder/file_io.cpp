@@ -2,17 +2,28 @@
 
 #include "file_io.hpp"
 
+#include "block_hashes.hpp"
+#include "change_tracker.hpp"
+#include "extent_cache.hpp"
+#include "file_cache.hpp"
+#include "file_digest.hpp"
+#include "file_sizes.hpp"
+#include "file_stats.hpp"
 #include "file_table.hpp"
+#include "logging.hpp"
 
+#include <endian.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstring>
-#include <fstream>
+#include <mutex>
 #include <phosphor-logging/log.hpp>
+#include <shared_mutex>
 
 #include "libpldm/base.h"
 
@@ -44,9 +55,32 @@ struct AspeedXdmaOp
 
 constexpr auto xdmaDev = "/dev/xdma";
 
+namespace
+{
+
+DMA::Emulation& emulation()
+{
+    static DMA::Emulation function;
+    return function;
+}
+
+} // namespace
+
+void DMA::emulate(Emulation function)
+{
+    emulation() = std::move(function);
+}
+
 int DMA::transferDataHost(const fs::path& path, uint32_t offset,
                           uint32_t length, uint64_t address, bool upstream)
 {
+    PLDM_TRACE(transfer_start, path.c_str(), offset, length,
+               static_cast<int>(upstream));
+    if (auto& emulated = emulation())
+    {
+        return emulated(path, offset, length, address, upstream);
+    }
+
     static const size_t pageSize = getpagesize();
     uint32_t numPages = length / pageSize;
     uint32_t pageAlignedLength = numPages * pageSize;
@@ -66,10 +100,12 @@ int DMA::transferDataHost(const fs::path& path, uint32_t offset,
     if (fd < 0)
     {
         rc = -errno;
-        log<level::ERR>("Failed to open the XDMA device", entry("RC=%d", rc));
+        PLDM_TRACE(xdma_open, rc);
+        PLDM_LOG(ERR, "Failed to open the XDMA device", entry("RC=%d", rc));
         return rc;
     }
 
+    PLDM_TRACE(xdma_open, 0);
     utils::CustomFD xdmaFd(fd);
 
     void* vgaMem;
@@ -78,32 +114,42 @@ int DMA::transferDataHost(const fs::path& path, uint32_t offset,
     if (MAP_FAILED == vgaMem)
     {
         rc = -errno;
-        log<level::ERR>("Failed to mmap the XDMA device", entry("RC=%d", rc));
+        PLDM_TRACE(xdma_mmap, rc);
+        PLDM_LOG(ERR, "Failed to mmap the XDMA device", entry("RC=%d", rc));
         return rc;
     }
 
+    PLDM_TRACE(xdma_mmap, 0);
     std::unique_ptr<void, decltype(mmapCleanup)> vgaMemPtr(vgaMem, mmapCleanup);
 
     if (upstream)
     {
-        std::ifstream stream(path.string(), std::ios::in | std::ios::binary);
-        stream.seekg(offset);
+        int fileFd = open(path.c_str(), O_RDONLY);
+        if (fileFd < 0)
+        {
+            rc = -errno;
+            PLDM_LOG(ERR, "Failed to open file", entry("RC=%d", rc));
+            return rc;
+        }
+        utils::CustomFD file(fileFd);
 
         // Writing to the VGA memory should be aligned at page boundary,
         // otherwise write data into a buffer aligned at page boundary and
-        // then write to the VGA memory.
-        std::vector<char> buffer{};
-        buffer.resize(pageAlignedLength);
-        stream.read(buffer.data(), length);
+        // then write to the VGA memory. The buffer starts out zeroed, so only
+        // the data extents of sparse files are read and holes stay zero.
+        std::vector<char> buffer(pageAlignedLength);
+        auto count = readSparse(file(), path, offset, length, buffer.data());
+        PLDM_TRACE(file_read, path.c_str(), offset, length,
+                   static_cast<int64_t>(count));
         memcpy(static_cast<char*>(vgaMemPtr.get()), buffer.data(),
                pageAlignedLength);
+        PLDM_TRACE(xdma_copy, pageAlignedLength);
 
-        if (static_cast<uint32_t>(stream.gcount()) != length)
+        if (count != static_cast<ssize_t>(length))
         {
-            log<level::ERR>("mismatch between number of characters to read and "
-                            "the length read",
-                            entry("LENGTH=%d", length),
-                            entry("COUNT=%d", stream.gcount()));
+            PLDM_LOG(ERR, "mismatch between number of characters to read and "
+                     "the length read", entry("LENGTH=%d", length),
+                     entry("COUNT=%d", static_cast<int>(count)));
             return -1;
         }
     }
@@ -117,20 +163,37 @@ int DMA::transferDataHost(const fs::path& path, uint32_t offset,
     if (rc < 0)
     {
         rc = -errno;
-        log<level::ERR>("Failed to execute the DMA operation",
-                        entry("RC=%d", rc), entry("UPSTREAM=%d", upstream),
-                        entry("ADDRESS=%lld", address),
-                        entry("LENGTH=%d", length));
+        PLDM_TRACE(dma_submit, address, length, static_cast<int>(upstream),
+                   rc);
+        PLDM_LOG(ERR, "Failed to execute the DMA operation",
+                 entry("RC=%d", rc), entry("UPSTREAM=%d", upstream),
+                 entry("ADDRESS=%lld", address), entry("LENGTH=%d", length));
         return rc;
     }
+    PLDM_TRACE(dma_submit, address, length, static_cast<int>(upstream), 0);
 
     if (!upstream)
     {
-        std::ofstream stream(path.string(),
-                             std::ios::in | std::ios::out | std::ios::binary);
+        int fileFd = open(path.c_str(), O_RDWR);
+        if (fileFd < 0)
+        {
+            rc = -errno;
+            PLDM_LOG(ERR, "Failed to open file", entry("RC=%d", rc));
+            return rc;
+        }
+        utils::CustomFD file(fileFd);
 
-        stream.seekp(offset);
-        stream.write(static_cast<const char*>(vgaMemPtr.get()), length);
+        // Only the blocks that changed go to storage, hosts often rewrite
+        // whole images of which a few blocks differ
+        auto skipped = writeChanged(file(), path, offset, length,
+                                    static_cast<const char*>(vgaMemPtr.get()));
+        if (skipped < 0)
+        {
+            PLDM_LOG(ERR, "Failed to write file", entry("RC=%d", skipped));
+            return skipped;
+        }
+        metrics::recordDedup(length - skipped, skipped);
+        PLDM_TRACE(file_write, path.c_str(), offset, length);
     }
 
     return 0;
@@ -138,25 +201,525 @@ int DMA::transferDataHost(const fs::path& path, uint32_t offset,
 
 } // namespace dma
 
+namespace
+{
+
+// Large enough for every response except GetFileTable
+constexpr size_t initialArenaSize = 64;
+
+/** @brief Encode a response with no data past the completion code
+ *
+ *  @param[in] command - PLDM command
+ *  @param[in] completionCode - PLDM completion code
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[out] responseLength - length of the encoded response message
+ *
+ *  @return PLDM_SUCCESS
+ */
+int encodeRWError(uint8_t command, uint8_t completionCode, uint8_t* response,
+                  size_t& responseLength)
+{
+    responseLength = sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES;
+    memset(response, 0, responseLength);
+    encode_rw_file_memory_resp(0, command, completionCode, 0,
+                               reinterpret_cast<pldm_msg*>(response));
+    return PLDM_SUCCESS;
+}
+
+/** @brief Encode a GetFileTable response with no table data
+ *
+ *  @param[in] completionCode - PLDM completion code
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[out] responseLength - length of the encoded response message
+ *
+ *  @return PLDM_SUCCESS
+ */
+int encodeFileTableError(uint8_t completionCode, uint8_t* response,
+                         size_t& responseLength)
+{
+    responseLength = sizeof(pldm_msg_hdr) + PLDM_GET_FILE_TABLE_MIN_RESP_BYTES;
+    memset(response, 0, responseLength);
+    encode_get_file_table_resp(0, completionCode, 0, 0, nullptr, 0,
+                               reinterpret_cast<pldm_msg*>(response));
+    return PLDM_SUCCESS;
+}
+
+Response toResponse(EncodeHandler handler, const uint8_t* request,
+                    size_t payloadLength)
+{
+    auto [data, length] = encodeResponse(handler, request, payloadLength);
+    return Response(data, data + length);
+}
+
+/** @struct TransferRequest
+ *
+ *  A validated ReadFileIntoMemory or WriteFileFromMemory request
+ */
+struct TransferRequest
+{
+    uint32_t fileHandle = 0; //!< File handle
+    fs::path path;           //!< Pathname of the file
+    uint32_t offset = 0;     //!< Offset in the file
+    uint32_t length = 0;     //!< Length of the data to transfer
+    uint64_t address = 0;    //!< DMA address on the host
+};
+
+/** @brief Decode and validate a ReadFileIntoMemory or WriteFileFromMemory
+ *         request
+ *
+ *  The length of a read is clipped to the end of the file.
+ *
+ *  @param[in] command - PLDM command
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[out] transfer - the transfer to run
+ *  @param[out] response - buffer the error response is encoded into, of at
+ *                         least the size of the response
+ *  @param[out] responseLength - length of the encoded error response
+ *
+ *  @return bool - true if the transfer is to be run, false if the request was
+ *                 rejected and the error response encoded
+ */
+bool prepareTransfer(uint8_t command, const uint8_t* request,
+                     size_t payloadLength, TransferRequest& transfer,
+                     uint8_t* response, size_t& responseLength)
+{
+    bool upstream = (command == PLDM_READ_FILE_INTO_MEMORY);
+
+    if (payloadLength != PLDM_RW_FILE_MEM_REQ_BYTES)
+    {
+        encodeRWError(command, PLDM_ERROR_INVALID_LENGTH, response,
+                      responseLength);
+        return false;
+    }
+
+    decode_rw_file_memory_req(request, payloadLength, &transfer.fileHandle,
+                              &transfer.offset, &transfer.length,
+                              &transfer.address);
+
+    if (!upstream && transfer.length % dma::minSize)
+    {
+        PLDM_LOG(ERR, "Write length is not a multiple of DMA minSize",
+                 entry("LENGTH=%d", transfer.length));
+        encodeRWError(command, PLDM_INVALID_WRITE_LENGTH, response,
+                      responseLength);
+        return false;
+    }
+
+    using namespace pldm::filetable;
+    auto& table = buildFileTable(FILE_TABLE_JSON);
+
+    try
+    {
+        std::shared_lock<std::shared_mutex> lock(fileTableMutex());
+        transfer.path = table.at(transfer.fileHandle).fsPath;
+    }
+    catch (std::exception& e)
+    {
+        PLDM_LOG(ERR, "File handle does not exist in the file table",
+                 entry("HANDLE=%d", transfer.fileHandle));
+        encodeRWError(command, PLDM_INVALID_FILE_HANDLE, response,
+                      responseLength);
+        return false;
+    }
+
+    if (!fs::exists(transfer.path))
+    {
+        PLDM_LOG(ERR, "File does not exist",
+                 entry("HANDLE=%d", transfer.fileHandle));
+        encodeRWError(command, PLDM_INVALID_FILE_HANDLE, response,
+                      responseLength);
+        return false;
+    }
+
+    auto fileSize = fs::file_size(transfer.path);
+    if (transfer.offset >= fileSize)
+    {
+        PLDM_LOG(ERR, "Offset exceeds file size",
+                 entry("OFFSET=%d", transfer.offset),
+                 entry("FILE_SIZE=%d", fileSize));
+        encodeRWError(command, PLDM_DATA_OUT_OF_RANGE, response,
+                      responseLength);
+        return false;
+    }
+
+    if (upstream)
+    {
+        if (transfer.offset + transfer.length > fileSize)
+        {
+            transfer.length = fileSize - transfer.offset;
+        }
+
+        if (transfer.length % dma::minSize)
+        {
+            PLDM_LOG(ERR, "Read length is not a multiple of DMA minSize",
+                     entry("LENGTH=%d", transfer.length));
+            encodeRWError(command, PLDM_INVALID_READ_LENGTH, response,
+                          responseLength);
+            return false;
+        }
+    }
+
+    PLDM_TRACE(file_request, transfer.fileHandle, transfer.offset,
+               transfer.length, static_cast<int>(upstream));
+    return true;
+}
+
+/** @brief Bring the cached state of a file up to date after a
+ *         WriteFileFromMemory
+ *
+ *  @param[in] transfer - the write request
+ *  @param[in] response - the response message of the write
+ */
+void finishWrite(const TransferRequest& transfer, const uint8_t* response)
+{
+    using namespace pldm::filetable;
+    fileCache().invalidate(transfer.fileHandle);
+
+    // Keep the cached metadata of the file in sync with its new contents,
+    // a partial transfer wrote part of them
+    auto responsePtr = reinterpret_cast<const pldm_msg*>(response);
+    if (responsePtr->payload[0] == PLDM_SUCCESS ||
+        responsePtr->payload[0] == PLDM_PARTIAL_TRANSFER)
+    {
+        uint32_t length = 0;
+        memcpy(&length, responsePtr->payload + 1, sizeof(length));
+        changeTracker().recordWrite(transfer.fileHandle, transfer.path,
+                                    transfer.offset, le32toh(length));
+        fileDigests().invalidate(transfer.fileHandle, transfer.path,
+                                 transfer.offset, le32toh(length));
+        fileSizes().invalidate(transfer.fileHandle);
+        extentCache().invalidate(transfer.path);
+
+        auto& table = buildFileTable(FILE_TABLE_JSON);
+        std::lock_guard<std::shared_mutex> lock(fileTableMutex());
+        table.invalidate(transfer.fileHandle);
+    }
+}
+
+/** @brief Account a request that reached a file in the file accounting
+ *
+ *  @param[in] fileHandle - file handle
+ *  @param[in] write - true for a write, false for a read
+ *  @param[in] response - the response message, which carries the number of
+ *                        bytes transferred after the completion code
+ *  @param[in] timer - timer started when the request was received
+ */
+void account(uint32_t fileHandle, bool write, const uint8_t* response,
+             const metrics::Timer& timer)
+{
+    auto responsePtr = reinterpret_cast<const pldm_msg*>(response);
+    uint32_t length = 0;
+    if (responsePtr->payload[0] == PLDM_SUCCESS ||
+        responsePtr->payload[0] == PLDM_PARTIAL_TRANSFER)
+    {
+        memcpy(&length, responsePtr->payload + 1, sizeof(length));
+        length = le32toh(length);
+    }
+    auto latency = timer.elapsed();
+    PLDM_TRACE(file_request_done, fileHandle, static_cast<int>(write),
+               length, static_cast<uint64_t>(latency.count()));
+    pldm::filetable::fileAccounting().record(fileHandle, write, length,
+                                             latency);
+}
+
+/** @brief Get the FollowFile id of a file, never 0, which the host sends
+ *         on its first request
+ *
+ *  @param[in] inode - inode number of the file
+ *
+ *  @return the id of the file
+ */
+uint32_t followId(ino_t inode)
+{
+    uint32_t id = static_cast<uint32_t>(inode ^ (inode >> 32));
+    return id ? id : 1;
+}
+
+} // namespace
+
+Response& responseArena()
+{
+    thread_local Response arena(initialArenaSize);
+    return arena;
+}
+
+std::pair<const uint8_t*, size_t> encodeResponse(EncodeHandler handler,
+                                                 const uint8_t* request,
+                                                 size_t payloadLength)
+{
+    auto& arena = responseArena();
+    arena.resize(arena.capacity());
+
+    for (int attempt = 0; attempt < maxEncodeAttempts; ++attempt)
+    {
+        size_t length = arena.size();
+        if (handler(request, payloadLength, arena.data(), length) !=
+            PLDM_ERROR_INVALID_LENGTH)
+        {
+            return {arena.data(), std::min(length, arena.size())};
+        }
+        arena.resize(length);
+    }
+
+    // The response kept outgrowing the arena
+    constexpr size_t errorLength = sizeof(pldm_msg_hdr) + 1;
+    arena.resize(std::max(arena.size(), errorLength));
+    memset(arena.data(), 0, errorLength);
+    arena[sizeof(pldm_msg_hdr)] = PLDM_ERROR;
+    return {arena.data(), errorLength};
+}
+
 Response readFileIntoMemory(const uint8_t* request, size_t payloadLength)
 {
+    return toResponse(readFileIntoMemory, request, payloadLength);
+}
+
+int readFileIntoMemory(const uint8_t* request, size_t payloadLength,
+                       uint8_t* response, size_t& responseLength)
+{
+    metrics::Timer timer;
+    if (responseLength < sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES)
+    {
+        responseLength = sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+
+    TransferRequest transfer{};
+    if (!prepareTransfer(PLDM_READ_FILE_INTO_MEMORY, request, payloadLength,
+                         transfer, response, responseLength))
+    {
+        return PLDM_SUCCESS;
+    }
+
+    using namespace dma;
+    DMA intf;
+    auto rc = transferAll<DMA>(&intf, PLDM_READ_FILE_INTO_MEMORY,
+                               transfer.path, transfer.offset, transfer.length,
+                               transfer.address, true, response,
+                               responseLength);
+    account(transfer.fileHandle, false, response, timer);
+    return rc;
+}
+
+void readFileIntoMemory(EventLoop& loop, const uint8_t* request,
+                        size_t payloadLength, dma::Completion done)
+{
+    metrics::Timer timer;
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES>
+        response{};
+    size_t responseLength = response.size();
+
+    TransferRequest transfer{};
+    if (!prepareTransfer(PLDM_READ_FILE_INTO_MEMORY, request, payloadLength,
+                         transfer, response.data(), responseLength))
+    {
+        done(response.data(), responseLength);
+        return;
+    }
+
+    using namespace dma;
+    auto fileHandle = transfer.fileHandle;
+    AsyncTransfer<DMA>::start(
+        loop, std::make_shared<DMA>(), PLDM_READ_FILE_INTO_MEMORY,
+        transfer.path, transfer.offset, transfer.length, transfer.address,
+        true,
+        [fileHandle, timer, done = std::move(done)](const uint8_t* response,
+                                                    size_t responseLength) {
+            account(fileHandle, false, response, timer);
+            done(response, responseLength);
+        });
+}
+
+Response writeFileFromMemory(const uint8_t* request, size_t payloadLength)
+{
+    return toResponse(writeFileFromMemory, request, payloadLength);
+}
+
+int writeFileFromMemory(const uint8_t* request, size_t payloadLength,
+                        uint8_t* response, size_t& responseLength)
+{
+    metrics::Timer timer;
+    if (responseLength < sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES)
+    {
+        responseLength = sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+
+    TransferRequest transfer{};
+    if (!prepareTransfer(PLDM_WRITE_FILE_FROM_MEMORY, request, payloadLength,
+                         transfer, response, responseLength))
+    {
+        return PLDM_SUCCESS;
+    }
+
+    using namespace dma;
+    DMA intf;
+    transferAll<DMA>(&intf, PLDM_WRITE_FILE_FROM_MEMORY, transfer.path,
+                     transfer.offset, transfer.length, transfer.address, false,
+                     response, responseLength);
+    finishWrite(transfer, response);
+    account(transfer.fileHandle, true, response, timer);
+    return PLDM_SUCCESS;
+}
+
+void writeFileFromMemory(EventLoop& loop, const uint8_t* request,
+                         size_t payloadLength, dma::Completion done)
+{
+    metrics::Timer timer;
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES>
+        response{};
+    size_t responseLength = response.size();
+
+    TransferRequest transfer{};
+    if (!prepareTransfer(PLDM_WRITE_FILE_FROM_MEMORY, request, payloadLength,
+                         transfer, response.data(), responseLength))
+    {
+        done(response.data(), responseLength);
+        return;
+    }
+
+    using namespace dma;
+    AsyncTransfer<DMA>::start(
+        loop, std::make_shared<DMA>(), PLDM_WRITE_FILE_FROM_MEMORY,
+        transfer.path, transfer.offset, transfer.length, transfer.address,
+        false,
+        [&loop, transfer, timer, done = std::move(done)](
+            const uint8_t* response, size_t responseLength) {
+            // Bring the metadata of the file up to date off the loop, after
+            // the chunks of the transfer
+            auto responseMsg =
+                std::make_shared<Response>(response, response + responseLength);
+            executor().post(transfer.fileHandle, [&loop, transfer, timer, done,
+                                                  responseMsg] {
+                finishWrite(transfer, responseMsg->data());
+                account(transfer.fileHandle, true, responseMsg->data(), timer);
+                loop.post([done, responseMsg] {
+                    done(responseMsg->data(), responseMsg->size());
+                });
+            });
+        });
+}
+
+Response getFileTable(const uint8_t* request, size_t payloadLength)
+{
+    return toResponse(getFileTable, request, payloadLength);
+}
+
+int getFileTable(const uint8_t* request, size_t payloadLength,
+                 uint8_t* response, size_t& responseLength)
+{
+    uint32_t transferHandle = 0;
+    uint8_t transferFlag = 0;
+    uint8_t tableType = 0;
+
+    constexpr size_t minResponseLength =
+        sizeof(pldm_msg_hdr) + PLDM_GET_FILE_TABLE_MIN_RESP_BYTES;
+    if (responseLength < minResponseLength)
+    {
+        responseLength = minResponseLength;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+
+    if (payloadLength != PLDM_GET_FILE_TABLE_REQ_BYTES)
+    {
+        return encodeFileTableError(PLDM_ERROR_INVALID_LENGTH, response,
+                                    responseLength);
+    }
+
+    auto rc = decode_get_file_table_req(request, payloadLength, &transferHandle,
+                                        &transferFlag, &tableType);
+    if (rc)
+    {
+        return encodeFileTableError(rc, response, responseLength);
+    }
+
+    if (tableType != PLDM_FILE_ATTRIBUTE_TABLE &&
+        tableType != PLDM_OEM_FILE_ATTRIBUTE_TABLE)
+    {
+        return encodeFileTableError(PLDM_INVALID_FILE_TABLE_TYPE, response,
+                                    responseLength);
+    }
+
+    using namespace pldm::filetable;
+    auto& table = buildFileTable(FILE_TABLE_JSON);
+
+    // Building the OEM table refreshes the file metadata, so the table is
+    // locked exclusively for both table types
+    std::lock_guard<std::shared_mutex> lock(fileTableMutex());
+    if (table.isEmpty())
+    {
+        return encodeFileTableError(PLDM_FILE_TABLE_UNAVAILABLE, response,
+                                    responseLength);
+    }
+
+    const Table* oemTable = nullptr;
+    size_t tableSize = table.size();
+    if (tableType == PLDM_OEM_FILE_ATTRIBUTE_TABLE)
+    {
+        oemTable = &table.oemTable();
+        tableSize = oemTable->size();
+    }
+
+    if (responseLength < minResponseLength + tableSize)
+    {
+        responseLength = minResponseLength + tableSize;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+    responseLength = minResponseLength + tableSize;
+
+    // Copy the table straight into the response rather than through the
+    // encoder, to avoid building an intermediate copy of it
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response);
+    auto tableData = response + minResponseLength;
+    encode_get_file_table_resp(0, PLDM_SUCCESS, 0, PLDM_START_AND_END,
+                               tableData, 0, responsePtr);
+    if (oemTable)
+    {
+        std::copy(oemTable->begin(), oemTable->end(), tableData);
+    }
+    else
+    {
+        table.copyTo(tableData);
+    }
+    return PLDM_SUCCESS;
+}
+
+Response readFile(const uint8_t* request, size_t payloadLength)
+{
+    return toResponse(readFile, request, payloadLength);
+}
+
+int readFile(const uint8_t* request, size_t payloadLength, uint8_t* response,
+             size_t& responseLength)
+{
+    metrics::Timer timer;
     uint32_t fileHandle = 0;
     uint32_t offset = 0;
     uint32_t length = 0;
-    uint64_t address = 0;
 
-    Response response((sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES), 0);
-    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
-
-    if (payloadLength != PLDM_RW_FILE_MEM_REQ_BYTES)
+    constexpr size_t minResponseLength =
+        sizeof(pldm_msg_hdr) + PLDM_READ_FILE_RESP_BYTES;
+    if (responseLength < minResponseLength)
     {
-        encode_rw_file_memory_resp(0, PLDM_READ_FILE_INTO_MEMORY,
-                                   PLDM_ERROR_INVALID_LENGTH, 0, responsePtr);
-        return response;
+        responseLength = minResponseLength;
+        return PLDM_ERROR_INVALID_LENGTH;
     }
 
-    decode_rw_file_memory_req(request, payloadLength, &fileHandle, &offset,
-                              &length, &address);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response);
+    auto encodeError = [&](uint8_t completionCode) {
+        responseLength = minResponseLength;
+        memset(response, 0, responseLength);
+        encode_read_file_resp(0, completionCode, 0, responsePtr);
+        return PLDM_SUCCESS;
+    };
+
+    auto rc = decode_read_file_req(request, payloadLength, &fileHandle,
+                                   &offset, &length);
+    if (rc)
+    {
+        return encodeError(rc);
+    }
 
     using namespace pldm::filetable;
     auto& table = buildFileTable(FILE_TABLE_JSON);
@@ -164,82 +727,91 @@ Response readFileIntoMemory(const uint8_t* request, size_t payloadLength)
 
     try
     {
+        std::shared_lock<std::shared_mutex> lock(fileTableMutex());
         value = table.at(fileHandle);
     }
     catch (std::exception& e)
     {
-        log<level::ERR>("File handle does not exist in the file table",
-                        entry("HANDLE=%d", fileHandle));
-        encode_rw_file_memory_resp(0, PLDM_READ_FILE_INTO_MEMORY,
-                                   PLDM_INVALID_FILE_HANDLE, 0, responsePtr);
-        return response;
+        PLDM_LOG(ERR, "File handle does not exist in the file table",
+                 entry("HANDLE=%d", fileHandle));
+        return encodeError(PLDM_INVALID_FILE_HANDLE);
     }
 
     if (!fs::exists(value.fsPath))
     {
-        log<level::ERR>("File does not exist", entry("HANDLE=%d", fileHandle));
-        encode_rw_file_memory_resp(0, PLDM_READ_FILE_INTO_MEMORY,
-                                   PLDM_INVALID_FILE_HANDLE, 0, responsePtr);
-        return response;
+        PLDM_LOG(ERR, "File does not exist", entry("HANDLE=%d", fileHandle));
+        return encodeError(PLDM_INVALID_FILE_HANDLE);
     }
 
     auto fileSize = fs::file_size(value.fsPath);
     if (offset >= fileSize)
     {
-        log<level::ERR>("Offset exceeds file size", entry("OFFSET=%d", offset),
-                        entry("FILE_SIZE=%d", fileSize));
-        encode_rw_file_memory_resp(0, PLDM_READ_FILE_INTO_MEMORY,
-                                   PLDM_DATA_OUT_OF_RANGE, 0, responsePtr);
-        return response;
+        PLDM_LOG(ERR, "Offset exceeds file size", entry("OFFSET=%d", offset),
+                 entry("FILE_SIZE=%d", fileSize));
+        return encodeError(PLDM_DATA_OUT_OF_RANGE);
     }
 
     if (offset + length > fileSize)
     {
         length = fileSize - offset;
     }
+    length = std::min(length, maxInlineLength);
 
-    if (length % dma::minSize)
+    if (responseLength < minResponseLength + length)
     {
-        log<level::ERR>("Read length is not a multiple of DMA minSize",
-                        entry("LENGTH=%d", length));
-        encode_rw_file_memory_resp(0, PLDM_READ_FILE_INTO_MEMORY,
-                                   PLDM_INVALID_READ_LENGTH, 0, responsePtr);
-        return response;
+        responseLength = minResponseLength + length;
+        return PLDM_ERROR_INVALID_LENGTH;
     }
 
-    using namespace dma;
-    DMA intf;
-    return transferAll<DMA>(&intf, PLDM_READ_FILE_INTO_MEMORY, value.fsPath,
-                            offset, length, address, true);
+    auto guard = rangeLocks().lock(value.fsPath, offset, length, false);
+    auto count = fileCache().read(fileHandle, value.fsPath, offset, length,
+                                  response + minResponseLength);
+    if (count < 0)
+    {
+        PLDM_LOG(ERR, "Failed to read the file",
+                 entry("HANDLE=%d", fileHandle), entry("RC=%d", count));
+        encodeError(PLDM_ERROR);
+        account(fileHandle, false, response, timer);
+        return PLDM_SUCCESS;
+    }
+
+    encode_read_file_resp(0, PLDM_SUCCESS, count, responsePtr);
+    responseLength = minResponseLength + count;
+    account(fileHandle, false, response, timer);
+    return PLDM_SUCCESS;
 }
 
-Response writeFileFromMemory(const uint8_t* request, size_t payloadLength)
+Response writeFile(const uint8_t* request, size_t payloadLength)
 {
+    return toResponse(writeFile, request, payloadLength);
+}
+
+int writeFile(const uint8_t* request, size_t payloadLength, uint8_t* response,
+              size_t& responseLength)
+{
+    metrics::Timer timer;
     uint32_t fileHandle = 0;
     uint32_t offset = 0;
     uint32_t length = 0;
-    uint64_t address = 0;
+    size_t fileDataOffset = 0;
 
-    Response response(sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES, 0);
-    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
-
-    if (payloadLength != PLDM_RW_FILE_MEM_REQ_BYTES)
+    constexpr size_t encodedLength =
+        sizeof(pldm_msg_hdr) + PLDM_WRITE_FILE_RESP_BYTES;
+    if (responseLength < encodedLength)
     {
-        encode_rw_file_memory_resp(0, PLDM_WRITE_FILE_FROM_MEMORY,
-                                   PLDM_ERROR_INVALID_LENGTH, 0, responsePtr);
-        return response;
+        responseLength = encodedLength;
+        return PLDM_ERROR_INVALID_LENGTH;
     }
+    responseLength = encodedLength;
+    memset(response, 0, responseLength);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response);
 
-    decode_rw_file_memory_req(request, payloadLength, &fileHandle, &offset,
-                              &length, &address);
-
-    if (length % dma::minSize)
+    auto rc = decode_write_file_req(request, payloadLength, &fileHandle,
+                                    &offset, &length, &fileDataOffset);
+    if (rc)
     {
-        log<level::ERR>("Write length is not a multiple of DMA minSize",
-                        entry("LENGTH=%d", length));
-        encode_rw_file_memory_resp(0, PLDM_WRITE_FILE_FROM_MEMORY,
-                                   PLDM_INVALID_WRITE_LENGTH, 0, responsePtr);
-        return response;
+        encode_write_file_resp(0, rc, 0, responsePtr);
+        return PLDM_SUCCESS;
     }
 
     using namespace pldm::filetable;
@@ -248,89 +820,371 @@ Response writeFileFromMemory(const uint8_t* request, size_t payloadLength)
 
     try
     {
+        std::shared_lock<std::shared_mutex> lock(fileTableMutex());
         value = table.at(fileHandle);
     }
     catch (std::exception& e)
     {
-        log<level::ERR>("File handle does not exist in the file table",
-                        entry("HANDLE=%d", fileHandle));
-        encode_rw_file_memory_resp(0, PLDM_WRITE_FILE_FROM_MEMORY,
-                                   PLDM_INVALID_FILE_HANDLE, 0, responsePtr);
-        return response;
+        PLDM_LOG(ERR, "File handle does not exist in the file table",
+                 entry("HANDLE=%d", fileHandle));
+        encode_write_file_resp(0, PLDM_INVALID_FILE_HANDLE, 0, responsePtr);
+        return PLDM_SUCCESS;
     }
 
     if (!fs::exists(value.fsPath))
     {
-        log<level::ERR>("File does not exist", entry("HANDLE=%d", fileHandle));
-        encode_rw_file_memory_resp(0, PLDM_WRITE_FILE_FROM_MEMORY,
-                                   PLDM_INVALID_FILE_HANDLE, 0, responsePtr);
-        return response;
+        PLDM_LOG(ERR, "File does not exist", entry("HANDLE=%d", fileHandle));
+        encode_write_file_resp(0, PLDM_INVALID_FILE_HANDLE, 0, responsePtr);
+        return PLDM_SUCCESS;
     }
 
     auto fileSize = fs::file_size(value.fsPath);
     if (offset >= fileSize)
     {
-        log<level::ERR>("Offset exceeds file size", entry("OFFSET=%d", offset),
-                        entry("FILE_SIZE=%d", fileSize));
-        encode_rw_file_memory_resp(0, PLDM_WRITE_FILE_FROM_MEMORY,
-                                   PLDM_DATA_OUT_OF_RANGE, 0, responsePtr);
-        return response;
+        PLDM_LOG(ERR, "Offset exceeds file size", entry("OFFSET=%d", offset),
+                 entry("FILE_SIZE=%d", fileSize));
+        encode_write_file_resp(0, PLDM_DATA_OUT_OF_RANGE, 0, responsePtr);
+        return PLDM_SUCCESS;
     }
 
-    using namespace dma;
-    DMA intf;
-    return transferAll<DMA>(&intf, PLDM_WRITE_FILE_FROM_MEMORY, value.fsPath,
-                            offset, length, address, false);
+    auto count = [&] {
+        auto guard = rangeLocks().lock(value.fsPath, offset, length, true);
+        return fileCache().write(fileHandle, value.fsPath, offset, length,
+                                 request + fileDataOffset);
+    }();
+    if (count < 0)
+    {
+        PLDM_LOG(ERR, "Failed to write the file",
+                 entry("HANDLE=%d", fileHandle), entry("RC=%d", count));
+        encode_write_file_resp(0, PLDM_ERROR, 0, responsePtr);
+        account(fileHandle, true, response, timer);
+        return PLDM_SUCCESS;
+    }
+
+    changeTracker().recordWrite(fileHandle, value.fsPath, offset, count);
+    fileDigests().invalidate(fileHandle, value.fsPath, offset, count);
+    fileSizes().invalidate(fileHandle);
+    {
+        std::lock_guard<std::shared_mutex> lock(fileTableMutex());
+        table.invalidate(fileHandle);
+    }
+    encode_write_file_resp(0, PLDM_SUCCESS, count, responsePtr);
+    account(fileHandle, true, response, timer);
+    return PLDM_SUCCESS;
 }
 
-Response getFileTable(const uint8_t* request, size_t payloadLength)
+Response getChangedBlocks(const uint8_t* request, size_t payloadLength)
 {
-    uint32_t transferHandle = 0;
-    uint8_t transferFlag = 0;
-    uint8_t tableType = 0;
+    return toResponse(getChangedBlocks, request, payloadLength);
+}
 
-    Response response(sizeof(pldm_msg_hdr) +
-                      PLDM_GET_FILE_TABLE_MIN_RESP_BYTES);
-    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+int getChangedBlocks(const uint8_t* request, size_t payloadLength,
+                     uint8_t* response, size_t& responseLength)
+{
+    uint32_t fileHandle = 0;
+    uint32_t offset = 0;
+    uint64_t generation = 0;
 
-    if (payloadLength != PLDM_GET_FILE_TABLE_REQ_BYTES)
+    constexpr size_t minResponseLength =
+        sizeof(pldm_msg_hdr) + PLDM_GET_CHANGED_BLOCKS_MIN_RESP_BYTES;
+    constexpr size_t maxResponseLength =
+        minResponseLength + maxChangedRanges * sizeof(pldm_changed_range);
+    if (responseLength < maxResponseLength)
     {
-        encode_get_file_table_resp(0, PLDM_ERROR_INVALID_LENGTH, 0, 0, nullptr,
-                                   0, responsePtr);
-        return response;
+        responseLength = maxResponseLength;
+        return PLDM_ERROR_INVALID_LENGTH;
     }
 
-    auto rc = decode_get_file_table_req(request, payloadLength, &transferHandle,
-                                        &transferFlag, &tableType);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response);
+    auto encodeError = [&](uint8_t completionCode) {
+        responseLength = sizeof(pldm_msg_hdr) + 1;
+        memset(response, 0, responseLength);
+        encode_get_changed_blocks_resp(0, completionCode, 0, 0, 0, nullptr, 0,
+                                       responsePtr);
+        return PLDM_SUCCESS;
+    };
+
+    auto rc = decode_get_changed_blocks_req(request, payloadLength,
+                                            &fileHandle, &offset, &generation);
     if (rc)
     {
-        encode_get_file_table_resp(0, rc, 0, 0, nullptr, 0, responsePtr);
-        return response;
+        return encodeError(rc);
+    }
+
+    using namespace pldm::filetable;
+    auto& table = buildFileTable(FILE_TABLE_JSON);
+    fs::path path;
+
+    try
+    {
+        std::shared_lock<std::shared_mutex> lock(fileTableMutex());
+        path = table.at(fileHandle).fsPath;
+    }
+    catch (std::exception& e)
+    {
+        PLDM_LOG(ERR, "File handle does not exist in the file table",
+                 entry("HANDLE=%d", fileHandle));
+        return encodeError(PLDM_INVALID_FILE_HANDLE);
     }
 
-    if (tableType != PLDM_FILE_ATTRIBUTE_TABLE)
+    Changes changes{};
+    rc = changeTracker().changes(fileHandle, path, generation, offset,
+                                 maxChangedRanges, changes);
+    if (rc == -ENOENT)
+    {
+        PLDM_LOG(ERR, "File does not exist", entry("HANDLE=%d", fileHandle));
+        return encodeError(PLDM_INVALID_FILE_HANDLE);
+    }
+    if (rc < 0)
     {
-        encode_get_file_table_resp(0, PLDM_INVALID_FILE_TABLE_TYPE, 0, 0,
-                                   nullptr, 0, responsePtr);
-        return response;
+        PLDM_LOG(ERR, "Failed to get the changes of the file",
+                 entry("HANDLE=%d", fileHandle), entry("RC=%d", rc));
+        return encodeError(PLDM_ERROR);
+    }
+
+    // ChangedRange has the layout of pldm_changed_range in host byte order
+    static_assert(sizeof(ChangedRange) == sizeof(pldm_changed_range));
+    responseLength = minResponseLength +
+                     changes.ranges.size() * sizeof(pldm_changed_range);
+    encode_get_changed_blocks_resp(
+        0, PLDM_SUCCESS, changes.generation, changes.fileSize,
+        changes.nextOffset,
+        reinterpret_cast<const pldm_changed_range*>(changes.ranges.data()),
+        changes.ranges.size(), responsePtr);
+    return PLDM_SUCCESS;
+}
+
+Response getFileChecksum(const uint8_t* request, size_t payloadLength)
+{
+    return toResponse(getFileChecksum, request, payloadLength);
+}
+
+int getFileChecksum(const uint8_t* request, size_t payloadLength,
+                    uint8_t* response, size_t& responseLength)
+{
+    uint32_t fileHandle = 0;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    uint8_t checksumType = 0;
+
+    constexpr size_t minResponseLength =
+        sizeof(pldm_msg_hdr) + PLDM_GET_FILE_CHECKSUM_MIN_RESP_BYTES;
+    constexpr size_t maxResponseLength =
+        minResponseLength + PLDM_GET_FILE_CHECKSUM_MAX_DIGEST_BYTES;
+    if (responseLength < maxResponseLength)
+    {
+        responseLength = maxResponseLength;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response);
+    auto encodeError = [&](uint8_t completionCode) {
+        responseLength = sizeof(pldm_msg_hdr) + 1;
+        memset(response, 0, responseLength);
+        encode_get_file_checksum_resp(0, completionCode, 0, nullptr, 0,
+                                      responsePtr);
+        return PLDM_SUCCESS;
+    };
+
+    auto rc = decode_get_file_checksum_req(request, payloadLength, &fileHandle,
+                                           &offset, &length, &checksumType);
+    if (rc)
+    {
+        return encodeError(rc);
+    }
+    if (checksumType != PLDM_CHECKSUM_CRC32 &&
+        checksumType != PLDM_CHECKSUM_SHA256)
+    {
+        PLDM_LOG(ERR, "Checksum type is not supported",
+                 entry("TYPE=%d", checksumType));
+        return encodeError(PLDM_INVALID_CHECKSUM_TYPE);
     }
 
     using namespace pldm::filetable;
-    auto table = buildFileTable(FILE_TABLE_JSON);
-    auto attrTable = table();
-    response.resize(response.size() + attrTable.size());
-    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    auto& table = buildFileTable(FILE_TABLE_JSON);
+    fs::path path;
 
-    if (attrTable.empty())
+    try
     {
-        encode_get_file_table_resp(0, PLDM_FILE_TABLE_UNAVAILABLE, 0, 0,
-                                   nullptr, 0, responsePtr);
-        return response;
+        std::shared_lock<std::shared_mutex> lock(fileTableMutex());
+        path = table.at(fileHandle).fsPath;
+    }
+    catch (std::exception& e)
+    {
+        PLDM_LOG(ERR, "File handle does not exist in the file table",
+                 entry("HANDLE=%d", fileHandle));
+        return encodeError(PLDM_INVALID_FILE_HANDLE);
     }
 
-    encode_get_file_table_resp(0, PLDM_SUCCESS, 0, PLDM_START_AND_END,
-                               attrTable.data(), attrTable.size(), responsePtr);
-    return response;
+    Digest digest;
+    rc = fileDigests().digest(fileHandle, path,
+                              static_cast<DigestType>(checksumType), offset,
+                              length, digest);
+    if (rc == -ENOENT)
+    {
+        PLDM_LOG(ERR, "File does not exist", entry("HANDLE=%d", fileHandle));
+        return encodeError(PLDM_INVALID_FILE_HANDLE);
+    }
+    if (rc == -ERANGE)
+    {
+        PLDM_LOG(ERR, "Offset exceeds file size", entry("OFFSET=%d", offset),
+                 entry("HANDLE=%d", fileHandle));
+        return encodeError(PLDM_DATA_OUT_OF_RANGE);
+    }
+    if (rc < 0)
+    {
+        PLDM_LOG(ERR, "Failed to compute the checksum of the file",
+                 entry("HANDLE=%d", fileHandle), entry("RC=%d", rc));
+        return encodeError(PLDM_ERROR);
+    }
+
+    responseLength = minResponseLength + digest.size();
+    encode_get_file_checksum_resp(0, PLDM_SUCCESS, length, digest.data(),
+                                  digest.size(), responsePtr);
+    return PLDM_SUCCESS;
+}
+
+Response followFile(const uint8_t* request, size_t payloadLength)
+{
+    return toResponse(followFile, request, payloadLength);
+}
+
+int followFile(const uint8_t* request, size_t payloadLength, uint8_t* response,
+               size_t& responseLength)
+{
+    metrics::Timer timer;
+    uint32_t fileHandle = 0;
+    uint32_t cursor = 0;
+    uint32_t fileId = 0;
+    uint32_t length = 0;
+
+    constexpr size_t minResponseLength =
+        sizeof(pldm_msg_hdr) + PLDM_FOLLOW_FILE_MIN_RESP_BYTES;
+    if (responseLength < minResponseLength)
+    {
+        responseLength = minResponseLength;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response);
+    auto encodeError = [&](uint8_t completionCode) {
+        responseLength = sizeof(pldm_msg_hdr) + 1;
+        memset(response, 0, responseLength);
+        encode_follow_file_resp(0, completionCode, 0, 0, 0, 0, responsePtr);
+        return PLDM_SUCCESS;
+    };
+
+    auto rc = decode_follow_file_req(request, payloadLength, &fileHandle,
+                                     &cursor, &fileId, &length);
+    if (rc)
+    {
+        return encodeError(rc);
+    }
+
+    using namespace pldm::filetable;
+    auto& table = buildFileTable(FILE_TABLE_JSON);
+    fs::path path;
+
+    try
+    {
+        std::shared_lock<std::shared_mutex> lock(fileTableMutex());
+        path = table.at(fileHandle).fsPath;
+    }
+    catch (std::exception& e)
+    {
+        PLDM_LOG(ERR, "File handle does not exist in the file table",
+                 entry("HANDLE=%d", fileHandle));
+        return encodeError(PLDM_INVALID_FILE_HANDLE);
+    }
+
+    uint32_t fileSize = 0;
+    ino_t inode = 0;
+    rc = fileSizes().size(fileHandle, path, fileSize, inode);
+    if (rc < 0)
+    {
+        PLDM_LOG(ERR, "File does not exist", entry("HANDLE=%d", fileHandle));
+        return encodeError(PLDM_INVALID_FILE_HANDLE);
+    }
+
+    // A log that was rotated is followed from the start of the new file,
+    // whatever its size
+    uint32_t id = followId(inode);
+    if (fileId && fileId != id)
+    {
+        PLDM_LOG(INFO, "Followed file was replaced",
+                 entry("HANDLE=%d", fileHandle), entry("CURSOR=%d", cursor));
+        cursor = 0;
+    }
+
+    // The file was truncated in place, the host starts over from cursor 0
+    if (cursor > fileSize)
+    {
+        PLDM_LOG(INFO, "Followed file was truncated",
+                 entry("CURSOR=%d", cursor), entry("FILE_SIZE=%d", fileSize));
+        return encodeError(PLDM_DATA_OUT_OF_RANGE);
+    }
+
+    // Nothing was appended, answered from the cached size alone
+    length = std::min({length, fileSize - cursor, maxInlineLength});
+    if (!length)
+    {
+        responseLength = minResponseLength;
+        encode_follow_file_resp(0, PLDM_SUCCESS, cursor, id, fileSize, 0,
+                                responsePtr);
+        return PLDM_SUCCESS;
+    }
+
+    if (responseLength < minResponseLength + length)
+    {
+        responseLength = minResponseLength + length;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+
+    // Read the appended bytes directly, a log that keeps growing would be
+    // loaded again as a whole by the file cache
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        PLDM_LOG(ERR, "File does not exist", entry("HANDLE=%d", fileHandle));
+        return encodeError(PLDM_INVALID_FILE_HANDLE);
+    }
+    utils::CustomFD file(fd);
+
+    // The file was replaced after its size was taken, the next request
+    // finds the new one
+    struct stat st
+    {
+    };
+    if (fstat(file(), &st) == 0 && st.st_ino != inode)
+    {
+        fileSizes().invalidate(fileHandle);
+        responseLength = minResponseLength;
+        encode_follow_file_resp(0, PLDM_SUCCESS, cursor, id, fileSize, 0,
+                                responsePtr);
+        return PLDM_SUCCESS;
+    }
+
+    ssize_t count = 0;
+    {
+        auto guard = rangeLocks().lock(path, cursor, length, false);
+        do
+        {
+            count = pread(file(), response + minResponseLength, length,
+                          cursor);
+        } while (count < 0 && errno == EINTR);
+    }
+    if (count < 0)
+    {
+        PLDM_LOG(ERR, "Failed to read the file",
+                 entry("HANDLE=%d", fileHandle), entry("ERRNO=%d", errno));
+        return encodeError(PLDM_ERROR);
+    }
+
+    encode_follow_file_resp(0, PLDM_SUCCESS, cursor + count, id, fileSize,
+                            count, responsePtr);
+    responseLength = minResponseLength + count;
+    fileAccounting().record(fileHandle, false, count, timer.elapsed());
+    return PLDM_SUCCESS;
 }
 
 } // namespace responder
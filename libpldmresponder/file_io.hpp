@@ -3,10 +3,28 @@
 #include <stdint.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "libpldm/base.h"
+#include "admission.hpp"
+#include "dma_scheduler.hpp"
+#include "event_loop.hpp"
+#include "executor.hpp"
 #include "libpldm/file_io.h"
+#include "metrics.hpp"
+#include "range_lock.hpp"
+#include "trace.hpp"
 
 namespace pldm
 {
@@ -16,6 +34,53 @@ namespace responder
 
 using Response = std::vector<uint8_t>;
 
+/** @brief Handler that encodes the PLDM response into a caller provided buffer
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[in,out] responseLength - size of the buffer on input. On output the
+ *                                  length of the encoded response message, or
+ *                                  the size needed if the buffer is too small
+ *
+ *  @return PLDM_SUCCESS if the response was encoded, PLDM_ERROR_INVALID_LENGTH
+ *          if the buffer is too small
+ */
+using EncodeHandler = int (*)(const uint8_t* request, size_t payloadLength,
+                              uint8_t* response, size_t& responseLength);
+
+/** @brief Get the per-thread arena responses are encoded into
+ *
+ *  The arena is a buffer per thread that grows to the largest response
+ *  encoded on that thread and is then reused, so encoding a response does not
+ *  allocate in the steady state.
+ *
+ *  @return Response& - the arena of the calling thread
+ */
+Response& responseArena();
+
+/** @brief Number of times a handler is run to fit its response in the arena
+ *
+ *  Handlers clip the data they return to the current size of the file, which
+ *  may grow between the run that sizes the arena and the one that fills it.
+ *  A response that still does not fit after this many runs fails the request.
+ */
+constexpr int maxEncodeAttempts = 4;
+
+/** @brief Encode the response of a handler into the per-thread arena
+ *
+ *  @param[in] handler - handler for the command
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *
+ *  @return pointer to and length of the PLDM response message, valid until the
+ *          next response is encoded on the same thread. The response carries
+ *          PLDM_ERROR if it did not fit in maxEncodeAttempts runs.
+ */
+std::pair<const uint8_t*, size_t> encodeResponse(EncodeHandler handler,
+                                                 const uint8_t* request,
+                                                 size_t payloadLength);
+
 namespace utils
 {
 
@@ -64,6 +129,61 @@ constexpr size_t maxSize = (16 * 1024 * 1024) - 4096;
 
 namespace fs = std::filesystem;
 
+/** @struct RetryPolicy
+ *
+ *  How transferAll and AsyncTransfer retry a DMA chunk that failed with a
+ *  transient error, e.g. the engine being busy. A chunk is retried up to
+ *  retries times, waiting backoff(attempt) before each retry. Other errors
+ *  fail the transfer right away. A policy is any type with the same static
+ *  members.
+ */
+struct RetryPolicy
+{
+    /** @brief Number of times a chunk is retried after it first fails */
+    static constexpr unsigned retries = 3;
+
+    /** @brief Wait before the first retry, doubled for every later one */
+    static constexpr std::chrono::microseconds initialBackoff{200};
+
+    /** @brief Get the wait before a retry
+     *
+     * @param[in] attempt - number of retries made so far
+     */
+    static constexpr std::chrono::microseconds backoff(unsigned attempt)
+    {
+        return initialBackoff * (1u << attempt);
+    }
+
+    /** @brief Check if a failure is worth retrying
+     *
+     * @param[in] rc - negative errno returned by transferDataHost
+     */
+    static constexpr bool retryable(int rc)
+    {
+        return rc == -EBUSY || rc == -EAGAIN || rc == -EINTR ||
+               rc == -ETIMEDOUT;
+    }
+};
+
+/** @struct NoRetry
+ *
+ *  Retry policy that fails the transfer on the first error
+ */
+struct NoRetry
+{
+    static constexpr unsigned retries = 0;
+
+    static constexpr std::chrono::microseconds backoff(unsigned)
+    {
+        return std::chrono::microseconds(0);
+    }
+
+    static constexpr bool retryable(int)
+    {
+        return false;
+    }
+};
+
 /**
  * @class DMA
  *
@@ -89,15 +209,65 @@ class DMA
      */
     int transferDataHost(const fs::path& path, uint32_t offset, uint32_t length,
                          uint64_t address, bool upstream);
+
+    /** @brief Function that transfers data in place of the XDMA device, with
+     *         the arguments and return value of transferDataHost
+     */
+    using Emulation =
+        std::function<int(const fs::path& path, uint32_t offset,
+                          uint32_t length, uint64_t address, bool upstream)>;
+
+    /** @brief Run the transfers of all DMA instances through a function
+     *         instead of the XDMA device, for tools that run the handlers off
+     *         the BMC. Not to be called while transfers are running.
+     *
+     * @param[in] emulation - the function, or an empty function to use the
+     *                        device again
+     */
+    static void emulate(Emulation emulation);
 };
 
+/** @brief Encode the response of a transfer that failed
+ *
+ *  A transfer that fails after some of its chunks were transferred is
+ *  answered with PLDM_PARTIAL_TRANSFER and the number of bytes transferred,
+ *  so that the host resumes it at offset + length instead of starting over.
+ *
+ * @param[in] command - PLDM command
+ * @param[in] completionCode - completion code if nothing was transferred
+ * @param[in] transferred - number of bytes transferred before the failure
+ * @param[out] response - PLDM response message
+ */
+inline void encodeFailure(uint8_t command, uint8_t completionCode,
+                          uint32_t transferred, pldm_msg* response)
+{
+    if (transferred)
+    {
+        encode_rw_file_memory_resp(0, command, PLDM_PARTIAL_TRANSFER,
+                                   transferred, response);
+        return;
+    }
+    encode_rw_file_memory_resp(0, command, completionCode, 0, response);
+}
+
 /** @brief Transfer the data between BMC and host using DMA.
  *
  *  There is a max size for each DMA operation, transferAll API abstracts this
  *  and the requested length is broken down into multiple DMA operations if the
- *  length exceed max size.
+ *  length exceed max size. Each DMA operation holds a range lock on the part
+ *  of the file it transfers, shared when reading the file and exclusive when
+ *  writing it. Each DMA operation waits to be admitted within the budget of
+ *  bytes in flight first, and the request is answered with
+ *  PLDM_ERROR_NOT_READY if it is not admitted in time, or with
+ *  PLDM_PARTIAL_TRANSFER if earlier chunks were transferred. With the range
+ *  locked, the DMA operation waits for its turn on the DMA scheduler, in the
+ *  class given by the length of the whole transfer. A DMA operation that
+ *  fails with a transient error is retried as the retry policy says. Its
+ *  bytes of the budget, its range lock and the engine are given back for the
+ *  backoff, and taken again for the retry.
  *
  * @tparam[in] T - DMA interface type
+ * @tparam[in] Retry - retry policy, see RetryPolicy
  * @param[in] intf - interface passed to invoke DMA transfer
  * @param[in] command  - PLDM command
  * @param[in] path     - pathname of the file to transfer data from or to
@@ -106,26 +276,78 @@ class DMA
  * @param[in] address  - DMA address on the host
  * @param[in] upstream - indicates direction of the transfer; true indicates
  *                       transfer to the host
- * @return PLDM response message
+ * @param[out] response - buffer the PLDM response message is encoded into
+ * @param[in,out] responseLength - size of the buffer on input, length of the
+ *                                 encoded response message on output
+ * @return PLDM_SUCCESS if the response was encoded, PLDM_ERROR_INVALID_LENGTH
+ *         if the buffer is too small
  */
-
-template <class DMAInterface>
-Response transferAll(DMAInterface* intf, uint8_t command, fs::path& path,
-                     uint32_t offset, uint32_t length, uint64_t address,
-                     bool upstream)
+template <class DMAInterface, class Retry = RetryPolicy>
+int transferAll(DMAInterface* intf, uint8_t command, fs::path& path,
+                uint32_t offset, uint32_t length, uint64_t address,
+                bool upstream, uint8_t* response, size_t& responseLength)
 {
+    constexpr size_t encodedLength =
+        sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES;
+    if (responseLength < encodedLength)
+    {
+        responseLength = encodedLength;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+    memset(response, 0, encodedLength);
+    responseLength = encodedLength;
+
     uint32_t origLength = length;
-    Response response(sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES, 0);
-    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    auto priority = classify(length);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response);
+
+    // Each chunk locks only the range of the file it transfers, so that
+    // transfers to other regions of the file are not held up. Transfers to
+    // the host read the file and share the range.
+    uint8_t completionCode = PLDM_ERROR;
+    auto transferChunk = [&](uint32_t chunkLength) {
+        int rc = 0;
+        for (unsigned attempt = 0;; ++attempt)
+        {
+            {
+                auto reservation = admission().admit(chunkLength);
+                if (!reservation)
+                {
+                    completionCode = PLDM_ERROR_NOT_READY;
+                    return -EBUSY;
+                }
+                auto guard =
+                    rangeLocks().lock(path, offset, chunkLength, !upstream);
+                auto turn = dmaScheduler().acquire(priority, chunkLength);
+                PLDM_TRACE(chunk_start, path.c_str(), offset, chunkLength,
+                           static_cast<int>(upstream));
+                rc = intf->transferDataHost(path, offset, chunkLength,
+                                            address, upstream);
+                PLDM_TRACE(chunk_done, path.c_str(), offset, chunkLength, rc);
+            }
+            if (rc >= 0 || attempt == Retry::retries || !Retry::retryable(rc))
+            {
+                if (rc >= 0 && attempt)
+                {
+                    metrics::recordRecovery();
+                }
+                break;
+            }
+            metrics::recordRetry();
+            std::this_thread::sleep_for(Retry::backoff(attempt));
+        }
+        metrics::recordChunk(chunkLength, upstream, rc >= 0);
+        return rc;
+    };
 
     while (length > dma::maxSize)
     {
-        auto rc = intf->transferDataHost(path, offset, dma::maxSize, address,
-                                         upstream);
+        auto rc = transferChunk(dma::maxSize);
         if (rc < 0)
         {
-            encode_rw_file_memory_resp(0, command, PLDM_ERROR, 0, responsePtr);
-            return response;
+            encodeFailure(command, completionCode, origLength - length,
+                          responsePtr);
+            return PLDM_SUCCESS;
         }
 
         offset += dma::maxSize;
@@ -133,20 +355,320 @@ Response transferAll(DMAInterface* intf, uint8_t command, fs::path& path,
         address += dma::maxSize;
     }
 
-    auto rc = intf->transferDataHost(path, offset, length, address, upstream);
+    auto rc = transferChunk(length);
     if (rc < 0)
     {
-        encode_rw_file_memory_resp(0, command, PLDM_ERROR, 0, responsePtr);
-        return response;
+        encodeFailure(command, completionCode, origLength - length,
+                      responsePtr);
+        return PLDM_SUCCESS;
     }
 
     encode_rw_file_memory_resp(0, command, PLDM_SUCCESS, origLength,
                                responsePtr);
+    return PLDM_SUCCESS;
+}
+
+/** @brief Transfer the data between BMC and host using DMA.
+ *
+ * @tparam[in] T - DMA interface type
+ * @param[in] intf - interface passed to invoke DMA transfer
+ * @param[in] command  - PLDM command
+ * @param[in] path     - pathname of the file to transfer data from or to
+ * @param[in] offset   - offset in the file
+ * @param[in] length   - length of the data to transfer
+ * @param[in] address  - DMA address on the host
+ * @param[in] upstream - indicates direction of the transfer; true indicates
+ *                       transfer to the host
+ * @return PLDM response message
+ */
+template <class DMAInterface, class Retry = RetryPolicy>
+Response transferAll(DMAInterface* intf, uint8_t command, fs::path& path,
+                     uint32_t offset, uint32_t length, uint64_t address,
+                     bool upstream)
+{
+    Response response(sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES, 0);
+    size_t responseLength = response.size();
+    transferAll<DMAInterface, Retry>(intf, command, path, offset, length,
+                                     address, upstream, response.data(),
+                                     responseLength);
     return response;
 }
 
+/** @brief Callback that receives the PLDM response message of a command that
+ *         completes on an event loop
+ */
+using Completion =
+    std::function<void(const uint8_t* response, size_t responseLength)>;
+
+/** @class AsyncTransfer
+ *
+ *  Resumable form of transferAll. Each step takes what one DMA chunk needs
+ *  on the event loop, runs the chunk on dmaExecutor() and finishes it back
+ *  on the loop, where the next step is posted. The loop serves other
+ *  requests and events while a chunk runs, and the chunks of other
+ *  transfers run in between. The state of the transfer is kept in the
+ *  object, which is owned by the posted step, instead of on the stack of a
+ *  thread.
+ *
+ *  If the chunk does not fit in the budget of bytes in flight, its range is
+ *  locked by another transfer, or it is not its turn on the DMA scheduler,
+ *  the step returns instead of blocking the loop, and is posted again when
+ *  bytes are returned to the budget, a lock of the file is released or the
+ *  engine is freed. A chunk that is not admitted within the timeout of the
+ *  admission controller completes the request with PLDM_ERROR_NOT_READY. As
+ *  with transferAll, a failure after earlier chunks were transferred
+ *  completes it with PLDM_PARTIAL_TRANSFER, and chunks that fail with a
+ *  transient error are retried as the retry policy says. The retry is
+ *  posted with the backoff as its delay, and the chunk holds neither its
+ *  range lock nor its bytes of the budget during the backoff.
+ */
+template <class DMAInterface, class Retry = RetryPolicy>
+class AsyncTransfer
+    : public std::enable_shared_from_this<AsyncTransfer<DMAInterface, Retry>>
+{
+  public:
+    /** @brief Start a transfer on an event loop
+     *
+     * @param[in] loop - event loop to run the transfer on
+     * @param[in] intf - interface passed to invoke DMA transfer
+     * @param[in] command  - PLDM command
+     * @param[in] path     - pathname of the file to transfer data from or to
+     * @param[in] offset   - offset in the file
+     * @param[in] length   - length of the data to transfer
+     * @param[in] address  - DMA address on the host
+     * @param[in] upstream - indicates direction of the transfer; true
+     *                       indicates transfer to the host
+     * @param[in] done - called on the loop with the response message
+     */
+    static void start(EventLoop& loop, std::shared_ptr<DMAInterface> intf,
+                      uint8_t command, const fs::path& path, uint32_t offset,
+                      uint32_t length, uint64_t address, bool upstream,
+                      Completion done)
+    {
+        std::shared_ptr<AsyncTransfer> transfer(new AsyncTransfer(
+            loop, std::move(intf), command, path, offset, length, address,
+            upstream, std::move(done)));
+        transfer->post();
+    }
+
+  private:
+    AsyncTransfer(EventLoop& loop, std::shared_ptr<DMAInterface> intf,
+                  uint8_t command, const fs::path& path, uint32_t offset,
+                  uint32_t length, uint64_t address, bool upstream,
+                  Completion done) :
+        loop(loop),
+        intf(std::move(intf)), command(command), path(path), offset(offset),
+        length(length), origLength(length), address(address),
+        upstream(upstream), priority(classify(length)), done(std::move(done))
+    {
+    }
+
+    void post()
+    {
+        loop.post([self = this->shared_from_this()] { self->step(); });
+    }
+
+    /** @brief Make the callback that resumes a step that has to wait
+     *
+     *  The step may wait on more than one event, e.g. the release of bytes
+     *  and the admission timeout, so the callback and its copies post the
+     *  next step only once. The callback may be called on any thread.
+     */
+    std::function<void()> resumer()
+    {
+        auto id = wait.load();
+        return [self = this->shared_from_this(), id] {
+            if (self->wait.load() != id)
+            {
+                return;
+            }
+            self->loop.post([self, id] {
+                auto expected = id;
+                if (self->wait.compare_exchange_strong(expected, id + 1))
+                {
+                    self->step();
+                }
+            });
+        };
+    }
+
+    /** @brief Take what the next chunk needs and run it on the executor
+     */
+    void step()
+    {
+        uint32_t chunkLength = std::min<uint32_t>(length, maxSize);
+        auto resume = resumer();
+        auto now = std::chrono::steady_clock::now();
+        if (attempt && now < retryAt)
+        {
+            loop.postAfter(retryAt - now, resume);
+            waiting = metrics::Timer();
+            return;
+        }
+        if (!admitted)
+        {
+            auto waited = waiting.elapsed();
+            if (!admission().tryAdmit(chunkLength, waited, resume))
+            {
+                if (waited > admission().maxWait())
+                {
+                    admission().reject(waited);
+                    fail(PLDM_ERROR_NOT_READY);
+                    return;
+                }
+                loop.postAfter(admission().maxWait() - waited +
+                                   std::chrono::milliseconds(1),
+                               resume);
+                return;
+            }
+            admitted = true;
+        }
+        if (!locked)
+        {
+            if (!rangeLocks().tryLock(path, offset, chunkLength, !upstream,
+                                      resume))
+            {
+                return;
+            }
+            locked = true;
+        }
+        if (!ticket)
+        {
+            ticket = dmaScheduler().submit(priority, chunkLength);
+        }
+        if (!dmaScheduler().tryStart(ticket, resume))
+        {
+            return;
+        }
+
+        // The chunk does not change the state of the transfer, which is only
+        // touched on the loop
+        dmaExecutor().post([self = this->shared_from_this(), chunkLength] {
+            PLDM_TRACE(chunk_start, self->path.c_str(), self->offset,
+                       chunkLength, static_cast<int>(self->upstream));
+            auto rc = self->intf->transferDataHost(self->path, self->offset,
+                                                   chunkLength, self->address,
+                                                   self->upstream);
+            PLDM_TRACE(chunk_done, self->path.c_str(), self->offset,
+                       chunkLength, rc);
+            self->loop.post(
+                [self, chunkLength, rc] { self->finish(chunkLength, rc); });
+        });
+    }
+
+    /** @brief Finish a chunk that ran, then post the next step or complete
+     *
+     * @param[in] chunkLength - length of the chunk
+     * @param[in] rc - result of the chunk
+     */
+    void finish(uint32_t chunkLength, int rc)
+    {
+        dmaScheduler().finish();
+        ticket = 0;
+
+        // The chunk gives its range lock and its bytes of the budget back,
+        // a retried chunk takes them again when its backoff is over
+        rangeLocks().unlock(path.string(), {offset, chunkLength, !upstream});
+        locked = false;
+        admission().release(chunkLength);
+        admitted = false;
+        waiting = metrics::Timer();
+        if (rc < 0 && attempt < Retry::retries && Retry::retryable(rc))
+        {
+            metrics::recordRetry();
+            auto backoff = Retry::backoff(attempt);
+            retryAt = std::chrono::steady_clock::now() + backoff;
+            ++attempt;
+            loop.postAfter(backoff, resumer());
+            return;
+        }
+        if (rc >= 0 && attempt)
+        {
+            metrics::recordRecovery();
+        }
+        attempt = 0;
+        metrics::recordChunk(chunkLength, upstream, rc >= 0);
+        if (rc < 0)
+        {
+            fail(PLDM_ERROR);
+            return;
+        }
+
+        offset += chunkLength;
+        length -= chunkLength;
+        address += chunkLength;
+        if (length)
+        {
+            post();
+            return;
+        }
+        complete(PLDM_SUCCESS, origLength);
+    }
+
+    void complete(uint8_t completionCode, uint32_t transferred)
+    {
+        ++wait;
+        std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES>
+            response{};
+        auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+        encode_rw_file_memory_resp(0, command, completionCode, transferred,
+                                   responsePtr);
+        done(response.data(), response.size());
+    }
+
+    /** @brief Complete a transfer that failed, see encodeFailure */
+    void fail(uint8_t completionCode)
+    {
+        ++wait;
+        std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES>
+            response{};
+        encodeFailure(command, completionCode, origLength - length,
+                      reinterpret_cast<pldm_msg*>(response.data()));
+        done(response.data(), response.size());
+    }
+
+    EventLoop& loop;
+    std::shared_ptr<DMAInterface> intf;
+    uint8_t command;
+    fs::path path;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t origLength;
+    uint64_t address;
+    bool upstream;
+    Priority priority;
+    Completion done;
+
+    /** @brief whether the next chunk holds bytes of the budget */
+    bool admitted = false;
+
+    /** @brief whether the next chunk holds its range lock */
+    bool locked = false;
+
+    /** @brief ticket of the next chunk on the DMA scheduler, 0 if it is not
+     *         queued */
+    DMAScheduler::Ticket ticket = 0;
+
+    /** @brief number of times the next chunk was retried */
+    unsigned attempt = 0;
+
+    /** @brief time the next retry of the chunk may start */
+    std::chrono::steady_clock::time_point retryAt;
+
+    /** @brief started when the next chunk began waiting to be admitted */
+    metrics::Timer waiting;
+
+    /** @brief identifies the wait of the step, the callbacks made for it by
+     *         resumer do nothing once it changes */
+    std::atomic<uint64_t> wait{0};
+};
+
 } // namespace dma
 
+// The largest amount of file data returned inline by ReadFile, larger reads
+// should use ReadFileIntoMemory
+constexpr uint32_t maxInlineLength = 4096;
+
 /** @brief Handler for readFileIntoMemory command
  *
  *  @param[in] request - pointer to PLDM request payload
@@ -156,6 +678,32 @@ Response transferAll(DMAInterface* intf, uint8_t command, fs::path& path,
  */
 Response readFileIntoMemory(const uint8_t* request, size_t payloadLength);
 
+/** @brief Handler for readFileIntoMemory command
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[in,out] responseLength - size of the buffer on input, length of the
+ *                                  encoded response message on output
+ *
+ *  @return PLDM_SUCCESS if the response was encoded, PLDM_ERROR_INVALID_LENGTH
+ *          if the buffer is too small
+ */
+int readFileIntoMemory(const uint8_t* request, size_t payloadLength,
+                       uint8_t* response, size_t& responseLength);
+
+/** @brief Handler for readFileIntoMemory command that runs the transfer on an
+ *         event loop
+ *
+ *  @param[in] loop - event loop to run the transfer on
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[in] done - called on the loop with the response message, or before
+ *                    returning if the request is rejected
+ */
+void readFileIntoMemory(EventLoop& loop, const uint8_t* request,
+                        size_t payloadLength, dma::Completion done);
+
 /** @brief Handler for writeFileIntoMemory command
  *
  *  @param[in] request - pointer to PLDM request payload
@@ -165,6 +713,32 @@ Response readFileIntoMemory(const uint8_t* request, size_t payloadLength);
  */
 Response writeFileFromMemory(const uint8_t* request, size_t payloadLength);
 
+/** @brief Handler for writeFileIntoMemory command
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[in,out] responseLength - size of the buffer on input, length of the
+ *                                  encoded response message on output
+ *
+ *  @return PLDM_SUCCESS if the response was encoded, PLDM_ERROR_INVALID_LENGTH
+ *          if the buffer is too small
+ */
+int writeFileFromMemory(const uint8_t* request, size_t payloadLength,
+                        uint8_t* response, size_t& responseLength);
+
+/** @brief Handler for writeFileIntoMemory command that runs the transfer on an
+ *         event loop
+ *
+ *  @param[in] loop - event loop to run the transfer on
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[in] done - called on the loop with the response message, or before
+ *                    returning if the request is rejected
+ */
+void writeFileFromMemory(EventLoop& loop, const uint8_t* request,
+                         size_t payloadLength, dma::Completion done);
+
 /** @brief Handler for GetFileTable command
  *
  *  @param[in] request - pointer to PLDM request payload
@@ -173,5 +747,152 @@ Response writeFileFromMemory(const uint8_t* request, size_t payloadLength);
  *  @return PLDM response message
  */
 Response getFileTable(const uint8_t* request, size_t payloadLength);
+
+/** @brief Handler for GetFileTable command
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[in,out] responseLength - size of the buffer on input. On output the
+ *                                  length of the encoded response message, or
+ *                                  the size needed if the buffer is too small
+ *
+ *  @return PLDM_SUCCESS if the response was encoded, PLDM_ERROR_INVALID_LENGTH
+ *          if the buffer is too small
+ */
+int getFileTable(const uint8_t* request, size_t payloadLength,
+                 uint8_t* response, size_t& responseLength);
+
+/** @brief Handler for ReadFile command, which returns the file data inline
+ *         in the response instead of by DMA
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *
+ *  @return PLDM response message
+ */
+Response readFile(const uint8_t* request, size_t payloadLength);
+
+/** @brief Handler for ReadFile command, which returns the file data inline
+ *         in the response instead of by DMA
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[in,out] responseLength - size of the buffer on input. On output the
+ *                                  length of the encoded response message, or
+ *                                  the size needed if the buffer is too small
+ *
+ *  @return PLDM_SUCCESS if the response was encoded, PLDM_ERROR_INVALID_LENGTH
+ *          if the buffer is too small
+ */
+int readFile(const uint8_t* request, size_t payloadLength, uint8_t* response,
+             size_t& responseLength);
+
+/** @brief Handler for WriteFile command, which carries the file data inline
+ *         in the request instead of by DMA
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *
+ *  @return PLDM response message
+ */
+Response writeFile(const uint8_t* request, size_t payloadLength);
+
+/** @brief Handler for WriteFile command, which carries the file data inline
+ *         in the request instead of by DMA
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[in,out] responseLength - size of the buffer on input, length of the
+ *                                  encoded response message on output
+ *
+ *  @return PLDM_SUCCESS if the response was encoded, PLDM_ERROR_INVALID_LENGTH
+ *          if the buffer is too small
+ */
+int writeFile(const uint8_t* request, size_t payloadLength, uint8_t* response,
+              size_t& responseLength);
+
+// Largest number of changed ranges in a GetChangedBlocks response
+constexpr size_t maxChangedRanges = 128;
+
+/** @brief Handler for GetChangedBlocks command, which returns the ranges of
+ *         a file that changed since a generation
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *
+ *  @return PLDM response message
+ */
+Response getChangedBlocks(const uint8_t* request, size_t payloadLength);
+
+/** @brief Handler for GetChangedBlocks command, which returns the ranges of
+ *         a file that changed since a generation
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[in,out] responseLength - size of the buffer on input. On output the
+ *                                  length of the encoded response message, or
+ *                                  the size needed if the buffer is too small
+ *
+ *  @return PLDM_SUCCESS if the response was encoded, PLDM_ERROR_INVALID_LENGTH
+ *          if the buffer is too small
+ */
+int getChangedBlocks(const uint8_t* request, size_t payloadLength,
+                     uint8_t* response, size_t& responseLength);
+
+/** @brief Handler for GetFileChecksum command, which returns the CRC-32 or
+ *         SHA-256 of a range of a file
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *
+ *  @return PLDM response message
+ */
+Response getFileChecksum(const uint8_t* request, size_t payloadLength);
+
+/** @brief Handler for GetFileChecksum command, which returns the CRC-32 or
+ *         SHA-256 of a range of a file
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[in,out] responseLength - size of the buffer on input. On output the
+ *                                  length of the encoded response message, or
+ *                                  the size needed if the buffer is too small
+ *
+ *  @return PLDM_SUCCESS if the response was encoded, PLDM_ERROR_INVALID_LENGTH
+ *          if the buffer is too small
+ */
+int getFileChecksum(const uint8_t* request, size_t payloadLength,
+                    uint8_t* response, size_t& responseLength);
+
+/** @brief Handler for FollowFile command, which returns the data appended
+ *         to a file after a cursor and the cursor to continue at
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *
+ *  @return PLDM response message
+ */
+Response followFile(const uint8_t* request, size_t payloadLength);
+
+/** @brief Handler for FollowFile command, which returns the data appended
+ *         to a file after a cursor and the cursor to continue at
+ *
+ *  @param[in] request - pointer to PLDM request payload
+ *  @param[in] payloadLength - length of the message payload
+ *  @param[out] response - buffer the PLDM response message is encoded into
+ *  @param[in,out] responseLength - size of the buffer on input. On output the
+ *                                  length of the encoded response message, or
+ *                                  the size needed if the buffer is too small
+ *
+ *  @return PLDM_SUCCESS if the response was encoded, PLDM_ERROR_INVALID_LENGTH
+ *          if the buffer is too small
+ */
+int followFile(const uint8_t* request, size_t payloadLength, uint8_t* response,
+               size_t& responseLength);
 } // namespace responder
 } // namespace pldm
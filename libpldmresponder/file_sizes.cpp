@@ -0,0 +1,185 @@
+#include "file_sizes.hpp"
+
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace pldm
+{
+
+namespace filetable
+{
+
+using namespace pldm::responder;
+
+namespace
+{
+
+// Events that mean the size of a watched file may have changed
+constexpr uint32_t modifyEvents = IN_MODIFY | IN_CLOSE_WRITE;
+
+// Events that mean the watched file is gone
+constexpr uint32_t goneEvents = IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED;
+
+} // namespace
+
+SizeCache::~SizeCache()
+{
+    if (inotifyFd >= 0)
+    {
+        close(inotifyFd);
+    }
+}
+
+int SizeCache::size(Handle handle, const fs::path& path, uint32_t& size,
+                     ino_t& inode)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = entries.find(handle);
+    if (iter != entries.end() && iter->second.path != path)
+    {
+        erase(handle);
+        iter = entries.end();
+    }
+    if (iter != entries.end() && iter->second.valid)
+    {
+        size = iter->second.size;
+        inode = iter->second.inode;
+        return 0;
+    }
+
+    // Watch before taking the size, so that no change is missed in between
+    auto& entry = iter != entries.end() ? iter->second : entries[handle];
+    entry.path = path;
+    if (inotifyFd >= 0 && entry.watch < 0)
+    {
+        entry.watch = inotify_add_watch(inotifyFd, path.c_str(),
+                                        modifyEvents | goneEvents);
+        if (entry.watch >= 0)
+        {
+            watches[entry.watch] = handle;
+        }
+    }
+
+    struct stat st
+    {
+    };
+    if (stat(path.c_str(), &st) < 0)
+    {
+        auto rc = -errno;
+        erase(handle);
+        return rc;
+    }
+    entry.size = static_cast<uint32_t>(st.st_size);
+    entry.inode = st.st_ino;
+    entry.valid = entry.watch >= 0;
+    size = entry.size;
+    inode = entry.inode;
+    return 0;
+}
+
+void SizeCache::invalidate(Handle handle)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = entries.find(handle);
+    if (iter != entries.end())
+    {
+        iter->second.valid = false;
+    }
+}
+
+int SizeCache::watch(EventLoop& loop)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (inotifyFd >= 0)
+    {
+        return -EALREADY;
+    }
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+    auto rc = loop.addIO(fd, EPOLLIN, [this](uint32_t) { handleEvents(); });
+    if (rc < 0)
+    {
+        close(fd);
+        return rc;
+    }
+    inotifyFd = fd;
+
+    // Files asked about before are watched from their next lookup
+    return 0;
+}
+
+void SizeCache::handleEvents()
+{
+    alignas(inotify_event) char buffer[4096];
+    for (;;)
+    {
+        auto count = read(inotifyFd, buffer, sizeof(buffer));
+        if (count <= 0)
+        {
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (char* p = buffer; p < buffer + count;)
+        {
+            auto event = reinterpret_cast<const inotify_event*>(p);
+            p += sizeof(inotify_event) + event->len;
+
+            auto watch = watches.find(event->wd);
+            if (watch == watches.end())
+            {
+                continue;
+            }
+            if (event->mask & goneEvents)
+            {
+                erase(watch->second);
+                continue;
+            }
+
+            // Taken again on the next lookup, once however many events the
+            // file had
+            entries.at(watch->second).valid = false;
+        }
+    }
+}
+
+void SizeCache::erase(Handle handle)
+{
+    auto iter = entries.find(handle);
+    if (iter == entries.end())
+    {
+        return;
+    }
+    if (iter->second.watch >= 0)
+    {
+        watches.erase(iter->second.watch);
+        inotify_rm_watch(inotifyFd, iter->second.watch);
+    }
+    entries.erase(iter);
+}
+
+void SizeCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    while (!entries.empty())
+    {
+        erase(entries.begin()->first);
+    }
+}
+
+SizeCache& fileSizes()
+{
+    static SizeCache cache;
+    return cache;
+}
+
+} // namespace filetable
+} // namespace pldm
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
+#include "event_loop.hpp"
+#include "file_table.hpp"
+
+namespace pldm
+{
+
+namespace filetable
+{
+
+/** @class SizeCache
+ *
+ *  SizeCache keeps the current size of the files the host follows with
+ *  FollowFile, so that polling a log that did not grow is answered without
+ *  touching storage. Once watching, a file is watched with inotify from the
+ *  first time its size is asked for, and its size is taken again only after
+ *  inotify reports that it was modified. A file that is deleted or moved
+ *  away is forgotten, so that the file that replaces it is watched instead.
+ *  Without inotify the size is taken with stat on every call. The inode of
+ *  the file is kept with its size, so that a log that was rotated is told
+ *  apart from one that grew.
+ */
+class SizeCache
+{
+  public:
+    SizeCache() = default;
+    ~SizeCache();
+    SizeCache(const SizeCache&) = delete;
+    SizeCache& operator=(const SizeCache&) = delete;
+
+    /** @brief Get the current size and inode of a file
+     *
+     * @param[in] handle - file handle
+     * @param[in] path - pathname of the file
+     * @param[out] size - size of the file in bytes
+     * @param[out] inode - inode number of the file
+     *
+     * @return 0 on success, negative errno on failure
+     */
+    int size(Handle handle, const fs::path& path, uint32_t& size,
+             ino_t& inode);
+
+    /** @brief Take the size of a file written by the responder again,
+     *         without waiting for the inotify event
+     *
+     * @param[in] handle - file handle
+     */
+    void invalidate(Handle handle);
+
+    /** @brief Watch the files with inotify from an event loop, so that
+     *         their sizes are updated as they change
+     *
+     * @param[in] loop - event loop to read the inotify events on
+     *
+     * @return 0 on success, negative errno on failure
+     */
+    int watch(responder::EventLoop& loop);
+
+    /** @brief Forget all the files
+     */
+    void clear();
+
+  private:
+    /** @struct Entry
+     *
+     *  A watched file
+     */
+    struct Entry
+    {
+        fs::path path;      //!< Pathname of the file
+        uint32_t size = 0;  //!< Size in bytes
+        ino_t inode = 0;    //!< Inode number
+        bool valid = false; //!< size is current
+        int watch = -1;     //!< inotify watch descriptor
+    };
+
+    /** @brief Forget a file, with the lock held */
+    void erase(Handle handle);
+
+    /** @brief Read the pending inotify events */
+    void handleEvents();
+
+    /** @brief file handle to watched file */
+    std::unordered_map<Handle, Entry> entries;
+
+    /** @brief inotify watch descriptor to file handle */
+    std::unordered_map<int, Handle> watches;
+
+    /** @brief inotify instance, -1 when not watching */
+    int inotifyFd = -1;
+
+    std::mutex mutex;
+};
+
+/** @brief Get the size cache of the responder
+ *
+ *  @return SizeCache& - Reference to instance of size cache
+ */
+SizeCache& fileSizes();
+
+} // namespace filetable
+} // namespace pldm
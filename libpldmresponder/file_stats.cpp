@@ -0,0 +1,142 @@
+#include "file_stats.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+
+namespace pldm
+{
+
+namespace filetable
+{
+
+void FileAccounting::record(Handle handle, bool write, uint64_t bytes,
+                            std::chrono::nanoseconds latency)
+{
+    Entry* entry = nullptr;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto iter = entries.find(handle);
+        if (iter != entries.end())
+        {
+            entry = iter->second.get();
+        }
+    }
+    if (!entry)
+    {
+        std::lock_guard<std::shared_mutex> lock(mutex);
+        auto& slot = entries[handle];
+        if (!slot)
+        {
+            slot = std::make_unique<Entry>();
+        }
+        entry = slot.get();
+    }
+
+    // Entries are only freed by clear, which is not called while requests
+    // are handled
+    if (write)
+    {
+        entry->writes.fetch_add(1, std::memory_order_relaxed);
+        entry->bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    else
+    {
+        entry->reads.fetch_add(1, std::memory_order_relaxed);
+        entry->bytesRead.fetch_add(bytes, std::memory_order_relaxed);
+    }
+    entry->latency.record(latency.count());
+
+    auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    entry->lastAccess.store(now.count(), std::memory_order_relaxed);
+}
+
+FileStats FileAccounting::snapshot(Handle handle, const Entry& entry)
+{
+    FileStats stats{};
+    stats.handle = handle;
+    stats.reads = entry.reads.load(std::memory_order_relaxed);
+    stats.writes = entry.writes.load(std::memory_order_relaxed);
+    stats.bytesRead = entry.bytesRead.load(std::memory_order_relaxed);
+    stats.bytesWritten = entry.bytesWritten.load(std::memory_order_relaxed);
+    stats.lastAccess = entry.lastAccess.load(std::memory_order_relaxed);
+
+    auto count = entry.latency.count();
+    stats.meanLatency = count ? entry.latency.totalValue() / count : 0;
+    stats.p99Latency = entry.latency.percentile(99);
+    return stats;
+}
+
+std::optional<FileStats> FileAccounting::stats(Handle handle) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto iter = entries.find(handle);
+    if (iter == entries.end())
+    {
+        return std::nullopt;
+    }
+    return snapshot(handle, *iter->second);
+}
+
+std::vector<FileStats> FileAccounting::top(size_t count) const
+{
+    std::vector<FileStats> all;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        all.reserve(entries.size());
+        for (const auto& [handle, entry] : entries)
+        {
+            all.push_back(snapshot(handle, *entry));
+        }
+    }
+
+    auto bytes = [](const FileStats& stats) {
+        return stats.bytesRead + stats.bytesWritten;
+    };
+    count = std::min(count, all.size());
+    std::partial_sort(all.begin(), all.begin() + count, all.end(),
+                      [&bytes](const FileStats& a, const FileStats& b) {
+                          return bytes(a) > bytes(b) ||
+                                 (bytes(a) == bytes(b) && a.handle < b.handle);
+                      });
+    all.resize(count);
+    return all;
+}
+
+std::string FileAccounting::report(size_t count, const FileTable* table) const
+{
+    std::ostringstream out;
+    for (const auto& stats : top(count))
+    {
+        std::string name = "-";
+        if (table)
+        {
+            try
+            {
+                name = table->at(stats.handle).fsPath.filename().string();
+            }
+            catch (const std::exception&)
+            {
+            }
+        }
+
+        out << "file handle=" << stats.handle << " name=" << name
+            << " reads=" << stats.reads << " writes=" << stats.writes
+            << " bytes_read=" << stats.bytesRead
+            << " bytes_written=" << stats.bytesWritten
+            << " mean_ns=" << stats.meanLatency
+            << " p99_ns=" << stats.p99Latency
+            << " last_access_ns=" << stats.lastAccess << "\n";
+    }
+    return out.str();
+}
+
+FileAccounting& fileAccounting()
+{
+    static FileAccounting accounting;
+    return accounting;
+}
+
+} // namespace filetable
+} // namespace pldm
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "file_table.hpp"
+#include "metrics.hpp"
+
+namespace pldm
+{
+
+namespace filetable
+{
+
+/** @struct FileStats
+ *
+ *  Snapshot of the I/O accounting of a file
+ */
+struct FileStats
+{
+    Handle handle = 0;          //!< File handle
+    uint64_t reads = 0;         //!< Number of read requests
+    uint64_t writes = 0;        //!< Number of write requests
+    uint64_t bytesRead = 0;     //!< Bytes read from the file
+    uint64_t bytesWritten = 0;  //!< Bytes written to the file
+    uint64_t meanLatency = 0;   //!< Mean request latency in ns
+    uint64_t p99Latency = 0;    //!< 99th percentile request latency in ns
+    uint64_t lastAccess = 0;    //!< Time of the last request, in ns since
+                                //!< the Epoch
+};
+
+/** @class FileAccounting
+ *
+ *  FileAccounting counts the requests, bytes and latency of every file in the
+ *  file table, so that the files causing the load can be found: the
+ *  candidates to keep in the file cache, compress or move to faster storage.
+ *  The counters of a file are atomics, only the first request for a file
+ *  takes the lock exclusively.
+ */
+class FileAccounting
+{
+  public:
+    FileAccounting() = default;
+    ~FileAccounting() = default;
+    FileAccounting(const FileAccounting&) = delete;
+    FileAccounting& operator=(const FileAccounting&) = delete;
+
+    /** @brief Account a request to a file
+     *
+     * @param[in] handle - file handle
+     * @param[in] write - true for a write, false for a read
+     * @param[in] bytes - number of bytes transferred
+     * @param[in] latency - time taken to handle the request
+     */
+    void record(Handle handle, bool write, uint64_t bytes,
+                std::chrono::nanoseconds latency);
+
+    /** @brief Get the accounting of a file
+     *
+     * @param[in] handle - file handle
+     *
+     * @return the accounting, or nothing if the file was never accessed
+     */
+    std::optional<FileStats> stats(Handle handle) const;
+
+    /** @brief Get the accounting of the busiest files
+     *
+     * @param[in] count - number of files
+     *
+     * @return the accounting of up to count files, by decreasing number of
+     *         bytes transferred
+     */
+    std::vector<FileStats> top(size_t count) const;
+
+    /** @brief Render the accounting of the busiest files as text, in the
+     *         format of metrics::dump so that it can be added as a section
+     *
+     * @param[in] count - number of files
+     * @param[in] table - file table to name the files from, if any
+     *
+     * @return a line per file, busiest first
+     */
+    std::string report(size_t count, const FileTable* table = nullptr) const;
+
+    /** @brief Drop the accounting of all files
+     */
+    void clear()
+    {
+        std::lock_guard<std::shared_mutex> lock(mutex);
+        entries.clear();
+    }
+
+  private:
+    /** @struct Entry
+     *
+     *  Counters of a file
+     */
+    struct Entry
+    {
+        std::atomic<uint64_t> reads{0};
+        std::atomic<uint64_t> writes{0};
+        std::atomic<uint64_t> bytesRead{0};
+        std::atomic<uint64_t> bytesWritten{0};
+        std::atomic<uint64_t> lastAccess{0};
+        pldm::responder::metrics::Histogram latency;
+    };
+
+    /** @brief Take a snapshot of the counters of a file */
+    static FileStats snapshot(Handle handle, const Entry& entry);
+
+    /** @brief file handle to its counters */
+    std::unordered_map<Handle, std::unique_ptr<Entry>> entries;
+
+    mutable std::shared_mutex mutex;
+};
+
+/** @brief Get the file accounting of the responder
+ *
+ *  @return FileAccounting& - Reference to instance of file accounting
+ */
+FileAccounting& fileAccounting();
+
+} // namespace filetable
+} // namespace pldm
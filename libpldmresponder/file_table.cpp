@@ -1,8 +1,22 @@
 #include "file_table.hpp"
 
-#include <boost/crc.hpp>
+#include "crc32.hpp"
+#include "file_digest.hpp"
+#include "logging.hpp"
+
+#include <endian.h>
+#include <sys/stat.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <mutex>
 #include <phosphor-logging/log.hpp>
+#include <shared_mutex>
+
+#include "libpldm/file_io.h"
 
 namespace pldm
 {
@@ -36,11 +50,19 @@ FileTable::FileTable(const std::string& fileTableConfigPath)
     Handle handle = 0;
     auto iter = fileTable.begin();
 
+    // The generation of the last run of the responder is not known, start
+    // from one that is very likely newer than any it handed out
+    auto generation = static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+
     // Iterate through each JSON object in the config file
     for (const auto& record : data)
     {
         constexpr auto path = "path";
         constexpr auto fileTraits = "file_traits";
+        constexpr auto alignment = "alignment";
 
         std::string filepath = record.value(path, "");
         traits = static_cast<uint32_t>(record.value(fileTraits, 0));
@@ -72,6 +94,7 @@ FileTable::FileTable(const std::string& fileTableConfigPath)
                     fileNameLength, iter);
         std::advance(iter, fileNameLength);
 
+        sizeOffsets.emplace(handle, std::distance(fileTable.begin(), iter));
         std::copy_n(reinterpret_cast<uint8_t*>(&fileSize), sizeof(fileSize),
                     iter);
         std::advance(iter, sizeof(fileSize));
@@ -87,6 +110,13 @@ FileTable::FileTable(const std::string& fileTableConfigPath)
 
         // Insert the file entries in the map
         tableEntries.emplace(handle, std::move(entry));
+
+        // The rest of the stamp is computed when it is first needed, reading
+        // every file here would delay building the file attribute table
+        FileStamp stamp{};
+        stamp.generation = generation;
+        stamp.alignment = record.value(alignment, defaultAlignment);
+        stamps.emplace(handle, stamp);
         handle++;
     }
 
@@ -100,24 +130,174 @@ FileTable::FileTable(const std::string& fileTableConfigPath)
     }
 
     // Calculate the checksum
-    boost::crc_32_type result;
-    result.process_bytes(fileTable.data(), fileTable.size());
-    checkSum = result.checksum();
+    checkSum = crc32::compute(fileTable.data(), fileTable.size());
+}
+
+void FileTable::updateFileSize(Handle handle, uint32_t fileSize)
+{
+    auto offset = sizeOffsets.at(handle);
+    auto iter = fileTable.begin() + offset;
+
+    std::array<uint8_t, sizeof(fileSize)> oldSize{};
+    std::copy_n(iter, sizeof(fileSize), oldSize.begin());
+    std::copy_n(reinterpret_cast<uint8_t*>(&fileSize), sizeof(fileSize), iter);
+
+    checkSum = crc32::patch(checkSum, fileTable.size(), offset, oldSize.data(),
+                            &*iter, sizeof(fileSize));
+}
+
+bool FileTable::refresh(Handle handle)
+{
+    auto& stamp = stamps.at(handle);
+    const auto& fsPath = tableEntries.at(handle).fsPath;
+
+    struct stat st
+    {
+    };
+    if (stat(fsPath.c_str(), &st) < 0)
+    {
+        PLDM_LOG(ERR, "Failed to stat the file",
+                 entry("FILE=%s", fsPath.c_str()), entry("ERRNO=%d", errno));
+        return false;
+    }
+
+    uint32_t size = static_cast<uint32_t>(st.st_size);
+    uint64_t mtime = static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000 +
+                     st.st_mtim.tv_nsec;
+    if (stamp.valid && !stamp.stale && stamp.size == size &&
+        stamp.mtime == mtime)
+    {
+        return false;
+    }
+
+    // The OEM table carries the mtime too, so it is rebuilt even when the
+    // contents did not change
+    oemFileTable.clear();
+
+    // The CRC is combined from the CRCs of the blocks the digest cache has,
+    // so only the blocks written since the last refresh are read
+    uint32_t checksum = 0;
+    uint32_t length = size;
+    Digest digest;
+    auto rc = fileDigests().digest(handle, fsPath, DigestType::CRC32, 0,
+                                   length, digest);
+    if (rc == 0)
+    {
+        memcpy(&checksum, digest.data(), sizeof(checksum));
+        checksum = le32toh(checksum);
+    }
+    else if (rc != -ERANGE)
+    {
+        PLDM_LOG(ERR, "Failed to compute the checksum of the file",
+                 entry("FILE=%s", fsPath.c_str()), entry("RC=%d", rc));
+        return false;
+    }
+
+    bool changed = stamp.valid && stamp.checksum != checksum;
+    if (changed)
+    {
+        stamp.generation++;
+    }
+    if (!stamp.valid || stamp.size != size)
+    {
+        updateFileSize(handle, size);
+    }
+
+    stamp.valid = true;
+    stamp.stale = false;
+    stamp.size = size;
+    stamp.mtime = mtime;
+    stamp.checksum = checksum;
+    return changed;
+}
+
+void FileTable::invalidate(Handle handle)
+{
+    auto& stamp = stamps.at(handle);
+    const auto& fsPath = tableEntries.at(handle).fsPath;
+
+    struct stat st
+    {
+    };
+    if (stat(fsPath.c_str(), &st) < 0)
+    {
+        PLDM_LOG(ERR, "Failed to stat the file",
+                 entry("FILE=%s", fsPath.c_str()), entry("ERRNO=%d", errno));
+    }
+    else
+    {
+        updateFileSize(handle, static_cast<uint32_t>(st.st_size));
+    }
+
+    // The mtime may not have changed if the file was written within its
+    // granularity, so the stamp is recomputed regardless
+    stamp.stale = true;
+    oemFileTable.clear();
+}
+
+const Table& FileTable::oemTable()
+{
+    // Refreshing a stamp that changed drops the table, whether it was
+    // refreshed here or by a write before
+    for (const auto& entry : stamps)
+    {
+        refresh(entry.first);
+    }
+    if (!oemFileTable.empty() || stamps.empty())
+    {
+        return oemFileTable;
+    }
+
+    // The entries are a multiple of 4 bytes, so no pad bytes are needed
+    uint32_t tableChecksum = 0;
+    oemFileTable.resize(stamps.size() * sizeof(pldm_oem_file_attr_entry) +
+                        sizeof(tableChecksum));
+    auto oemEntry =
+        reinterpret_cast<pldm_oem_file_attr_entry*>(oemFileTable.data());
+    for (const auto& [handle, stamp] : stamps)
+    {
+        oemEntry->file_handle = htole32(handle);
+        oemEntry->checksum = htole32(stamp.checksum);
+        oemEntry->mtime = htole64(stamp.mtime);
+        oemEntry->generation = htole32(stamp.generation);
+        oemEntry->alignment = htole32(stamp.alignment);
+        oemEntry++;
+    }
+
+    auto entriesSize = oemFileTable.size() - sizeof(tableChecksum);
+    tableChecksum = crc32::compute(oemFileTable.data(), entriesSize);
+    std::copy_n(reinterpret_cast<const uint8_t*>(&tableChecksum),
+                sizeof(tableChecksum), oemFileTable.begin() + entriesSize);
+    return oemFileTable;
 }
 
 Table FileTable::operator()() const
 {
-    Table table(fileTable);
-    table.resize(fileTable.size() + sizeof(checkSum));
-    auto iter = table.begin() + fileTable.size();
+    Table table(size());
+    copyTo(table.data());
+    return table;
+}
+
+void FileTable::copyTo(uint8_t* buffer) const
+{
+    auto iter = std::copy(fileTable.begin(), fileTable.end(), buffer);
     std::copy_n(reinterpret_cast<const uint8_t*>(&checkSum), sizeof(checkSum),
                 iter);
-    return table;
 }
 
 FileTable& buildFileTable(const std::string& fileTablePath)
 {
     static FileTable table;
+    {
+        // Every request looks the table up, only the first one builds it
+        std::shared_lock<std::shared_mutex> lock(fileTableMutex());
+        if (!table.isEmpty())
+        {
+            return table;
+        }
+    }
+
+    std::lock_guard<std::shared_mutex> lock(fileTableMutex());
     if (table.isEmpty())
     {
         table = std::move(FileTable(fileTablePath));
@@ -125,5 +305,11 @@ FileTable& buildFileTable(const std::string& fileTablePath)
     return table;
 }
 
+std::shared_mutex& fileTableMutex()
+{
+    static std::shared_mutex mutex;
+    return mutex;
+}
+
 } // namespace filetable
 } // namespace pldm
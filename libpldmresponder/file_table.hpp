@@ -3,7 +3,10 @@
 #include <stdint.h>
 
 #include <filesystem>
+#include <map>
 #include <nlohmann/json.hpp>
+#include <shared_mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "libpldm/pldm_types.h"
@@ -19,6 +22,10 @@ using Handle = uint32_t;
 using Json = nlohmann::json;
 using Table = std::vector<uint8_t>;
 
+// The preferred transfer alignment, if the config file does not specify one,
+// is the minimum data size of a DMA transfer
+constexpr uint32_t defaultAlignment = 16;
+
 /** @struct FileEntry
  *
  *  Data structure for storing information regarding the files supported by
@@ -33,6 +40,26 @@ struct FileEntry
     bitfield32_t traits; //!< File traits
 };
 
+/** @struct FileStamp
+ *
+ *  Extended metadata of a file, reported in the OEM file attribute table. The
+ *  generation is incremented whenever the contents of the file are found to
+ *  have changed, so that the host can skip re-reading files it already has.
+ *  It starts from the time the table was built, in seconds since the Epoch,
+ *  so that generations of an earlier run of the responder are not handed
+ *  out again for different contents. The host compares the checksum as well.
+ */
+struct FileStamp
+{
+    bool valid = false;      //!< Whether the stamp has been computed
+    bool stale = false;      //!< Whether the file was written since
+    uint32_t size = 0;       //!< File size when the stamp was taken
+    uint64_t mtime = 0;      //!< Modification time in ns since the Epoch
+    uint32_t checksum = 0;   //!< CRC-32 of the file contents
+    uint32_t generation = 0; //!< Content generation counter
+    uint32_t alignment = defaultAlignment; //!< Preferred transfer alignment
+};
+
 /** @class FileTable
  *
  *  FileTable class encapsulates the data related to files supported by PLDM
@@ -64,6 +91,67 @@ class FileTable
      */
     Table operator()() const;
 
+    /** @brief Get the size of the file attribute table
+     *
+     * @return size_t - size of the table in bytes, including the checksum
+     */
+    size_t size() const
+    {
+        return fileTable.size() + sizeof(checkSum);
+    }
+
+    /** @brief Copy the file attribute table into a buffer
+     *
+     * @param[out] buffer - buffer of at least size() bytes
+     */
+    void copyTo(uint8_t* buffer) const;
+
+    /** @brief Get the OEM file attribute table
+     *
+     *  The metadata of files that were modified since it was last computed is
+     *  refreshed first.
+     *
+     * @return Table - contents of the OEM file attribute table, which stay
+     *                 valid until the next call
+     */
+    const Table& oemTable();
+
+    /** @brief Refresh the cached metadata of a file
+     *
+     *  The checksum is only recomputed if the stamp was invalidated or the
+     *  size or modification time of the file differs from it, and only the
+     *  blocks of the file whose CRCs the digest cache dropped are read. The
+     *  file size in the file attribute table is updated as well, and the OEM
+     *  file attribute table is rebuilt on its next read.
+     *
+     * @param[in] handle - file handle
+     *
+     * @return bool - true if the contents of the file changed, false otherwise.
+     */
+    bool refresh(Handle handle);
+
+    /** @brief Invalidate the cached metadata of a file written by the
+     *         responder
+     *
+     *  The file size in the file attribute table is updated, the stamp is
+     *  only recomputed by the next refresh so that writes do not read the
+     *  file.
+     *
+     * @param[in] handle - file handle
+     */
+    void invalidate(Handle handle);
+
+    /** @brief Get the cached metadata of a file
+     *
+     * @param[in] handle - file handle
+     *
+     * @return FileStamp - cached metadata of the file
+     */
+    FileStamp stamp(Handle handle) const
+    {
+        return stamps.at(handle);
+    }
+
     /** @brief Get the FileEntry at the file handle
      *
      * @param[in] handle - file handle
@@ -75,6 +163,16 @@ class FileTable
         return tableEntries.at(handle);
     }
 
+    /** @brief Update the file size of an entry in the file attribute table
+     *
+     *  The checksum of the table is patched with the changed bytes instead of
+     *  being recomputed over the whole table.
+     *
+     * @param[in] handle - file handle
+     * @param[in] fileSize - new size of the file
+     */
+    void updateFileSize(Handle handle, uint32_t fileSize);
+
     /** @brief Check is file attribute table is empty
      *
      * @return bool - true if file attribute table is empty, false otherwise.
@@ -90,6 +188,9 @@ class FileTable
     void clear()
     {
         tableEntries.clear();
+        sizeOffsets.clear();
+        stamps.clear();
+        oemFileTable.clear();
         fileTable.clear();
         padCount = 0;
         checkSum = 0;
@@ -99,6 +200,18 @@ class FileTable
     /** @brief handle to FileEntry mappings for lookups based on file handle */
     std::unordered_map<Handle, FileEntry> tableEntries;
 
+    /** @brief handle to the offset of the file size field of the entry in
+     *         the file attribute table */
+    std::unordered_map<Handle, size_t> sizeOffsets;
+
+    /** @brief handle to the cached metadata of the file, ordered by handle to
+     *         build the OEM file attribute table */
+    std::map<Handle, FileStamp> stamps;
+
+    /** @brief OEM file attribute table including the checksum, cleared by
+     *         refresh when a stamp changes and rebuilt by oemTable */
+    Table oemFileTable;
+
     /** @brief file attribute table including the pad bytes, except the checksum
      */
     std::vector<uint8_t> fileTable;
@@ -121,5 +234,15 @@ class FileTable
 
 FileTable& buildFileTable(const std::string& fileTablePath);
 
+/** @brief Get the lock of the file table returned by buildFileTable
+ *
+ *  Handlers run in parallel on the workers of the executor. They hold the
+ *  lock shared to look up file entries, and exclusively to refresh file
+ *  metadata or read the tables.
+ *
+ *  @return std::shared_mutex& - Reference to the lock
+ */
+std::shared_mutex& fileTableMutex();
+
 } // namespace filetable
 } // namespace pldm
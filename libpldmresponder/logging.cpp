@@ -0,0 +1,145 @@
+#include "logging.hpp"
+
+#include <unordered_set>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace logging
+{
+
+using phosphor::logging::level;
+
+namespace
+{
+
+std::mutex registryMutex;
+
+/** @brief the rate limiters that exist */
+std::unordered_set<RateLimiter*>& registry()
+{
+    static std::unordered_set<RateLimiter*> limiters;
+    return limiters;
+}
+
+/** @brief Log the count of suppressed messages of a call site */
+void logSuppressed(level severity, const char* msg, uint64_t suppressed)
+{
+    switch (severity)
+    {
+        case level::EMERG:
+            emit<level::EMERG>(suppressed, msg);
+            break;
+        case level::ALERT:
+            emit<level::ALERT>(suppressed, msg);
+            break;
+        case level::CRIT:
+            emit<level::CRIT>(suppressed, msg);
+            break;
+        case level::ERR:
+            emit<level::ERR>(suppressed, msg);
+            break;
+        case level::WARNING:
+            emit<level::WARNING>(suppressed, msg);
+            break;
+        case level::NOTICE:
+            emit<level::NOTICE>(suppressed, msg);
+            break;
+        case level::INFO:
+            emit<level::INFO>(suppressed, msg);
+            break;
+        case level::DEBUG:
+            emit<level::DEBUG>(suppressed, msg);
+            break;
+    }
+}
+
+} // namespace
+
+RateLimiter::RateLimiter(uint32_t burst, uint32_t perSecond) :
+    burst(burst),
+    interval(std::chrono::nanoseconds(std::chrono::seconds(1)) / perSecond),
+    tokens(burst)
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry().insert(this);
+}
+
+RateLimiter::~RateLimiter()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry().erase(this);
+}
+
+bool RateLimiter::allow(uint64_t& suppressed, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (tokens < burst)
+    {
+        auto refill = (now - refilled) / interval;
+        if (tokens + refill >= burst)
+        {
+            tokens = burst;
+        }
+        else if (refill > 0)
+        {
+            tokens += refill;
+            refilled += refill * interval;
+        }
+    }
+
+    if (!tokens)
+    {
+        ++dropped;
+        return false;
+    }
+    if (tokens == burst)
+    {
+        // Refill from the first token taken out of a full bucket
+        refilled = now;
+    }
+    --tokens;
+    suppressed = dropped;
+    dropped = 0;
+    return true;
+}
+
+void RateLimiter::label(level severity, const char* msg)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->severity = severity;
+    message = msg;
+}
+
+uint64_t RateLimiter::takeSuppressed(level& severity, const char*& msg)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    severity = this->severity;
+    msg = message;
+    auto suppressed = dropped;
+    dropped = 0;
+    return suppressed;
+}
+
+void flushSuppressed()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto limiter : registry())
+    {
+        level severity{};
+        const char* msg = nullptr;
+        auto suppressed = limiter->takeSuppressed(severity, msg);
+        if (suppressed && msg)
+        {
+            logSuppressed(severity, msg, suppressed);
+        }
+    }
+}
+
+} // namespace logging
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "config.h"
+
+#include <stdint.h>
+
+#include <chrono>
+#include <mutex>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace logging
+{
+
+// Messages of a less severe level than this are compiled out, see
+// --with-log-level
+#ifdef PLDM_LOG_LEVEL
+constexpr auto maxLevel = static_cast<phosphor::logging::level>(PLDM_LOG_LEVEL);
+#else
+constexpr auto maxLevel = phosphor::logging::level::INFO;
+#endif
+
+/** @brief Check if messages of a level are compiled in
+ *
+ *  @param[in] severity - level of the message
+ *
+ *  @return bool - true if messages of the level are logged
+ */
+constexpr bool enabled(phosphor::logging::level severity)
+{
+    return severity <= maxLevel;
+}
+
+/** @class RateLimiter
+ *
+ *  Token bucket that limits the rate of a log message. A burst of messages
+ *  is let through, after which messages are let through at the refill rate
+ *  and the rest are counted as suppressed. The count is logged with the next
+ *  message let through, or by flushSuppressed if the storm ends first.
+ */
+class RateLimiter
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief Create a rate limiter
+     *
+     * @param[in] burst - number of messages let through back to back
+     * @param[in] perSecond - number of messages let through per second after
+     *                        the burst
+     */
+    explicit RateLimiter(uint32_t burst = 10, uint32_t perSecond = 1);
+    ~RateLimiter();
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    /** @brief Take a token for a message
+     *
+     * @param[out] suppressed - number of messages suppressed since the last
+     *                          message let through, set if the message is let
+     *                          through
+     * @param[in] now - current time
+     *
+     * @return bool - true if the message is to be logged
+     */
+    bool allow(uint64_t& suppressed, Clock::time_point now = Clock::now());
+
+    /** @brief Set the message and level the suppressed messages are
+     *         reported with by flushSuppressed
+     *
+     * @param[in] severity - level of the message
+     * @param[in] msg - message, a string literal
+     */
+    void label(phosphor::logging::level severity, const char* msg);
+
+    /** @brief Take the count of messages suppressed since the last message
+     *         let through
+     *
+     * @param[out] severity - level of the message
+     * @param[out] msg - message, nullptr if none was let through yet
+     *
+     * @return number of messages suppressed
+     */
+    uint64_t takeSuppressed(phosphor::logging::level& severity,
+                            const char*& msg);
+
+  private:
+    /** @brief number of messages let through back to back */
+    uint32_t burst;
+
+    /** @brief time to refill a token */
+    Clock::duration interval;
+
+    /** @brief tokens left */
+    uint32_t tokens;
+
+    /** @brief time up to which tokens have been refilled, while the bucket
+     *         is not full */
+    Clock::time_point refilled{};
+
+    /** @brief messages suppressed since the last message let through */
+    uint64_t dropped = 0;
+
+    /** @brief level of the message */
+    phosphor::logging::level severity = phosphor::logging::level::ERR;
+
+    /** @brief message, set when the first message is let through */
+    const char* message = nullptr;
+
+    std::mutex mutex;
+};
+
+/** @brief Log a message that was let through a rate limiter, with the
+ *         number of messages suppressed before it
+ *
+ *  @tparam L - level of the message
+ *  @param[in] suppressed - number of messages suppressed
+ *  @param[in] msg - message
+ *  @param[in] entries - metadata of the message
+ */
+template <phosphor::logging::level L, typename... Entries>
+void emit(uint64_t suppressed, const char* msg, Entries&&... entries)
+{
+    using namespace phosphor::logging;
+    if (suppressed)
+    {
+        log<L>(msg, std::forward<Entries>(entries)...,
+               entry("SUPPRESSED=%llu",
+                     static_cast<unsigned long long>(suppressed)));
+    }
+    else
+    {
+        log<L>(msg, std::forward<Entries>(entries)...);
+    }
+}
+
+/** @brief Log a message that was let through a rate limiter, and label the
+ *         limiter with it
+ *
+ *  @tparam L - level of the message
+ *  @param[in] limiter - rate limiter of the call site
+ *  @param[in] suppressed - number of messages suppressed
+ *  @param[in] msg - message
+ *  @param[in] entries - metadata of the message
+ */
+template <phosphor::logging::level L, typename... Entries>
+void emit(RateLimiter& limiter, uint64_t suppressed, const char* msg,
+          Entries&&... entries)
+{
+    limiter.label(L, msg);
+    emit<L>(suppressed, msg, std::forward<Entries>(entries)...);
+}
+
+/** @brief Log the number of messages suppressed at every call site since
+ *         the last message let through
+ *
+ *  Without this, the count at the end of a storm would only be logged with
+ *  the next message of the call site. It is called on a timer and at exit.
+ */
+void flushSuppressed();
+
+} // namespace logging
+} // namespace responder
+} // namespace pldm
+
+/** @brief Log a message from the request path
+ *
+ *  Each call site has its own rate limiter, so that a flood of one error
+ *  does not hide others. The metadata arguments are only evaluated for
+ *  messages that are logged, and call sites of levels above the build
+ *  threshold compile to nothing.
+ *
+ *  @param[in] lvl - level of the message, e.g. ERR
+ *  @param[in] ... - message followed by its entry() metadata
+ */
+#define PLDM_LOG(lvl, ...)                                                     \
+    do                                                                         \
+    {                                                                          \
+        if constexpr (::pldm::responder::logging::enabled(                     \
+                          ::phosphor::logging::level::lvl))                    \
+        {                                                                      \
+            static ::pldm::responder::logging::RateLimiter pldmLogLimiter;     \
+            uint64_t pldmLogSuppressed = 0;                                    \
+            if (pldmLogLimiter.allow(pldmLogSuppressed))                       \
+            {                                                                  \
+                ::pldm::responder::logging::emit<                              \
+                    ::phosphor::logging::level::lvl>(                          \
+                    pldmLogLimiter, pldmLogSuppressed, __VA_ARGS__);           \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
@@ -0,0 +1,469 @@
+#include "metrics.hpp"
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace metrics
+{
+
+namespace
+{
+
+// Number of type, command and completion code combinations that get their
+// own histogram
+constexpr size_t slotCount = 32;
+
+// Set in every claimed key, so that a key of 0 marks a free slot
+constexpr uint32_t claimed = 1 << 24;
+
+/** @struct Slot
+ *
+ *  Histogram of a type, command and completion code combination
+ */
+struct Slot
+{
+    std::atomic<uint32_t> key{0};
+    Histogram histogram;
+};
+
+std::array<Slot, slotCount> slots;
+Histogram overflow;
+
+std::atomic<uint64_t> bytesToHost{0};
+std::atomic<uint64_t> bytesFromHost{0};
+std::atomic<uint64_t> chunks{0};
+std::atomic<uint64_t> chunkErrors{0};
+std::atomic<uint64_t> retries{0};
+std::atomic<uint64_t> recovered{0};
+std::atomic<uint64_t> bytesWritten{0};
+std::atomic<uint64_t> bytesSkipped{0};
+
+Histogram admissionWait;
+std::atomic<uint64_t> notAdmitted{0};
+
+// Sections added by other modules, rendered at the end of a dump
+std::vector<Section> sections;
+std::mutex sectionsMutex;
+
+uint32_t makeKey(uint8_t type, uint8_t command, uint8_t completionCode)
+{
+    return claimed | (type << 16) | (command << 8) | completionCode;
+}
+
+/** @brief Find the slot of a key, claiming a free one if create is set
+ *
+ *  @return the slot, or nullptr if there is none
+ */
+Slot* findSlot(uint32_t key, bool create)
+{
+    size_t start = (key * 2654435761u) % slotCount;
+    for (size_t i = 0; i < slotCount; ++i)
+    {
+        auto& slot = slots[(start + i) % slotCount];
+        auto current = slot.key.load(std::memory_order_acquire);
+        if (current == key)
+        {
+            return &slot;
+        }
+        if (current == 0)
+        {
+            if (!create)
+            {
+                return nullptr;
+            }
+            if (slot.key.compare_exchange_strong(current, key) ||
+                current == key)
+            {
+                return &slot;
+            }
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+uint64_t Histogram::percentile(double percent) const
+{
+    uint64_t recorded = count();
+    if (!recorded)
+    {
+        return 0;
+    }
+
+    // Nearest rank: the smallest value at or above percent of the values
+    auto rank = static_cast<uint64_t>(std::ceil(percent / 100 * recorded));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucketCount; ++i)
+    {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            return std::min(bucketUpperBound(i), maxValue());
+        }
+    }
+    return maxValue();
+}
+
+void Histogram::clear()
+{
+    for (auto& bucket : buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+void recordCommand(uint8_t type, uint8_t command, uint8_t completionCode,
+                   std::chrono::nanoseconds latency)
+{
+    auto slot = findSlot(makeKey(type, command, completionCode), true);
+    auto& histogram = slot ? slot->histogram : overflow;
+    histogram.record(latency.count());
+}
+
+void recordChunk(uint32_t length, bool upstream, bool success)
+{
+    if (!success)
+    {
+        chunkErrors.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    chunks.fetch_add(1, std::memory_order_relaxed);
+    (upstream ? bytesToHost : bytesFromHost)
+        .fetch_add(length, std::memory_order_relaxed);
+}
+
+void recordRetry()
+{
+    retries.fetch_add(1, std::memory_order_relaxed);
+}
+
+void recordRecovery()
+{
+    recovered.fetch_add(1, std::memory_order_relaxed);
+}
+
+void recordDedup(uint64_t written, uint64_t skipped)
+{
+    bytesWritten.fetch_add(written, std::memory_order_relaxed);
+    bytesSkipped.fetch_add(skipped, std::memory_order_relaxed);
+}
+
+void recordAdmission(std::chrono::nanoseconds delay, bool admitted)
+{
+    if (!admitted)
+    {
+        notAdmitted.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    admissionWait.record(delay.count());
+}
+
+const Histogram& admissionDelay()
+{
+    return admissionWait;
+}
+
+const Histogram* commandHistogram(uint8_t type, uint8_t command,
+                                  uint8_t completionCode)
+{
+    auto slot = findSlot(makeKey(type, command, completionCode), false);
+    return slot ? &slot->histogram : nullptr;
+}
+
+Counters counters()
+{
+    Counters snapshot{};
+    snapshot.bytesToHost = bytesToHost.load(std::memory_order_relaxed);
+    snapshot.bytesFromHost = bytesFromHost.load(std::memory_order_relaxed);
+    snapshot.chunks = chunks.load(std::memory_order_relaxed);
+    snapshot.chunkErrors = chunkErrors.load(std::memory_order_relaxed);
+    snapshot.retries = retries.load(std::memory_order_relaxed);
+    snapshot.recovered = recovered.load(std::memory_order_relaxed);
+    snapshot.notAdmitted = notAdmitted.load(std::memory_order_relaxed);
+    snapshot.bytesWritten = bytesWritten.load(std::memory_order_relaxed);
+    snapshot.bytesSkipped = bytesSkipped.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+namespace
+{
+
+void dumpHistogram(std::ostringstream& out, const Histogram& histogram)
+{
+    out << " count=" << histogram.count()
+        << " sum_ns=" << histogram.totalValue()
+        << " p50_ns=" << histogram.percentile(50)
+        << " p90_ns=" << histogram.percentile(90)
+        << " p99_ns=" << histogram.percentile(99)
+        << " max_ns=" << histogram.maxValue() << "\n";
+}
+
+/** @struct PendingDump
+ *
+ *  Dump being sent to a client of the metrics socket
+ */
+struct PendingDump
+{
+    std::string text;
+    size_t written = 0;
+};
+
+/** @brief Send as much of a dump as the socket of a client takes
+ *
+ *  @param[in] client - non-blocking socket of the client
+ *  @param[in,out] pending - the dump and the bytes sent so far
+ *
+ *  @return bool - true if the client is done with, because the whole dump
+ *                 was sent or the send failed
+ */
+bool sendSome(int client, PendingDump& pending)
+{
+    while (pending.written < pending.text.size())
+    {
+        auto count = send(client, pending.text.data() + pending.written,
+                          pending.text.size() - pending.written, MSG_NOSIGNAL);
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return false;
+        }
+        if (count <= 0)
+        {
+            return true;
+        }
+        pending.written += count;
+    }
+    return true;
+}
+
+} // namespace
+
+std::string dump()
+{
+    std::ostringstream out;
+    for (const auto& slot : slots)
+    {
+        auto key = slot.key.load(std::memory_order_acquire);
+        if (!key)
+        {
+            continue;
+        }
+        out << "command type=" << ((key >> 16) & 0xFF)
+            << " command=" << ((key >> 8) & 0xFF) << " cc=" << (key & 0xFF);
+        dumpHistogram(out, slot.histogram);
+    }
+    if (overflow.count())
+    {
+        out << "command overflow";
+        dumpHistogram(out, overflow);
+    }
+
+    auto snapshot = counters();
+    out << "dma bytes_to_host=" << snapshot.bytesToHost
+        << " bytes_from_host=" << snapshot.bytesFromHost
+        << " chunks=" << snapshot.chunks
+        << " chunk_errors=" << snapshot.chunkErrors
+        << " retries=" << snapshot.retries
+        << " recovered=" << snapshot.recovered << "\n";
+    out << "dedup bytes_written=" << snapshot.bytesWritten
+        << " bytes_skipped=" << snapshot.bytesSkipped << "\n";
+    out << "admission not_admitted=" << snapshot.notAdmitted;
+    dumpHistogram(out, admissionWait);
+
+    std::lock_guard<std::mutex> lock(sectionsMutex);
+    for (const auto& section : sections)
+    {
+        out << section();
+    }
+    return out.str();
+}
+
+void addSection(Section section)
+{
+    std::lock_guard<std::mutex> lock(sectionsMutex);
+    sections.push_back(std::move(section));
+}
+
+int dumpToFile(const std::string& path)
+{
+    auto text = dump();
+    auto tmpPath = path + ".tmp";
+
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                  0644);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+
+    size_t written = 0;
+    while (written < text.size())
+    {
+        auto rc = write(fd, text.data() + written, text.size() - written);
+        if (rc < 0)
+        {
+            rc = -errno;
+            close(fd);
+            unlink(tmpPath.c_str());
+            return rc;
+        }
+        written += rc;
+    }
+    close(fd);
+
+    if (rename(tmpPath.c_str(), path.c_str()) < 0)
+    {
+        auto rc = -errno;
+        unlink(tmpPath.c_str());
+        return rc;
+    }
+    return 0;
+}
+
+int dumpPeriodically(EventLoop& loop, const std::string& path,
+                     std::chrono::milliseconds interval)
+{
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+
+    itimerspec spec{};
+    spec.it_interval.tv_sec = interval.count() / 1000;
+    spec.it_interval.tv_nsec = (interval.count() % 1000) * 1000000;
+    spec.it_value = spec.it_interval;
+    if (timerfd_settime(fd, 0, &spec, nullptr) < 0)
+    {
+        auto rc = -errno;
+        close(fd);
+        return rc;
+    }
+
+    // The timer runs for the life of the process, so the descriptor is
+    // never closed
+    auto rc = loop.addIO(fd, EPOLLIN, [fd, path](uint32_t) {
+        uint64_t expirations = 0;
+        if (read(fd, &expirations, sizeof(expirations)) > 0)
+        {
+            dumpToFile(path);
+        }
+    });
+    if (rc < 0)
+    {
+        close(fd);
+    }
+    return rc;
+}
+
+int serve(EventLoop& loop, const std::string& path)
+{
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        return -ENAMETOOLONG;
+    }
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(fd, 4) < 0)
+    {
+        auto rc = -errno;
+        close(fd);
+        return rc;
+    }
+
+    // The socket is served for the life of the process, so the descriptor
+    // is never closed
+    auto rc = loop.addIO(fd, EPOLLIN, [&loop, fd](uint32_t) {
+        int client = -1;
+        while ((client = accept4(fd, nullptr, nullptr,
+                                 SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+        {
+            auto pending = std::make_shared<PendingDump>();
+            pending->text = dump();
+            if (sendSome(client, *pending))
+            {
+                close(client);
+                continue;
+            }
+
+            // The rest is sent as the client drains its socket, so a client
+            // that does not read never blocks the loop
+            auto added = loop.addIO(
+                client, EPOLLOUT, [&loop, client, pending](uint32_t) {
+                    if (sendSome(client, *pending))
+                    {
+                        loop.removeIO(client);
+                        close(client);
+                    }
+                });
+            if (added < 0)
+            {
+                close(client);
+            }
+        }
+    });
+    if (rc < 0)
+    {
+        close(fd);
+    }
+    return rc;
+}
+
+void reset()
+{
+    for (auto& slot : slots)
+    {
+        slot.histogram.clear();
+        slot.key.store(0, std::memory_order_release);
+    }
+    overflow.clear();
+    bytesToHost = 0;
+    bytesFromHost = 0;
+    chunks = 0;
+    chunkErrors = 0;
+    retries = 0;
+    recovered = 0;
+    bytesWritten = 0;
+    bytesSkipped = 0;
+    admissionWait.clear();
+    notAdmitted = 0;
+}
+
+} // namespace metrics
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+
+#include "event_loop.hpp"
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace metrics
+{
+
+/** @class Histogram
+ *
+ *  Lock-free log-linear histogram of durations in nanoseconds. Values are
+ *  grouped by their highest set bit, and every group is split into
+ *  subBuckets linear buckets, so that a bucket is at most 1/subBuckets of
+ *  its lower bound wide whatever the magnitude. Recording is a few relaxed
+ *  atomic increments.
+ */
+class Histogram
+{
+  public:
+    /** @brief Number of linear buckets in each power of two group, 2^3 gives
+     *         a relative error of at most 12.5% */
+    static constexpr size_t subBucketBits = 3;
+    static constexpr size_t subBuckets = 1 << subBucketBits;
+
+    /** @brief Number of power of two groups, values of 2^groups ns (about
+     *         18 minutes) and above land in the last bucket */
+    static constexpr size_t groups = 40;
+
+    static constexpr size_t bucketCount =
+        (groups - subBucketBits + 1) * subBuckets;
+
+    /** @brief Get the index of the bucket that holds a value */
+    static constexpr size_t bucketIndex(uint64_t value)
+    {
+        if (value < subBuckets)
+        {
+            return value;
+        }
+        size_t msb = 63 - __builtin_clzll(value);
+        if (msb >= groups)
+        {
+            return bucketCount - 1;
+        }
+        size_t shift = msb - subBucketBits;
+        return (shift + 1) * subBuckets + ((value >> shift) & (subBuckets - 1));
+    }
+
+    /** @brief Get the largest value that falls in a bucket */
+    static constexpr uint64_t bucketUpperBound(size_t index)
+    {
+        if (index < subBuckets)
+        {
+            return index;
+        }
+        size_t shift = index / subBuckets - 1;
+        uint64_t lower = (subBuckets + index % subBuckets) << shift;
+        return lower + (uint64_t(1) << shift) - 1;
+    }
+
+    /** @brief Record a value
+     *
+     * @param[in] value - duration in nanoseconds
+     */
+    void record(uint64_t value)
+    {
+        buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+
+        auto seen = max.load(std::memory_order_relaxed);
+        while (value > seen &&
+               !max.compare_exchange_weak(seen, value,
+                                          std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /** @brief Get the number of recorded values */
+    uint64_t count() const
+    {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Get the sum of the recorded values */
+    uint64_t totalValue() const
+    {
+        return sum.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Get the largest recorded value */
+    uint64_t maxValue() const
+    {
+        return max.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Get an upper bound of a percentile of the recorded values
+     *
+     *  The percentile is taken by nearest rank, the rank is rounded up so
+     *  that a high percentile of a few values is not under-reported.
+     *
+     * @param[in] percent - percentile, between 0 and 100
+     *
+     * @return upper bound of the bucket that holds the percentile, or 0 if
+     *         nothing was recorded
+     */
+    uint64_t percentile(double percent) const;
+
+    /** @brief Drop the recorded values */
+    void clear();
+
+  private:
+    std::array<std::atomic<uint64_t>, bucketCount> buckets{};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+};
+
+/** @brief Record the latency of a command
+ *
+ *  Histograms are kept per PLDM type, command and completion code. The first
+ *  request with a new combination claims a histogram from a fixed pool
+ *  without taking a lock. Once the pool is used up, new combinations are
+ *  counted in an overflow histogram.
+ *
+ *  @param[in] type - PLDM type
+ *  @param[in] command - PLDM command
+ *  @param[in] completionCode - completion code of the response
+ *  @param[in] latency - time taken to handle the request
+ */
+void recordCommand(uint8_t type, uint8_t command, uint8_t completionCode,
+                   std::chrono::nanoseconds latency);
+
+/** @brief Record a DMA transfer of one chunk
+ *
+ *  @param[in] length - number of bytes transferred
+ *  @param[in] upstream - true for a transfer to the host
+ *  @param[in] success - whether the transfer succeeded
+ */
+void recordChunk(uint32_t length, bool upstream, bool success);
+
+/** @brief Record a retry of a DMA chunk after a transient failure */
+void recordRetry();
+
+/** @brief Record a DMA chunk that succeeded after it was retried */
+void recordRecovery();
+
+/** @brief Record a write of data from the host to a file
+ *
+ *  @param[in] written - number of bytes written to storage
+ *  @param[in] skipped - number of bytes not written because the file already
+ *                       held them
+ */
+void recordDedup(uint64_t written, uint64_t skipped);
+
+/** @brief Record the time a DMA chunk waited to be admitted within the
+ *         budget of bytes in flight
+ *
+ *  @param[in] delay - time the chunk waited
+ *  @param[in] admitted - false if the chunk gave up waiting
+ */
+void recordAdmission(std::chrono::nanoseconds delay, bool admitted);
+
+/** @brief Get the histogram of the time DMA chunks waited to be admitted */
+const Histogram& admissionDelay();
+
+/** @brief Get the histogram of a command
+ *
+ *  @param[in] type - PLDM type
+ *  @param[in] command - PLDM command
+ *  @param[in] completionCode - completion code of the response
+ *
+ *  @return the histogram, or nullptr if no request was recorded for it
+ */
+const Histogram* commandHistogram(uint8_t type, uint8_t command,
+                                  uint8_t completionCode);
+
+/** @struct Counters
+ *
+ *  Snapshot of the DMA counters
+ */
+struct Counters
+{
+    uint64_t bytesToHost = 0;   //!< Bytes transferred to the host
+    uint64_t bytesFromHost = 0; //!< Bytes transferred from the host
+    uint64_t chunks = 0;        //!< DMA chunks transferred
+    uint64_t chunkErrors = 0;   //!< DMA chunks that failed
+    uint64_t retries = 0;       //!< Retries of DMA chunks
+    uint64_t recovered = 0;     //!< DMA chunks that succeeded on a retry
+    uint64_t notAdmitted = 0;   //!< DMA chunks that gave up waiting for the
+                                //!< budget of bytes in flight
+    uint64_t bytesWritten = 0;  //!< Bytes from the host written to storage
+    uint64_t bytesSkipped = 0;  //!< Bytes from the host that were unchanged
+};
+
+/** @brief Get a snapshot of the DMA counters */
+Counters counters();
+
+/** @brief Render all the metrics as text, one metric per line
+ *
+ *  @return the metrics, in a key=value format meant for scripts
+ */
+std::string dump();
+
+/** @brief Function that renders metrics kept by another module as text, one
+ *         metric per line
+ */
+using Section = std::function<std::string()>;
+
+/** @brief Add a section to the output of dump
+ *
+ *  Modules that build on this one, such as the file accounting, cannot be
+ *  rendered by it. The responder adds their sections at startup, and every
+ *  dump renders them after the metrics of this module.
+ *
+ *  @param[in] section - renders the section
+ */
+void addSection(Section section);
+
+/** @brief Write the metrics to a file, replacing it atomically
+ *
+ *  @param[in] path - pathname of the file
+ *
+ *  @return 0 on success, negative errno on failure
+ */
+int dumpToFile(const std::string& path);
+
+/** @brief Write the metrics to a file periodically from an event loop
+ *
+ *  @param[in] loop - event loop to run the timer on
+ *  @param[in] path - pathname of the file
+ *  @param[in] interval - time between two writes
+ *
+ *  @return 0 on success, negative errno on failure
+ */
+int dumpPeriodically(EventLoop& loop, const std::string& path,
+                     std::chrono::milliseconds interval);
+
+/** @brief Serve the metrics on a Unix stream socket from an event loop
+ *
+ *  Every client that connects is sent the output of dump, and the
+ *  connection is closed. The sockets of the clients are non-blocking, the
+ *  part of the dump that does not fit in the socket buffer is sent as the
+ *  client reads.
+ *
+ *  @param[in] loop - event loop to accept connections on
+ *  @param[in] path - pathname of the socket, replaced if it exists
+ *
+ *  @return 0 on success, negative errno on failure
+ */
+int serve(EventLoop& loop, const std::string& path);
+
+/** @brief Reset all the metrics, e.g. between benchmark runs
+ */
+void reset();
+
+/** @class Timer
+ *
+ *  Measures the time from its creation
+ */
+class Timer
+{
+  public:
+    Timer() : start(std::chrono::steady_clock::now())
+    {
+    }
+
+    std::chrono::nanoseconds elapsed() const
+    {
+        return std::chrono::steady_clock::now() - start;
+    }
+
+  private:
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace metrics
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,155 @@
+#include "range_lock.hpp"
+
+#include <algorithm>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace
+{
+
+/** @brief Remove one range equal to a range from a list */
+void erase(std::vector<RangeLockManager::Range>& ranges,
+           const RangeLockManager::Range& range)
+{
+    auto found = std::find_if(
+        ranges.begin(), ranges.end(),
+        [&range](const RangeLockManager::Range& other) {
+            return other.offset == range.offset &&
+                   other.length == range.length &&
+                   other.exclusive == range.exclusive;
+        });
+    if (found != ranges.end())
+    {
+        ranges.erase(found);
+    }
+}
+
+} // namespace
+
+bool RangeLockManager::conflicts(const std::string& path,
+                                 const Range& range) const
+{
+    auto conflict = [&range](const Range& other) {
+        return (range.exclusive || other.exclusive) && range.overlaps(other);
+    };
+
+    auto iter = held.find(path);
+    if (iter != held.end() &&
+        std::any_of(iter->second.begin(), iter->second.end(), conflict))
+    {
+        return true;
+    }
+
+    // Writers wait for the held locks only, readers for the writers too
+    if (range.exclusive)
+    {
+        return false;
+    }
+    auto waiting = queued.find(path);
+    if (waiting != queued.end() &&
+        std::any_of(waiting->second.begin(), waiting->second.end(), conflict))
+    {
+        return true;
+    }
+    auto trying = waiters.find(path);
+    return trying != waiters.end() &&
+           std::any_of(trying->second.begin(), trying->second.end(),
+                       [&conflict](const Waiting& waiter) {
+                           return conflict(waiter.range);
+                       });
+}
+
+RangeLockManager::Guard RangeLockManager::lock(const fs::path& path,
+                                               uint64_t offset,
+                                               uint64_t length, bool exclusive)
+{
+    Range range{offset, length, exclusive};
+    std::string key = path.string();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (conflicts(key, range))
+    {
+        if (exclusive)
+        {
+            queued[key].push_back(range);
+        }
+        released.wait(lock, [&] { return !conflicts(key, range); });
+        if (exclusive)
+        {
+            auto iter = queued.find(key);
+            erase(iter->second, range);
+            if (iter->second.empty())
+            {
+                queued.erase(iter);
+            }
+        }
+    }
+    held[key].push_back(range);
+    return Guard(this, std::move(key), range);
+}
+
+bool RangeLockManager::tryLock(const fs::path& path, uint64_t offset,
+                               uint64_t length, bool exclusive, Waiter wake)
+{
+    Range range{offset, length, exclusive};
+    std::string key = path.string();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (conflicts(key, range))
+    {
+        if (wake)
+        {
+            waiters[key].push_back({std::move(wake), range});
+        }
+        return false;
+    }
+    held[key].push_back(range);
+    return true;
+}
+
+void RangeLockManager::unlock(const std::string& path, const Range& range)
+{
+    std::vector<Waiting> woken;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto iter = held.find(path);
+        if (iter == held.end())
+        {
+            return;
+        }
+
+        // Woken writers no longer hold readers back until they try again
+        auto waiting = waiters.find(path);
+        if (waiting != waiters.end())
+        {
+            woken.swap(waiting->second);
+            waiters.erase(waiting);
+        }
+
+        auto& ranges = iter->second;
+        erase(ranges, range);
+        if (ranges.empty())
+        {
+            held.erase(iter);
+        }
+    }
+    released.notify_all();
+
+    for (auto& waiter : woken)
+    {
+        waiter.wake();
+    }
+}
+
+RangeLockManager& rangeLocks()
+{
+    static RangeLockManager manager;
+    return manager;
+}
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace fs = std::filesystem;
+
+/** @class RangeLockManager
+ *
+ *  RangeLockManager grants locks on byte ranges of files, so that transfers
+ *  to different regions of one file proceed in parallel while transfers to
+ *  overlapping regions are serialised. Reads take shared locks, which only
+ *  conflict with overlapping exclusive locks; writes take exclusive locks,
+ *  which conflict with any overlapping lock.
+ *
+ *  Locks are meant to be held for one DMA chunk at a time, so a waiting
+ *  writer is not starved by a long transfer. Nor is it starved by a stream
+ *  of readers: a shared lock is refused while a writer waits for an
+ *  exclusive lock of an overlapping range, in lock or in tryLock until it is
+ *  woken.
+ */
+class RangeLockManager
+{
+  public:
+    /** @struct Range
+     *
+     *  A locked byte range of a file
+     */
+    struct Range
+    {
+        uint64_t offset = 0;    //!< Offset of the first byte
+        uint64_t length = 0;    //!< Number of bytes
+        bool exclusive = false; //!< Whether the lock is exclusive
+
+        bool overlaps(const Range& other) const
+        {
+            return offset < other.offset + other.length &&
+                   other.offset < offset + length;
+        }
+    };
+
+    /** @class Guard
+     *
+     *  Releases a range lock when it goes out of scope
+     */
+    class Guard
+    {
+      public:
+        Guard(RangeLockManager* manager, std::string path, Range range) :
+            manager(manager), path(std::move(path)), range(range)
+        {
+        }
+
+        Guard() = delete;
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        Guard(Guard&& other) :
+            manager(other.manager), path(std::move(other.path)),
+            range(other.range)
+        {
+            other.manager = nullptr;
+        }
+
+        Guard& operator=(Guard&&) = delete;
+
+        ~Guard()
+        {
+            if (manager)
+            {
+                manager->unlock(path, range);
+            }
+        }
+
+      private:
+        RangeLockManager* manager;
+        std::string path;
+        Range range;
+    };
+
+    RangeLockManager() = default;
+    ~RangeLockManager() = default;
+    RangeLockManager(const RangeLockManager&) = delete;
+    RangeLockManager& operator=(const RangeLockManager&) = delete;
+
+    /** @brief Lock a byte range of a file, waiting until no conflicting lock
+     *         is held
+     *
+     * @param[in] path - pathname of the file
+     * @param[in] offset - offset of the range in the file
+     * @param[in] length - length of the range
+     * @param[in] exclusive - true for a write lock, false for a read lock
+     *
+     * @return Guard - releases the lock when destroyed
+     */
+    Guard lock(const fs::path& path, uint64_t offset, uint64_t length,
+               bool exclusive);
+
+    /** @brief Called when a lock may have become free, see tryLock */
+    using Waiter = std::function<void()>;
+
+    /** @brief Try to lock a byte range of a file without waiting
+     *
+     * @param[in] path - pathname of the file
+     * @param[in] offset - offset of the range in the file
+     * @param[in] length - length of the range
+     * @param[in] exclusive - true for a write lock, false for a read lock
+     * @param[in] wake - if the range is not locked, called once on the
+     *                   thread that next releases a lock of the file
+     *
+     * @return bool - true if the range was locked and must be released with
+     *                unlock, false if a conflicting lock is held
+     */
+    bool tryLock(const fs::path& path, uint64_t offset, uint64_t length,
+                 bool exclusive, Waiter wake = nullptr);
+
+    /** @brief Release a range locked with tryLock
+     *
+     * @param[in] path - pathname of the file
+     * @param[in] range - the locked range
+     */
+    void unlock(const std::string& path, const Range& range);
+
+  private:
+    /** @struct Waiting
+     *
+     *  A caller of tryLock waiting for a lock of a file to be released
+     */
+    struct Waiting
+    {
+        Waiter wake; //!< Called when a lock of the file is released
+        Range range; //!< The range it failed to lock
+    };
+
+    /** @brief Check if a range conflicts with a held lock, or a shared range
+     *         with an exclusive lock a writer waits for, with the mutex held
+     */
+    bool conflicts(const std::string& path, const Range& range) const;
+
+    /** @brief file pathname to the ranges locked in it */
+    std::unordered_map<std::string, std::vector<Range>> held;
+
+    /** @brief file pathname to the exclusive ranges callers of lock wait
+     *         for */
+    std::unordered_map<std::string, std::vector<Range>> queued;
+
+    /** @brief file pathname to the callers of tryLock waiting for a lock of
+     *         it to be released */
+    std::unordered_map<std::string, std::vector<Waiting>> waiters;
+
+    std::mutex mutex;
+    std::condition_variable released;
+};
+
+/** @brief Get the range lock manager of the responder
+ *
+ *  @return RangeLockManager& - Reference to instance of range lock manager
+ */
+RangeLockManager& rangeLocks();
+
+} // namespace responder
+} // namespace pldm
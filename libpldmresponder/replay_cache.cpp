@@ -0,0 +1,140 @@
+#include "replay_cache.hpp"
+
+#include "crc32.hpp"
+
+namespace pldm
+{
+
+namespace responder
+{
+
+bool ReplayCache::lookup(uint8_t eid, const pldm_msg* request,
+                         size_t requestLength, Response& response,
+                         Clock::time_point now)
+{
+    size_t payloadLength = requestLength - sizeof(pldm_msg_hdr);
+    auto payloadHash = crc32::compute(request->payload, payloadLength);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto iter = requesters.find(eid);
+    if (iter == requesters.end())
+    {
+        return false;
+    }
+
+    auto& entry = iter->second[request->hdr.instance_id];
+    if (!entry.valid || now - entry.time > window ||
+        !holds(entry, request, payloadLength, payloadHash))
+    {
+        return false;
+    }
+
+    response = entry.response;
+    ++hitCount;
+    return true;
+}
+
+void ReplayCache::store(uint8_t eid, const pldm_msg* request,
+                        size_t requestLength, const uint8_t* response,
+                        size_t responseLength, Clock::time_point now)
+{
+    finish(eid, request, requestLength, response, responseLength, true, now);
+}
+
+ReplayCache::Start ReplayCache::start(uint8_t eid, const pldm_msg* request,
+                                      size_t requestLength, Response& response,
+                                      Waiter wait, Clock::time_point now)
+{
+    size_t payloadLength = requestLength - sizeof(pldm_msg_hdr);
+    auto payloadHash = crc32::compute(request->payload, payloadLength);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = requesters[eid][request->hdr.instance_id];
+    if (holds(entry, request, payloadLength, payloadHash))
+    {
+        // A running request is waited for however long it takes
+        if (entry.running)
+        {
+            entry.waiters.push_back(std::move(wait));
+            ++hitCount;
+            return Start::Waiting;
+        }
+        if (entry.valid && now - entry.time <= window)
+        {
+            response = entry.response;
+            ++hitCount;
+            return Start::Replayed;
+        }
+    }
+
+    entry.valid = false;
+    entry.running = true;
+    entry.type = request->hdr.type;
+    entry.command = request->hdr.command;
+    entry.payloadHash = payloadHash;
+    entry.payloadLength = payloadLength;
+    entry.response.clear();
+    entry.waiters.clear();
+    return Start::Started;
+}
+
+void ReplayCache::finish(uint8_t eid, const pldm_msg* request,
+                         size_t requestLength, const uint8_t* response,
+                         size_t responseLength, bool replay,
+                         Clock::time_point now)
+{
+    size_t payloadLength = requestLength - sizeof(pldm_msg_hdr);
+    auto payloadHash = crc32::compute(request->payload, payloadLength);
+
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& entry = requesters[eid][request->hdr.instance_id];
+        bool same = holds(entry, request, payloadLength, payloadHash);
+
+        // The slot was taken by a newer request while this one ran
+        if (entry.running && !same)
+        {
+            return;
+        }
+        if (same)
+        {
+            waiters.swap(entry.waiters);
+            entry.running = false;
+        }
+
+        if (replay)
+        {
+            entry.valid = true;
+            entry.type = request->hdr.type;
+            entry.command = request->hdr.command;
+            entry.payloadHash = payloadHash;
+            entry.payloadLength = payloadLength;
+            entry.time = now;
+            entry.response.assign(response, response + responseLength);
+        }
+        else if (same)
+        {
+            entry.valid = false;
+        }
+    }
+
+    if (waiters.empty())
+    {
+        return;
+    }
+    Response responseMsg(response, response + responseLength);
+    for (auto& wait : waiters)
+    {
+        wait(responseMsg);
+    }
+}
+
+ReplayCache& replayCache()
+{
+    static ReplayCache cache(instanceIdExpiration);
+    return cache;
+}
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "file_io.hpp"
+#include "libpldm/base.h"
+
+namespace pldm
+{
+
+namespace responder
+{
+
+/** @brief Instance id expiration interval of DSP0240, after which a requester
+ *         may reuse an instance id for a new request
+ */
+constexpr std::chrono::seconds instanceIdExpiration(5);
+
+/** @class ReplayCache
+ *
+ *  ReplayCache remembers the last response sent to every instance id of every
+ *  requester. A request that repeats the instance id, type, command and
+ *  payload of one answered within the time window is a retry of a request
+ *  whose response was lost, and is answered with the remembered response
+ *  instead of running the command again. This keeps a host that retries a
+ *  ReadFileIntoMemory or WriteFileFromMemory from repeating the DMA.
+ *
+ *  A retry may also arrive while the request is still running, when a DMA
+ *  takes longer than the requester waits for the response. Requests started
+ *  with start() are recorded as running, and their retries wait for the
+ *  response of the request instead of running the command a second time.
+ *
+ *  There are only 32 instance ids, so each requester has a fixed set of slots
+ *  and a new request for an instance id replaces the previous one. Retries
+ *  waiting for a request that was replaced are not answered, the requester
+ *  reused its instance id because it gave up on the request.
+ */
+class ReplayCache
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /** @brief Create the replay cache
+     *
+     * @param[in] window - how long a response is replayed after it is sent
+     */
+    explicit ReplayCache(Clock::duration window) : window(window)
+    {
+    }
+
+    /** @brief Callback that receives the response to the request a retry
+     *         waits for */
+    using Waiter = std::function<void(const Response& response)>;
+
+    /** @brief Result of starting a request */
+    enum class Start
+    {
+        Started,  //!< The request is new and recorded as running
+        Replayed, //!< The request is a retry of an answered request
+        Waiting,  //!< The request is a retry of a running request
+    };
+
+    ReplayCache() = delete;
+    ~ReplayCache() = default;
+    ReplayCache(const ReplayCache&) = delete;
+    ReplayCache& operator=(const ReplayCache&) = delete;
+
+    /** @brief Look up the response to an earlier copy of a request
+     *
+     * @param[in] eid - MCTP endpoint id of the requester
+     * @param[in] request - PLDM request message, including the header
+     * @param[in] requestLength - length of the request message
+     * @param[out] response - set to the remembered response message
+     * @param[in] now - time the request was received
+     *
+     * @return bool - true if the request is a retry and response is set
+     */
+    bool lookup(uint8_t eid, const pldm_msg* request, size_t requestLength,
+                Response& response, Clock::time_point now = Clock::now());
+
+    /** @brief Remember the response sent to a request, as finish does for
+     *         a request that succeeded
+     *
+     * @param[in] eid - MCTP endpoint id of the requester
+     * @param[in] request - PLDM request message, including the header
+     * @param[in] requestLength - length of the request message
+     * @param[in] response - PLDM response message
+     * @param[in] responseLength - length of the response message
+     * @param[in] now - time the response was sent
+     */
+    void store(uint8_t eid, const pldm_msg* request, size_t requestLength,
+               const uint8_t* response, size_t responseLength,
+               Clock::time_point now = Clock::now());
+
+    /** @brief Start a request, unless it is a retry
+     *
+     * @param[in] eid - MCTP endpoint id of the requester
+     * @param[in] request - PLDM request message, including the header
+     * @param[in] requestLength - length of the request message
+     * @param[out] response - set to the remembered response message if the
+     *                        request is replayed
+     * @param[in] wait - called with the response of the running request if
+     *                   the request waits for it, on the thread that finishes
+     *                   the running request
+     * @param[in] now - time the request was received
+     *
+     * @return Start - Started if the caller must run the request and call
+     *                 finish, Replayed if response is set, Waiting if wait
+     *                 will be called
+     */
+    Start start(uint8_t eid, const pldm_msg* request, size_t requestLength,
+                Response& response, Waiter wait,
+                Clock::time_point now = Clock::now());
+
+    /** @brief Finish a request, handing its response to the retries waiting
+     *         for it
+     *
+     * @param[in] eid - MCTP endpoint id of the requester
+     * @param[in] request - PLDM request message, including the header
+     * @param[in] requestLength - length of the request message
+     * @param[in] response - PLDM response message
+     * @param[in] responseLength - length of the response message
+     * @param[in] replay - true to remember the response for later retries
+     * @param[in] now - time the response was sent
+     */
+    void finish(uint8_t eid, const pldm_msg* request, size_t requestLength,
+                const uint8_t* response, size_t responseLength, bool replay,
+                Clock::time_point now = Clock::now());
+
+    /** @brief Forget all the remembered responses
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requesters.clear();
+    }
+
+    /** @brief Get the number of requests answered from the cache
+     */
+    uint64_t hits() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hitCount;
+    }
+
+  private:
+    /** @struct Entry
+     *
+     *  Identity of a request, and the response sent to it or the retries
+     *  waiting for it
+     */
+    struct Entry
+    {
+        bool valid = false;          //!< The slot holds a response
+        bool running = false;        //!< The request has not finished
+        uint8_t type = 0;            //!< PLDM type of the request
+        uint8_t command = 0;         //!< PLDM command of the request
+        uint32_t payloadHash = 0;    //!< CRC-32 of the request payload
+        size_t payloadLength = 0;    //!< Length of the request payload
+        Clock::time_point time;      //!< Time the response was sent
+        Response response;           //!< The response message
+        std::vector<Waiter> waiters; //!< Retries waiting for the response
+    };
+
+    /** @brief Number of PLDM instance ids */
+    static constexpr size_t instanceIds = 32;
+
+    using Slots = std::array<Entry, instanceIds>;
+
+    /** @brief Check if a slot holds a request
+     *
+     * @param[in] entry - the slot
+     * @param[in] request - PLDM request message, including the header
+     * @param[in] payloadLength - length of the request payload
+     * @param[in] payloadHash - CRC-32 of the request payload
+     *
+     * @return bool - true if the slot holds the request
+     */
+    static bool holds(const Entry& entry, const pldm_msg* request,
+                      size_t payloadLength, uint32_t payloadHash)
+    {
+        return entry.type == request->hdr.type &&
+               entry.command == request->hdr.command &&
+               entry.payloadLength == payloadLength &&
+               entry.payloadHash == payloadHash;
+    }
+
+    /** @brief how long a response is replayed after it is sent */
+    Clock::duration window;
+
+    /** @brief number of requests answered from the cache */
+    uint64_t hitCount = 0;
+
+    /** @brief requester endpoint id to the responses sent to it */
+    std::unordered_map<uint8_t, Slots> requesters;
+
+    mutable std::mutex mutex;
+};
+
+/** @brief Get the replay cache of the responder
+ *
+ *  @return ReplayCache& - Reference to instance of replay cache
+ */
+ReplayCache& replayCache();
+
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "config.h"
+
+/** @file
+ *
+ *  Static tracepoints of the responder, under the pldm_oem provider. With
+ *  <sys/sdt.h> available each tracepoint is compiled to a single nop and a
+ *  note in the binary, which tools such as bpftrace and perf attach to on a
+ *  running responder, e.g.
+ *
+ *      bpftrace -e 'usdt:/usr/bin/pldmd:pldm_oem:dma_submit { ... }'
+ *
+ *  Without it the tracepoints compile to nothing.
+ *
+ *  File requests:
+ *  - file_request(handle, offset, length, upstream): a DMA request for the
+ *    file was validated and its transfer starts
+ *  - file_request_done(handle, write, bytes, latency_ns): a request that
+ *    reached the file completed
+ *
+ *  DMA chunks, fired by transferAll and AsyncTransfer:
+ *  - chunk_start(path, offset, length, upstream)
+ *  - chunk_done(path, offset, length, rc)
+ *
+ *  Stages of DMA::transferDataHost, each fired as the stage ends so that the
+ *  time of a stage is the delta to the previous probe on the thread:
+ *  - transfer_start(path, offset, length, upstream)
+ *  - xdma_open(rc)
+ *  - xdma_mmap(rc)
+ *  - file_read(path, offset, length, count)
+ *  - xdma_copy(length)
+ *  - dma_submit(address, length, upstream, rc)
+ *  - file_write(path, offset, length)
+ */
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+#define PLDM_TRACE(probe, ...) STAP_PROBEV(pldm_oem, probe, __VA_ARGS__)
+#else
+#define PLDM_TRACE(probe, ...)                                                 \
+    do                                                                         \
+    {                                                                          \
+    } while (0)
+#endif
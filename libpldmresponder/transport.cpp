@@ -0,0 +1,359 @@
+#include "transport.hpp"
+
+#include "dispatch.hpp"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace transport
+{
+
+namespace
+{
+
+/** @brief Fill in the address of a socket
+ *
+ *  @return length of the address, or negative errno if the path is too long
+ */
+int socketAddress(const std::string& path, sockaddr_un& addr)
+{
+    if (path.empty() || path.size() >= sizeof(addr.sun_path))
+    {
+        return -ENAMETOOLONG;
+    }
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.data(), path.size());
+    if (path[0] == '@')
+    {
+        addr.sun_path[0] = '\0';
+        return offsetof(sockaddr_un, sun_path) + path.size();
+    }
+    return sizeof(addr);
+}
+
+} // namespace
+
+int listenSocket(const std::string& path)
+{
+    sockaddr_un addr{};
+    auto addrLength = socketAddress(path, addr);
+    if (addrLength < 0)
+    {
+        return addrLength;
+    }
+
+    int fd =
+        socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+
+    if (path[0] != '@')
+    {
+        unlink(path.c_str());
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), addrLength) < 0 ||
+        listen(fd, SOMAXCONN) < 0)
+    {
+        auto rc = -errno;
+        close(fd);
+        return rc;
+    }
+    return fd;
+}
+
+int connectSocket(const std::string& path)
+{
+    sockaddr_un addr{};
+    auto addrLength = socketAddress(path, addr);
+    if (addrLength < 0)
+    {
+        return addrLength;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), addrLength) < 0)
+    {
+        auto rc = -errno;
+        close(fd);
+        return rc;
+    }
+    return fd;
+}
+
+std::pair<const uint8_t*, size_t>
+    handleFrame(const uint8_t* frame, size_t length,
+                uint8_t (&header)[frameHeaderSize])
+{
+    if (length <= frameHeaderSize || frame[1] != mctpTypePldm)
+    {
+        return {nullptr, 0};
+    }
+
+    header[0] = frame[0];
+    header[1] = mctpTypePldm;
+    return dispatch::handle(
+        frame[0], reinterpret_cast<const pldm_msg*>(frame + frameHeaderSize),
+        length - frameHeaderSize);
+}
+
+Server::Server(EventLoop& loop, int listenFd, size_t batch, size_t mtu) :
+    loop(loop), listenFd(listenFd),
+    batch(std::clamp<size_t>(batch, 1, maxBatch)),
+    mtu(std::clamp<size_t>(mtu, frameHeaderSize + sizeof(pldm_msg_hdr),
+                           maxFrameSize)),
+    frames(this->batch * this->mtu)
+{
+    auto rc = loop.addIO(listenFd, EPOLLIN, [this](uint32_t) { accept(); });
+    if (rc < 0)
+    {
+        close(listenFd);
+        throw std::system_error(-rc, std::generic_category(),
+                                "Failed to watch the listening socket");
+    }
+}
+
+Server::~Server()
+{
+    while (!clients.empty())
+    {
+        drop(clients.begin()->first);
+    }
+    loop.removeIO(listenFd);
+    close(listenFd);
+}
+
+void Server::accept()
+{
+    int fd = -1;
+    while ((fd = accept4(listenFd, nullptr, nullptr,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        if (loop.addIO(fd, EPOLLIN,
+                       [this, fd](uint32_t events) { serve(fd, events); }) < 0)
+        {
+            close(fd);
+            continue;
+        }
+        clients.emplace(fd, std::make_shared<Connection>(Connection{fd}));
+    }
+}
+
+bool Server::submit(int fd, const uint8_t* frame, size_t length)
+{
+    if (length <= frameHeaderSize || frame[1] != mctpTypePldm)
+    {
+        return false;
+    }
+    auto request = reinterpret_cast<const pldm_msg*>(frame + frameHeaderSize);
+    if (!dispatch::orderingKey(request, length - frameHeaderSize))
+    {
+        return false;
+    }
+
+    auto connection = clients.at(fd);
+    uint8_t eid = frame[0];
+    dispatch::submit(
+        loop, eid,
+        std::vector<uint8_t>(frame + frameHeaderSize, frame + length),
+        [connection, eid](const uint8_t* response, size_t responseLength) {
+            if (!connection->open)
+            {
+                return;
+            }
+            uint8_t header[frameHeaderSize] = {eid, mctpTypePldm};
+            iovec iov[] = {{header, sizeof(header)},
+                           {const_cast<uint8_t*>(response), responseLength}};
+            msghdr msg{};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = 2;
+            sendmsg(connection->fd, &msg, MSG_NOSIGNAL);
+        });
+    return true;
+}
+
+void Server::serve(int fd, uint32_t events)
+{
+    auto open = (batch > 1) ? serveBatch(fd) : serveSingle(fd);
+    if (!open || (events & (EPOLLHUP | EPOLLERR)))
+    {
+        drop(fd);
+    }
+}
+
+bool Server::serveSingle(int fd)
+{
+    auto frame = frames.data();
+    while (true)
+    {
+        auto length = recv(fd, frame, mtu, MSG_TRUNC);
+        if (length < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (length < 0 && errno == EAGAIN)
+        {
+            return true;
+        }
+        if (length <= 0)
+        {
+            return false;
+        }
+        if (static_cast<size_t>(length) > mtu || submit(fd, frame, length))
+        {
+            continue;
+        }
+
+        uint8_t header[frameHeaderSize]{};
+        auto [response, responseLength] = handleFrame(frame, length, header);
+        if (!responseLength)
+        {
+            continue;
+        }
+
+        iovec iov[] = {{header, sizeof(header)},
+                       {const_cast<uint8_t*>(response), responseLength}};
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = 2;
+        sendmsg(fd, &msg, MSG_NOSIGNAL);
+    }
+}
+
+bool Server::serveBatch(int fd)
+{
+    // Each response is copied out of the arena before the next request is
+    // handled, since handling the next request overwrites it
+    std::array<mmsghdr, maxBatch> received{};
+    std::array<iovec, maxBatch> receivedIov{};
+    std::array<mmsghdr, maxBatch> sent{};
+    std::array<iovec, maxBatch> sentIov{};
+    std::array<std::pair<size_t, size_t>, maxBatch> ranges{};
+
+    for (size_t i = 0; i < batch; ++i)
+    {
+        receivedIov[i] = {frames.data() + i * mtu, mtu};
+        received[i].msg_hdr.msg_iov = &receivedIov[i];
+        received[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    while (true)
+    {
+        auto count = recvmmsg(fd, received.data(), batch, 0, nullptr);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count < 0 && errno == EAGAIN)
+        {
+            return true;
+        }
+        if (count <= 0)
+        {
+            return false;
+        }
+
+        // A message of length 0 is the end of the connection, the requests
+        // before it are still answered
+        bool open = true;
+        size_t answered = 0;
+        responses.clear();
+        for (int i = 0; i < count; ++i)
+        {
+            auto length = received[i].msg_len;
+            if (!length)
+            {
+                open = false;
+                break;
+            }
+            auto frame = frames.data() + i * mtu;
+            if ((received[i].msg_hdr.msg_flags & MSG_TRUNC) ||
+                submit(fd, frame, length))
+            {
+                continue;
+            }
+
+            uint8_t header[frameHeaderSize]{};
+            auto [response, responseLength] =
+                handleFrame(frame, length, header);
+            if (!responseLength)
+            {
+                continue;
+            }
+            ranges[answered++] = {responses.size(),
+                                  sizeof(header) + responseLength};
+            responses.insert(responses.end(), header, header + sizeof(header));
+            responses.insert(responses.end(), response,
+                             response + responseLength);
+        }
+
+        for (size_t i = 0; i < answered; ++i)
+        {
+            sentIov[i] = {responses.data() + ranges[i].first,
+                          ranges[i].second};
+            sent[i].msg_hdr = {};
+            sent[i].msg_hdr.msg_iov = &sentIov[i];
+            sent[i].msg_hdr.msg_iovlen = 1;
+        }
+        size_t done = 0;
+        while (done < answered)
+        {
+            auto rc = sendmmsg(fd, sent.data() + done, answered - done,
+                               MSG_NOSIGNAL);
+            if (rc < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (rc <= 0)
+            {
+                break;
+            }
+            done += rc;
+        }
+
+        if (!open)
+        {
+            return false;
+        }
+        if (static_cast<size_t>(count) < batch)
+        {
+            return true;
+        }
+    }
+}
+
+void Server::drop(int fd)
+{
+    loop.removeIO(fd);
+    auto iter = clients.find(fd);
+    if (iter != clients.end())
+    {
+        iter->second->open = false;
+        clients.erase(iter);
+    }
+    close(fd);
+}
+
+} // namespace transport
+} // namespace responder
+} // namespace pldm
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "event_loop.hpp"
+
+namespace pldm
+{
+
+namespace responder
+{
+
+namespace transport
+{
+
+/** @brief MCTP message type of PLDM */
+constexpr uint8_t mctpTypePldm = 0x01;
+
+/** @brief Length of the frame header: the endpoint id and the MCTP message
+ *         type
+ */
+constexpr size_t frameHeaderSize = 2;
+
+/** @brief Largest MTU of a server, the largest frame it receives */
+constexpr size_t maxFrameSize = 64 * 1024;
+
+/** @brief Most messages received or sent by one system call */
+constexpr size_t maxBatch = 64;
+
+/** @brief Create a socket that requesters connect to
+ *
+ *  The socket is an AF_UNIX SOCK_SEQPACKET socket that stands in for the
+ *  socket of the MCTP demux daemon. Each message is a frame of the endpoint
+ *  id of the requester, the MCTP message type and the PLDM message.
+ *
+ *  @param[in] path - pathname of the socket, or a name in the abstract
+ *                    namespace if it starts with '@'
+ *
+ *  @return the listening socket, or negative errno on failure
+ */
+int listenSocket(const std::string& path);
+
+/** @brief Connect to a socket created by listenSocket
+ *
+ *  @param[in] path - pathname of the socket, or a name in the abstract
+ *                    namespace if it starts with '@'
+ *
+ *  @return the connected socket, or negative errno on failure
+ */
+int connectSocket(const std::string& path);
+
+/** @brief Handle the PLDM request in a frame
+ *
+ *  Frames of other MCTP message types, and messages that are not requests,
+ *  are not answered.
+ *
+ *  @param[in] frame - the received frame
+ *  @param[in] length - length of the frame
+ *  @param[out] header - frame header of the response
+ *
+ *  @return pointer to and length of the PLDM response message, as returned
+ *          by dispatch::handle. The length is 0 if there is no response.
+ */
+std::pair<const uint8_t*, size_t>
+    handleFrame(const uint8_t* frame, size_t length,
+                uint8_t (&header)[frameHeaderSize]);
+
+/** @class Server
+ *
+ *  Serves the connections of a listening socket on an event loop. By default
+ *  requests are received, handled and answered one at a time. With a batch
+ *  size above 1, the requests waiting on a connection are received up to a
+ *  batch at a time with recvmmsg, handled in order, and their responses sent
+ *  together with sendmmsg, which saves two system calls per request when
+ *  requesters keep several requests outstanding. Responses that do not fit
+ *  in the send buffer of the socket are dropped, and the requester retries.
+ *
+ *  Requests for commands that read or write a file, which may wait for a
+ *  DMA transfer or a range lock, are handed to dispatch::submit, which
+ *  runs their file I/O on the executor, and answered when they complete, so
+ *  that they do not hold up the loop.
+ *  Frames larger than the MTU are dropped.
+ */
+class Server
+{
+  public:
+    /** @brief Serve a listening socket
+     *
+     * @param[in] loop - event loop to serve the connections on
+     * @param[in] listenFd - listening socket, owned by the server
+     * @param[in] batch - most requests received by one system call, up to
+     *                    maxBatch
+     * @param[in] mtu - largest frame received, as negotiated with the
+     *                  requesters, up to maxFrameSize
+     *
+     * @throw std::system_error if the socket cannot be watched
+     */
+    Server(EventLoop& loop, int listenFd, size_t batch = 1,
+           size_t mtu = maxFrameSize);
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    /** @brief Get the number of open connections */
+    size_t connections() const
+    {
+        return clients.size();
+    }
+
+  private:
+    /** @struct Connection
+     *
+     *  A connected socket, shared with the requests submitted from it so
+     *  that they are not answered once it is closed
+     */
+    struct Connection
+    {
+        int fd;
+        bool open = true;
+    };
+
+    /** @brief Accept the pending connections */
+    void accept();
+
+    /** @brief Hand the request in a frame to dispatch::submit if it reads or
+     *         writes a file
+     *
+     * @param[in] fd - the connection
+     * @param[in] frame - the received frame
+     * @param[in] length - length of the frame
+     *
+     * @return bool - true if the request was submitted, and is answered
+     *                when it completes
+     */
+    bool submit(int fd, const uint8_t* frame, size_t length);
+
+    /** @brief Handle the requests waiting on a connection
+     *
+     * @param[in] fd - the connection
+     * @param[in] events - the ready events
+     */
+    void serve(int fd, uint32_t events);
+
+    /** @brief Handle the requests waiting on a connection one at a time
+     *
+     * @param[in] fd - the connection
+     *
+     * @return bool - false if the connection was closed by the requester
+     */
+    bool serveSingle(int fd);
+
+    /** @brief Handle the requests waiting on a connection a batch at a time
+     *
+     * @param[in] fd - the connection
+     *
+     * @return bool - false if the connection was closed by the requester
+     */
+    bool serveBatch(int fd);
+
+    /** @brief Stop watching and close a connection */
+    void drop(int fd);
+
+    EventLoop& loop;
+    int listenFd;
+
+    /** @brief most requests received by one system call */
+    size_t batch;
+
+    /** @brief largest frame received */
+    size_t mtu;
+
+    /** @brief receive buffer of a batch of frames of the MTU */
+    std::vector<uint8_t> frames;
+
+    /** @brief responses of a batch, copied out of the arena */
+    std::vector<uint8_t> responses;
+
+    /** @brief connected sockets */
+    std::unordered_map<int, std::shared_ptr<Connection>> clients;
+};
+
+} // namespace transport
+} // namespace responder
+} // namespace pldm
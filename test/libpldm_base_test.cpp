@@ -0,0 +1,104 @@
+#include <string.h>
+
+#include <array>
+
+#include "libpldm/base.h"
+
+#include <gtest/gtest.h>
+
+TEST(CcOnlyResponse, testEncode)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + 1> responseMsg{};
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+
+    auto rc = encode_cc_only_resp(3, PLDM_BASE, PLDM_GET_PLDM_TYPES,
+                                  PLDM_ERROR_INVALID_DATA, response);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(response->hdr.request, 0);
+    ASSERT_EQ(response->hdr.instance_id, 3);
+    ASSERT_EQ(response->hdr.type, PLDM_BASE);
+    ASSERT_EQ(response->hdr.command, PLDM_GET_PLDM_TYPES);
+    ASSERT_EQ(response->payload[0], PLDM_ERROR_INVALID_DATA);
+
+    rc = encode_cc_only_resp(0, PLDM_BASE, PLDM_GET_PLDM_TYPES, PLDM_SUCCESS,
+                             nullptr);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+}
+
+TEST(GetPLDMTypes, testGoodEncodeDecode)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr)> requestMsg{};
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    ASSERT_EQ(encode_get_types_req(1, request), PLDM_SUCCESS);
+    ASSERT_EQ(request->hdr.request, 1);
+    ASSERT_EQ(request->hdr.command, PLDM_GET_PLDM_TYPES);
+
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_TYPES_RESP_BYTES>
+        responseMsg{};
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+    std::array<bitfield8_t, PLDM_MAX_TYPES / 8> types{};
+    types[0].byte = 0x01;
+    types[7].byte = 0x80;
+    ASSERT_EQ(encode_get_types_resp(1, PLDM_SUCCESS, types.data(), response),
+              PLDM_SUCCESS);
+
+    uint8_t completionCode = 0xFF;
+    std::array<bitfield8_t, PLDM_MAX_TYPES / 8> decoded{};
+    auto rc =
+        decode_get_types_resp(response->payload, PLDM_GET_TYPES_RESP_BYTES,
+                              &completionCode, decoded.data());
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(decoded[0].byte, 0x01);
+    ASSERT_EQ(decoded[7].byte, 0x80);
+    ASSERT_EQ(decoded[7].bits.bit7, 1);
+
+    rc = decode_get_types_resp(response->payload, PLDM_GET_TYPES_RESP_BYTES - 1,
+                               &completionCode, decoded.data());
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+}
+
+TEST(GetPLDMCommands, testGoodEncodeDecode)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_COMMANDS_REQ_BYTES>
+        requestMsg{};
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    ver32_t version{0xF1, 0xF0, 0xF0, 0x00};
+    ASSERT_EQ(encode_get_commands_req(2, 0x3F, version, request),
+              PLDM_SUCCESS);
+
+    uint8_t type = 0;
+    ver32_t decodedVersion{};
+    auto rc = decode_get_commands_req(request->payload,
+                                      PLDM_GET_COMMANDS_REQ_BYTES, &type,
+                                      &decodedVersion);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(type, 0x3F);
+    ASSERT_EQ(0, memcmp(&version, &decodedVersion, sizeof(version)));
+
+    rc = decode_get_commands_req(request->payload,
+                                 PLDM_GET_COMMANDS_REQ_BYTES - 1, &type,
+                                 &decodedVersion);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_COMMANDS_RESP_BYTES>
+        responseMsg{};
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+    std::array<bitfield8_t, PLDM_MAX_CMDS_PER_TYPE / 8> commands{};
+    commands[0].byte = 0xF2;
+    commands[31].byte = 0x01;
+    ASSERT_EQ(
+        encode_get_commands_resp(2, PLDM_SUCCESS, commands.data(), response),
+        PLDM_SUCCESS);
+
+    uint8_t completionCode = 0xFF;
+    std::array<bitfield8_t, PLDM_MAX_CMDS_PER_TYPE / 8> decoded{};
+    rc = decode_get_commands_resp(response->payload,
+                                  PLDM_GET_COMMANDS_RESP_BYTES,
+                                  &completionCode, decoded.data());
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(decoded[0].byte, 0xF2);
+    ASSERT_EQ(decoded[0].bits.bit4, 1);
+    ASSERT_EQ(decoded[31].byte, 0x01);
+}
@@ -1,6 +1,9 @@
+#include <endian.h>
 #include <string.h>
 
 #include <array>
+#include <string>
+#include <vector>
 
 #include "libpldm/base.h"
 #include "libpldm/file_io.h"
@@ -131,6 +134,30 @@ TEST(ReadWriteFileMemory, testBadEncodeResponse)
     ASSERT_EQ(response->payload[0], PLDM_ERROR);
 }
 
+TEST(ReadWriteFileMemory, PartialTransfer)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_RW_FILE_MEM_RESP_BYTES>
+        responseMsg{};
+    pldm_msg* response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+
+    // The number of bytes transferred before the failure is carried
+    uint32_t length = 0x1000;
+    auto rc = encode_rw_file_memory_resp(0, PLDM_WRITE_FILE_FROM_MEMORY,
+                                         PLDM_PARTIAL_TRANSFER, length,
+                                         response);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(response->payload[0], PLDM_PARTIAL_TRANSFER);
+
+    uint8_t retCompletionCode = 0;
+    uint32_t retLength = 0;
+    rc = decode_rw_file_memory_resp(response->payload,
+                                    PLDM_RW_FILE_MEM_RESP_BYTES,
+                                    &retCompletionCode, &retLength);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(retCompletionCode, PLDM_PARTIAL_TRANSFER);
+    ASSERT_EQ(retLength, length);
+}
+
 TEST(ReadWriteFileIntoMemory, testGoodDecodeResponse)
 {
     std::array<uint8_t, PLDM_RW_FILE_MEM_RESP_BYTES> responseMsg{};
@@ -333,3 +360,535 @@ TEST(GetFileTable, BadEncodeResponse)
     ASSERT_EQ(response->hdr.command, PLDM_GET_FILE_TABLE);
     ASSERT_EQ(response->payload[0], PLDM_ERROR);
 }
+
+TEST(GetFileTable, GoodEncodeRequest)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_GET_FILE_TABLE_REQ_BYTES>
+        requestMsg{};
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+
+    auto rc = encode_get_file_table_req(3, 0x12345678, 1, 2, request);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(request->hdr.request, PLDM_REQUEST);
+    ASSERT_EQ(request->hdr.instance_id, 3);
+    ASSERT_EQ(request->hdr.type, PLDM_IBM_OEM_TYPE);
+    ASSERT_EQ(request->hdr.command, PLDM_GET_FILE_TABLE);
+
+    uint32_t transferHandle = 0;
+    uint8_t transferOpFlag = 0;
+    uint8_t tableType = 0;
+    rc = decode_get_file_table_req(request->payload,
+                                   PLDM_GET_FILE_TABLE_REQ_BYTES,
+                                   &transferHandle, &transferOpFlag,
+                                   &tableType);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(transferHandle, 0x12345678);
+    ASSERT_EQ(transferOpFlag, 1);
+    ASSERT_EQ(tableType, 2);
+
+    ASSERT_EQ(encode_get_file_table_req(0, 0, 0, 0, nullptr),
+              PLDM_ERROR_INVALID_DATA);
+}
+
+TEST(GetFileTable, DecodeResponse)
+{
+    std::array<uint8_t, 5> fileTable = {1, 2, 3, 4, 5};
+    std::array<uint8_t, sizeof(pldm_msg_hdr) +
+                            PLDM_GET_FILE_TABLE_MIN_RESP_BYTES +
+                            fileTable.size()>
+        responseMsg{};
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+    encode_get_file_table_resp(0, PLDM_SUCCESS, 0x87654321, 5,
+                               fileTable.data(), fileTable.size(), response);
+
+    uint8_t completionCode = 0xFF;
+    uint32_t nextTransferHandle = 0;
+    uint8_t transferFlag = 0;
+    size_t tableOffset = 0;
+    size_t tableLength = 0;
+    size_t payloadLength = responseMsg.size() - sizeof(pldm_msg_hdr);
+    auto rc = decode_get_file_table_resp(
+        response->payload, payloadLength, &completionCode, &nextTransferHandle,
+        &transferFlag, &tableOffset, &tableLength);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(nextTransferHandle, 0x87654321);
+    ASSERT_EQ(transferFlag, 5);
+    ASSERT_EQ(tableLength, fileTable.size());
+    ASSERT_EQ(0, memcmp(response->payload + tableOffset, fileTable.data(),
+                        fileTable.size()));
+
+    // Truncated response
+    rc = decode_get_file_table_resp(response->payload, 3, &completionCode,
+                                    &nextTransferHandle, &transferFlag,
+                                    &tableOffset, &tableLength);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+
+    // Error responses carry only the completion code
+    encode_get_file_table_resp(0, PLDM_INVALID_FILE_TABLE_TYPE, 0, 0, nullptr,
+                               0, response);
+    rc = decode_get_file_table_resp(response->payload, 1, &completionCode,
+                                    &nextTransferHandle, &transferFlag,
+                                    &tableOffset, &tableLength);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_INVALID_FILE_TABLE_TYPE);
+}
+
+TEST(ReadFile, testGoodDecodeRequest)
+{
+    std::array<uint8_t, PLDM_READ_FILE_REQ_BYTES> requestMsg{};
+
+    // Random value for fileHandle, offset and length
+    uint32_t fileHandle = 0x12345678;
+    uint32_t offset = 0x87654321;
+    uint32_t length = 0x13245768;
+
+    auto request = reinterpret_cast<pldm_read_file_req*>(requestMsg.data());
+    request->file_handle = fileHandle;
+    request->offset = offset;
+    request->length = length;
+
+    uint32_t retFileHandle = 0;
+    uint32_t retOffset = 0;
+    uint32_t retLength = 0;
+
+    auto rc = decode_read_file_req(requestMsg.data(), requestMsg.size(),
+                                   &retFileHandle, &retOffset, &retLength);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(fileHandle, retFileHandle);
+    ASSERT_EQ(offset, retOffset);
+    ASSERT_EQ(length, retLength);
+}
+
+TEST(ReadFile, testBadDecodeRequest)
+{
+    uint32_t fileHandle = 0;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+
+    // Request payload message is missing
+    auto rc = decode_read_file_req(nullptr, 0, &fileHandle, &offset, &length);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+
+    std::array<uint8_t, PLDM_READ_FILE_REQ_BYTES> requestMsg{};
+
+    // Payload length is invalid
+    rc = decode_read_file_req(requestMsg.data(), 0, &fileHandle, &offset,
+                              &length);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+}
+
+TEST(ReadFile, testGoodEncodeResponse)
+{
+    // Random value for length
+    uint32_t length = 0x4;
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_READ_FILE_RESP_BYTES + 4>
+        responseMsg{};
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+
+    auto rc = encode_read_file_resp(0, PLDM_SUCCESS, length, response);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(response->hdr.request, PLDM_RESPONSE);
+    ASSERT_EQ(response->hdr.type, PLDM_IBM_OEM_TYPE);
+    ASSERT_EQ(response->hdr.command, PLDM_READ_FILE);
+    ASSERT_EQ(response->payload[0], PLDM_SUCCESS);
+    ASSERT_EQ(0, memcmp(response->payload + sizeof(response->payload[0]),
+                        &length, sizeof(length)));
+
+    // The file data follows the fixed fields
+    uint8_t completionCode = 0;
+    uint32_t retLength = 0;
+    size_t fileDataOffset = 0;
+    rc = decode_read_file_resp(response->payload,
+                               responseMsg.size() - sizeof(pldm_msg_hdr),
+                               &completionCode, &retLength, &fileDataOffset);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(retLength, length);
+    ASSERT_EQ(fileDataOffset, PLDM_READ_FILE_RESP_BYTES);
+
+    // The length does not match the file data in the payload
+    rc = decode_read_file_resp(response->payload, PLDM_READ_FILE_RESP_BYTES,
+                               &completionCode, &retLength, &fileDataOffset);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+}
+
+TEST(ReadFile, testGoodEncodeRequest)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_READ_FILE_REQ_BYTES>
+        requestMsg{};
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+
+    auto rc = encode_read_file_req(1, 2, 3, 4, request);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(request->hdr.request, PLDM_REQUEST);
+    ASSERT_EQ(request->hdr.instance_id, 1);
+    ASSERT_EQ(request->hdr.command, PLDM_READ_FILE);
+
+    uint32_t fileHandle = 0;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    rc = decode_read_file_req(request->payload, PLDM_READ_FILE_REQ_BYTES,
+                              &fileHandle, &offset, &length);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(fileHandle, 2);
+    ASSERT_EQ(offset, 3);
+    ASSERT_EQ(length, 4);
+
+    rc = encode_read_file_req(0, 0, 0, 0, nullptr);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+}
+
+TEST(WriteFile, testGoodDecodeRequest)
+{
+    std::array<uint8_t, PLDM_WRITE_FILE_REQ_BYTES + 4> requestMsg{};
+    auto request = reinterpret_cast<pldm_write_file_req*>(requestMsg.data());
+    request->file_handle = 0x12345678;
+    request->offset = 0x87654321;
+    request->length = 4;
+    memcpy(request->file_data, "data", 4);
+
+    uint32_t fileHandle = 0;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    size_t fileDataOffset = 0;
+    auto rc = decode_write_file_req(requestMsg.data(), requestMsg.size(),
+                                    &fileHandle, &offset, &length,
+                                    &fileDataOffset);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(fileHandle, 0x12345678);
+    ASSERT_EQ(offset, 0x87654321);
+    ASSERT_EQ(length, 4);
+    ASSERT_EQ(0, memcmp(requestMsg.data() + fileDataOffset, "data", 4));
+}
+
+TEST(WriteFile, testBadDecodeRequest)
+{
+    uint32_t fileHandle = 0;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    size_t fileDataOffset = 0;
+
+    // Request payload message is missing
+    auto rc = decode_write_file_req(nullptr, 0, &fileHandle, &offset, &length,
+                                    &fileDataOffset);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+
+    std::array<uint8_t, PLDM_WRITE_FILE_REQ_BYTES + 4> requestMsg{};
+    auto request = reinterpret_cast<pldm_write_file_req*>(requestMsg.data());
+
+    // Payload is shorter than the fixed fields
+    rc = decode_write_file_req(requestMsg.data(), 0, &fileHandle, &offset,
+                               &length, &fileDataOffset);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+
+    // Length does not match the file data in the payload
+    request->length = 8;
+    rc = decode_write_file_req(requestMsg.data(), requestMsg.size(),
+                               &fileHandle, &offset, &length, &fileDataOffset);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+}
+
+TEST(WriteFile, testGoodEncodeResponse)
+{
+    uint32_t length = 0x13245768;
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_WRITE_FILE_RESP_BYTES>
+        responseMsg{};
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+
+    auto rc = encode_write_file_resp(0, PLDM_SUCCESS, length, response);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(response->hdr.request, PLDM_RESPONSE);
+    ASSERT_EQ(response->hdr.command, PLDM_WRITE_FILE);
+
+    uint8_t completionCode = PLDM_ERROR;
+    uint32_t retLength = 0;
+    rc = decode_write_file_resp(response->payload, PLDM_WRITE_FILE_RESP_BYTES,
+                                &completionCode, &retLength);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(retLength, length);
+
+    rc = decode_write_file_resp(response->payload, 0, &completionCode,
+                                &retLength);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+}
+
+TEST(WriteFile, testGoodEncodeRequest)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_WRITE_FILE_REQ_BYTES>
+        requestMsg{};
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+
+    auto rc = encode_write_file_req(0, 1, 2, 0, request);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(request->hdr.request, PLDM_REQUEST);
+    ASSERT_EQ(request->hdr.command, PLDM_WRITE_FILE);
+
+    rc = encode_write_file_req(0, 0, 0, 0, nullptr);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+}
+
+TEST(GetChangedBlocks, testGoodEncodeRequest)
+{
+    std::array<uint8_t,
+               sizeof(pldm_msg_hdr) + PLDM_GET_CHANGED_BLOCKS_REQ_BYTES>
+        requestMsg{};
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+
+    auto rc = encode_get_changed_blocks_req(0, 0x12345678, 0x1000,
+                                            0x0102030405060708, request);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(request->hdr.request, PLDM_REQUEST);
+    ASSERT_EQ(request->hdr.command, PLDM_GET_CHANGED_BLOCKS);
+
+    uint32_t fileHandle = 0;
+    uint32_t offset = 0;
+    uint64_t generation = 0;
+    rc = decode_get_changed_blocks_req(request->payload,
+                                       PLDM_GET_CHANGED_BLOCKS_REQ_BYTES,
+                                       &fileHandle, &offset, &generation);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(fileHandle, 0x12345678);
+    ASSERT_EQ(offset, 0x1000);
+    ASSERT_EQ(generation, 0x0102030405060708);
+
+    rc = decode_get_changed_blocks_req(request->payload,
+                                       PLDM_GET_CHANGED_BLOCKS_REQ_BYTES - 1,
+                                       &fileHandle, &offset, &generation);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+
+    rc = encode_get_changed_blocks_req(0, 0, 0, 0, nullptr);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+}
+
+TEST(GetChangedBlocks, testGoodEncodeResponse)
+{
+    std::array<pldm_changed_range, 2> ranges{{{0, 4096}, {65536, 8192}}};
+    std::array<uint8_t, sizeof(pldm_msg_hdr) +
+                            PLDM_GET_CHANGED_BLOCKS_MIN_RESP_BYTES +
+                            sizeof(ranges)>
+        responseMsg{};
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+
+    auto rc = encode_get_changed_blocks_resp(0, PLDM_SUCCESS, 42, 1 << 20,
+                                             1 << 20, ranges.data(),
+                                             ranges.size(), response);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(response->hdr.request, PLDM_RESPONSE);
+    ASSERT_EQ(response->hdr.command, PLDM_GET_CHANGED_BLOCKS);
+
+    uint8_t completionCode = PLDM_ERROR;
+    uint64_t generation = 0;
+    uint32_t fileSize = 0;
+    uint32_t nextOffset = 0;
+    uint16_t rangeCount = 0;
+    size_t rangesOffset = 0;
+    size_t payloadLength = responseMsg.size() - sizeof(pldm_msg_hdr);
+    rc = decode_get_changed_blocks_resp(
+        response->payload, payloadLength, &completionCode, &generation,
+        &fileSize, &nextOffset, &rangeCount, &rangesOffset);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(generation, 42);
+    ASSERT_EQ(fileSize, 1 << 20);
+    ASSERT_EQ(nextOffset, 1 << 20);
+    ASSERT_EQ(rangeCount, 2);
+    auto decoded = reinterpret_cast<const pldm_changed_range*>(
+        response->payload + rangesOffset);
+    ASSERT_EQ(le32toh(decoded[1].offset), 65536);
+    ASSERT_EQ(le32toh(decoded[1].length), 8192);
+
+    // The ranges do not match the count
+    rc = decode_get_changed_blocks_resp(
+        response->payload, payloadLength - 1, &completionCode, &generation,
+        &fileSize, &nextOffset, &rangeCount, &rangesOffset);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+
+    // Errors carry only the completion code
+    rc = encode_get_changed_blocks_resp(0, PLDM_INVALID_FILE_HANDLE, 0, 0, 0,
+                                        nullptr, 0, response);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    rc = decode_get_changed_blocks_resp(response->payload, 1, &completionCode,
+                                        &generation, &fileSize, &nextOffset,
+                                        &rangeCount, &rangesOffset);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_INVALID_FILE_HANDLE);
+}
+
+TEST(GetFileChecksum, testGoodEncodeRequest)
+{
+    std::array<uint8_t,
+               sizeof(pldm_msg_hdr) + PLDM_GET_FILE_CHECKSUM_REQ_BYTES>
+        requestMsg{};
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+
+    auto rc = encode_get_file_checksum_req(0, 0x12345678, 0x1000, 0xFFFFFFFF,
+                                           PLDM_CHECKSUM_SHA256, request);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(request->hdr.request, PLDM_REQUEST);
+    ASSERT_EQ(request->hdr.command, PLDM_GET_FILE_CHECKSUM);
+
+    uint32_t fileHandle = 0;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    uint8_t checksumType = 0;
+    rc = decode_get_file_checksum_req(request->payload,
+                                      PLDM_GET_FILE_CHECKSUM_REQ_BYTES,
+                                      &fileHandle, &offset, &length,
+                                      &checksumType);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(fileHandle, 0x12345678);
+    ASSERT_EQ(offset, 0x1000);
+    ASSERT_EQ(length, 0xFFFFFFFF);
+    ASSERT_EQ(checksumType, PLDM_CHECKSUM_SHA256);
+
+    rc = decode_get_file_checksum_req(request->payload,
+                                      PLDM_GET_FILE_CHECKSUM_REQ_BYTES - 1,
+                                      &fileHandle, &offset, &length,
+                                      &checksumType);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+
+    rc = encode_get_file_checksum_req(0, 0, 0, 0, 0, nullptr);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+}
+
+TEST(GetFileChecksum, testGoodEncodeResponse)
+{
+    std::array<uint8_t, 4> digest{0x78, 0x56, 0x34, 0x12};
+    std::array<uint8_t, sizeof(pldm_msg_hdr) +
+                            PLDM_GET_FILE_CHECKSUM_MIN_RESP_BYTES +
+                            sizeof(digest)>
+        responseMsg{};
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+
+    auto rc = encode_get_file_checksum_resp(0, PLDM_SUCCESS, 1 << 20,
+                                            digest.data(), digest.size(),
+                                            response);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(response->hdr.request, PLDM_RESPONSE);
+    ASSERT_EQ(response->hdr.command, PLDM_GET_FILE_CHECKSUM);
+
+    uint8_t completionCode = PLDM_ERROR;
+    uint32_t length = 0;
+    uint8_t digestLength = 0;
+    size_t digestOffset = 0;
+    size_t payloadLength = responseMsg.size() - sizeof(pldm_msg_hdr);
+    rc = decode_get_file_checksum_resp(response->payload, payloadLength,
+                                       &completionCode, &length,
+                                       &digestLength, &digestOffset);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(length, 1 << 20);
+    ASSERT_EQ(digestLength, digest.size());
+    ASSERT_EQ(memcmp(response->payload + digestOffset, digest.data(),
+                     digest.size()),
+              0);
+
+    // The digest does not match its length
+    rc = decode_get_file_checksum_resp(response->payload, payloadLength - 1,
+                                       &completionCode, &length,
+                                       &digestLength, &digestOffset);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+
+    // Digests are at most the size of a SHA-256 digest
+    std::array<uint8_t, PLDM_GET_FILE_CHECKSUM_MAX_DIGEST_BYTES + 1> large{};
+    rc = encode_get_file_checksum_resp(0, PLDM_SUCCESS, 0, large.data(),
+                                       large.size(), response);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+
+    // Errors carry only the completion code
+    rc = encode_get_file_checksum_resp(0, PLDM_INVALID_CHECKSUM_TYPE, 0,
+                                       nullptr, 0, response);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    rc = decode_get_file_checksum_resp(response->payload, 1, &completionCode,
+                                       &length, &digestLength, &digestOffset);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_INVALID_CHECKSUM_TYPE);
+}
+
+TEST(FollowFile, testGoodEncodeRequest)
+{
+    std::array<uint8_t, sizeof(pldm_msg_hdr) + PLDM_FOLLOW_FILE_REQ_BYTES>
+        requestMsg{};
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+
+    auto rc = encode_follow_file_req(0, 0x12345678, 0x1000, 0xabcd, 0x200,
+                                     request);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(request->hdr.request, PLDM_REQUEST);
+    ASSERT_EQ(request->hdr.command, PLDM_FOLLOW_FILE);
+
+    uint32_t fileHandle = 0;
+    uint32_t cursor = 0;
+    uint32_t fileId = 0;
+    uint32_t length = 0;
+    rc = decode_follow_file_req(request->payload, PLDM_FOLLOW_FILE_REQ_BYTES,
+                                &fileHandle, &cursor, &fileId, &length);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(fileHandle, 0x12345678);
+    ASSERT_EQ(cursor, 0x1000);
+    ASSERT_EQ(fileId, 0xabcd);
+    ASSERT_EQ(length, 0x200);
+
+    rc = decode_follow_file_req(request->payload,
+                                PLDM_FOLLOW_FILE_REQ_BYTES - 1, &fileHandle,
+                                &cursor, &fileId, &length);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+
+    rc = encode_follow_file_req(0, 0, 0, 0, 0, nullptr);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_DATA);
+}
+
+TEST(FollowFile, testGoodEncodeResponse)
+{
+    const std::string data = "log line\n";
+    std::vector<uint8_t> responseMsg(sizeof(pldm_msg_hdr) +
+                                     PLDM_FOLLOW_FILE_MIN_RESP_BYTES +
+                                     data.size());
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+
+    auto rc = encode_follow_file_resp(0, PLDM_SUCCESS, 0x1009, 0xabcd, 0x2000,
+                                      data.size(), response);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(response->hdr.request, PLDM_RESPONSE);
+    ASSERT_EQ(response->hdr.command, PLDM_FOLLOW_FILE);
+    auto follow = reinterpret_cast<pldm_follow_file_resp*>(response->payload);
+    memcpy(follow->file_data, data.data(), data.size());
+
+    uint8_t completionCode = PLDM_ERROR;
+    uint32_t cursor = 0;
+    uint32_t fileId = 0;
+    uint32_t fileSize = 0;
+    uint32_t length = 0;
+    size_t dataOffset = 0;
+    size_t payloadLength = responseMsg.size() - sizeof(pldm_msg_hdr);
+    rc = decode_follow_file_resp(response->payload, payloadLength,
+                                 &completionCode, &cursor, &fileId, &fileSize,
+                                 &length, &dataOffset);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(cursor, 0x1009);
+    ASSERT_EQ(fileId, 0xabcd);
+    ASSERT_EQ(fileSize, 0x2000);
+    ASSERT_EQ(length, data.size());
+    ASSERT_EQ(memcmp(response->payload + dataOffset, data.data(),
+                     data.size()),
+              0);
+
+    // The data does not match the length
+    rc = decode_follow_file_resp(response->payload, payloadLength - 1,
+                                 &completionCode, &cursor, &fileId, &fileSize,
+                                 &length, &dataOffset);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+
+    // Errors carry only the completion code
+    rc = encode_follow_file_resp(0, PLDM_DATA_OUT_OF_RANGE, 0, 0, 0, 0,
+                                 response);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    rc = decode_follow_file_resp(response->payload, 1, &completionCode,
+                                 &cursor, &fileId, &fileSize, &length,
+                                 &dataOffset);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_DATA_OUT_OF_RANGE);
+}
@@ -0,0 +1,70 @@
+#include "libpldmresponder/admission.hpp"
+#include "libpldmresponder/metrics.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::responder;
+using namespace std::chrono_literals;
+
+TEST(Admission, Budget)
+{
+    AdmissionController controller(100, 10ms);
+    ASSERT_TRUE(controller.tryAdmit(60, 0ns));
+    EXPECT_TRUE(controller.tryAdmit(40, 0ns));
+    EXPECT_FALSE(controller.tryAdmit(1, 0ns));
+    EXPECT_EQ(controller.inFlight(), 100u);
+
+    controller.release(40);
+    {
+        auto reservation = controller.admit(40);
+        EXPECT_TRUE(reservation);
+        EXPECT_EQ(controller.inFlight(), 100u);
+    }
+    EXPECT_EQ(controller.inFlight(), 60u);
+
+    // A chunk larger than the budget waits until nothing is in flight
+    EXPECT_FALSE(controller.tryAdmit(200, 0ns));
+    controller.release(60);
+    EXPECT_TRUE(controller.tryAdmit(200, 0ns));
+    controller.release(200);
+    EXPECT_EQ(controller.inFlight(), 0u);
+}
+
+TEST(Admission, WaitAndTimeout)
+{
+    metrics::reset();
+    AdmissionController controller(100, 20ms);
+    ASSERT_TRUE(controller.tryAdmit(100, 0ns));
+
+    // Nothing is released, the chunk gives up after the timeout
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(controller.admit(10));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 20ms);
+    EXPECT_EQ(metrics::counters().notAdmitted, 1u);
+
+    // The waiting chunk is admitted once bytes are released
+    AdmissionController patient(100, 10s);
+    ASSERT_TRUE(patient.tryAdmit(100, 0ns));
+    std::atomic<bool> admitted{false};
+    std::thread waiter([&] {
+        auto reservation = patient.admit(50);
+        admitted = static_cast<bool>(reservation);
+    });
+    std::this_thread::sleep_for(10ms);
+    EXPECT_FALSE(admitted);
+    patient.release(100);
+    waiter.join();
+    EXPECT_TRUE(admitted);
+    EXPECT_EQ(patient.inFlight(), 0u);
+
+    // The waits of the admitted chunks are recorded, including the chunks
+    // admitted without waiting
+    const auto& delay = metrics::admissionDelay();
+    EXPECT_EQ(delay.count(), 3u);
+    EXPECT_GE(delay.maxValue(), 10000000u);
+    controller.release(100);
+}
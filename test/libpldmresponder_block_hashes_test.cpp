@@ -0,0 +1,101 @@
+#include "libpldmresponder/block_hashes.hpp"
+#include "temp_file.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::responder;
+
+namespace
+{
+
+constexpr size_t blockCount = 16;
+constexpr size_t fileSize = blockCount * dedupBlockSize;
+
+class DedupFile : public pldm::test::TempFile
+{
+  protected:
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(TempFile::SetUp());
+
+        data.resize(fileSize);
+        for (size_t i = 0; i < fileSize; ++i)
+        {
+            data[i] = static_cast<char>(i * 7);
+        }
+        writeAt(0, data.data(), fileSize);
+        blockHashes().clear();
+    }
+
+    std::vector<char> contents()
+    {
+        struct stat st
+        {
+        };
+        fstat(fd, &st);
+        std::vector<char> buffer(st.st_size);
+        pread(fd, buffer.data(), buffer.size(), 0);
+        return buffer;
+    }
+
+    std::vector<char> data;
+};
+
+} // namespace
+
+TEST_F(DedupFile, SkipUnchangedBlocks)
+{
+    // Rewriting the file as is writes nothing, twice: once comparing the
+    // contents and once with the hashes known
+    EXPECT_EQ(writeChanged(fd, path, 0, fileSize, data.data()),
+              static_cast<ssize_t>(fileSize));
+    EXPECT_EQ(writeChanged(fd, path, 0, fileSize, data.data()),
+              static_cast<ssize_t>(fileSize));
+
+    // Only the blocks that changed are written
+    data[3 * dedupBlockSize + 10] ^= 0xFF;
+    data[4 * dedupBlockSize] ^= 0xFF;
+    data[9 * dedupBlockSize + 1] ^= 0xFF;
+    EXPECT_EQ(writeChanged(fd, path, 0, fileSize, data.data()),
+              static_cast<ssize_t>(fileSize - 3 * dedupBlockSize));
+    EXPECT_EQ(contents(), data);
+}
+
+TEST_F(DedupFile, OtherWriters)
+{
+    EXPECT_EQ(writeChanged(fd, path, 0, fileSize, data.data()),
+              static_cast<ssize_t>(fileSize));
+
+    // A block changed behind the cache is written back
+    char byte = ~data[5 * dedupBlockSize];
+    ASSERT_EQ(pwrite(fd, &byte, 1, 5 * dedupBlockSize), 1);
+    EXPECT_EQ(writeChanged(fd, path, 0, fileSize, data.data()),
+              static_cast<ssize_t>(fileSize - dedupBlockSize));
+    EXPECT_EQ(contents(), data);
+}
+
+TEST_F(DedupFile, PartialBlocks)
+{
+    // Partial blocks at the ends of the range are written, whole blocks in
+    // between are compared
+    uint64_t offset = dedupBlockSize + 100;
+    uint32_t length = 3 * dedupBlockSize;
+    data[offset] ^= 0xFF;
+    data[offset + length - 1] ^= 0xFF;
+    EXPECT_EQ(writeChanged(fd, path, offset, length, data.data() + offset),
+              static_cast<ssize_t>(2 * dedupBlockSize));
+    EXPECT_EQ(contents(), data);
+
+    EXPECT_EQ(writeChanged(fd, path, 10, 20, data.data() + 10), 0);
+
+    // Blocks past the end of the file are written
+    std::vector<char> tail(2 * dedupBlockSize, 'x');
+    EXPECT_EQ(writeChanged(fd, path, fileSize, tail.size(), tail.data()), 0);
+    data.insert(data.end(), tail.begin(), tail.end());
+    EXPECT_EQ(contents(), data);
+}
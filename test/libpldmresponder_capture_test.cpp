@@ -0,0 +1,87 @@
+#include "libpldmresponder/capture.hpp"
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::responder;
+namespace fs = std::filesystem;
+
+class TestCapture : public testing::Test
+{
+  public:
+    void SetUp() override
+    {
+        char tmppldm[] = "/tmp/pldm_capture.XXXXXX";
+        dir = fs::path(mkdtemp(tmppldm));
+        file = dir / "capture";
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(dir);
+    }
+
+    fs::path dir;
+    fs::path file;
+};
+
+TEST_F(TestCapture, RoundTrip)
+{
+    CaptureWriter writer;
+    std::vector<uint8_t> first{0x80, 0x3F, 0x06, 1, 2, 3};
+    std::vector<uint8_t> second(5000, 0xA5);
+
+    // Nothing is recorded before the file is opened
+    writer.record(1, first.data(), first.size());
+    ASSERT_FALSE(writer.isOpen());
+
+    ASSERT_TRUE(writer.open(file));
+    writer.record(9, first.data(), first.size());
+    writer.record(10, second.data(), second.size());
+    writer.close();
+    writer.record(11, first.data(), first.size());
+
+    CaptureReader reader;
+    ASSERT_TRUE(reader.open(file));
+    CaptureRecord record;
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(record.eid, 9);
+    ASSERT_EQ(record.message, first);
+    auto firstTime = record.time;
+
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(record.eid, 10);
+    ASSERT_EQ(record.message, second);
+    ASSERT_GE(record.time, firstTime);
+
+    ASSERT_FALSE(reader.next(record));
+}
+
+TEST_F(TestCapture, BadFile)
+{
+    CaptureReader reader;
+    ASSERT_FALSE(reader.open(dir / "missing"));
+
+    {
+        std::ofstream stream(file);
+        stream << "not a capture file";
+    }
+    ASSERT_FALSE(reader.open(file));
+
+    // A record cut short by a crash ends the capture
+    CaptureWriter writer;
+    std::vector<uint8_t> message(64, 0x11);
+    ASSERT_TRUE(writer.open(file));
+    writer.record(9, message.data(), message.size());
+    writer.close();
+    fs::resize_file(file, fs::file_size(file) - 1);
+
+    CaptureRecord record;
+    ASSERT_TRUE(reader.open(file));
+    ASSERT_FALSE(reader.next(record));
+}
@@ -0,0 +1,213 @@
+#include "libpldmresponder/change_tracker.hpp"
+#include "libpldmresponder/executor.hpp"
+#include "temp_file.hpp"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#define SD_JOURNAL_SUPPRESS_LOCATION
+
+#include <systemd/sd-journal.h>
+
+extern "C" {
+
+int sd_journal_send(const char* /*format*/, ...)
+{
+    return 0;
+}
+
+int sd_journal_send_with_location(const char* /*file*/, const char* /*line*/,
+                                  const char* /*func*/,
+                                  const char* /*format*/, ...)
+{
+    return 0;
+}
+}
+
+using namespace pldm::filetable;
+using namespace pldm::responder;
+
+namespace
+{
+
+constexpr size_t blockCount = 16;
+constexpr uint32_t fileSize = blockCount * changeBlockSize;
+
+class TrackedFile : public pldm::test::TempFile
+{
+  protected:
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(TempFile::SetUp());
+        fill(0, fileSize, 'a');
+    }
+
+    void TearDown() override
+    {
+        // Refreshes queued by inotify use the tracker
+        executor().wait();
+        TempFile::TearDown();
+    }
+
+    Changes changes(uint64_t since, uint32_t offset = 0,
+                    size_t maxRanges = 16)
+    {
+        Changes result{};
+        EXPECT_EQ(tracker.changes(1, path, since, offset, maxRanges, result),
+                  0);
+        return result;
+    }
+
+    ChangeTracker tracker;
+};
+
+} // namespace
+
+TEST_F(TrackedFile, WholeFileForOldGenerations)
+{
+    auto all = changes(0);
+    EXPECT_EQ(all.fileSize, fileSize);
+    EXPECT_EQ(all.nextOffset, fileSize);
+    ASSERT_EQ(all.ranges.size(), 1u);
+    EXPECT_EQ(all.ranges[0].offset, 0u);
+    EXPECT_EQ(all.ranges[0].length, fileSize);
+
+    // Nothing changed since
+    auto none = changes(all.generation);
+    EXPECT_EQ(none.generation, all.generation);
+    EXPECT_TRUE(none.ranges.empty());
+
+    // A generation from before the file was tracked covers all of it
+    EXPECT_EQ(changes(all.generation - 1).ranges.size(), 1u);
+}
+
+TEST_F(TrackedFile, FutureGeneration)
+{
+    auto since = changes(0).generation;
+    fill(0, 1, 'b');
+    tracker.recordWrite(1, path, 0, 1);
+
+    // A generation not handed out yet, e.g. from a run whose clock was
+    // ahead, is unknown and covers the whole file
+    auto future = changes(since + 1000000000);
+    ASSERT_EQ(future.ranges.size(), 1u);
+    EXPECT_EQ(future.ranges[0].offset, 0u);
+    EXPECT_EQ(future.ranges[0].length, fileSize);
+    EXPECT_LT(future.generation, since + 1000000000);
+
+    // The generation it returns is known
+    EXPECT_TRUE(changes(future.generation).ranges.empty());
+}
+
+TEST_F(TrackedFile, PagedScan)
+{
+    auto since = changes(0).generation;
+    fill(0, 1, 'b');
+    tracker.recordWrite(1, path, 0, 1);
+    fill(4 * changeBlockSize, 1, 'b');
+    tracker.recordWrite(1, path, 4 * changeBlockSize, 1);
+
+    // One range per page, the first block changes again after the first page
+    auto first = changes(since, 0, 1);
+    ASSERT_EQ(first.ranges.size(), 1u);
+    EXPECT_EQ(first.nextOffset, 4 * changeBlockSize);
+    fill(0, 1, 'c');
+    tracker.recordWrite(1, path, 0, 1);
+
+    auto last = changes(since, first.nextOffset, 1);
+    ASSERT_EQ(last.ranges.size(), 1u);
+    EXPECT_EQ(last.nextOffset, fileSize);
+    EXPECT_LE(last.generation, first.generation);
+
+    // The next scan from either generation reports the block written
+    // between the pages
+    for (auto generation : {first.generation, last.generation})
+    {
+        auto next = changes(generation);
+        ASSERT_FALSE(next.ranges.empty());
+        EXPECT_EQ(next.ranges[0].offset, 0u);
+    }
+}
+
+TEST_F(TrackedFile, ResponderWrites)
+{
+    auto since = changes(0).generation;
+
+    fill(2 * changeBlockSize + 10, changeBlockSize, 'b');
+    tracker.recordWrite(1, path, 2 * changeBlockSize + 10, changeBlockSize);
+    auto delta = changes(since);
+    ASSERT_EQ(delta.ranges.size(), 1u);
+    EXPECT_EQ(delta.ranges[0].offset, 2 * changeBlockSize);
+    EXPECT_EQ(delta.ranges[0].length, 2 * changeBlockSize);
+    EXPECT_GT(delta.generation, since);
+
+    // Writes that grow the file mark the new blocks, the last one partial
+    fill(fileSize - 100, 200, 'c');
+    tracker.recordWrite(1, path, fileSize - 100, 200);
+    auto grown = changes(delta.generation);
+    EXPECT_EQ(grown.fileSize, fileSize + 100);
+    ASSERT_EQ(grown.ranges.size(), 1u);
+    EXPECT_EQ(grown.ranges[0].offset, fileSize - changeBlockSize);
+    EXPECT_EQ(grown.ranges[0].length, changeBlockSize + 100);
+}
+
+TEST_F(TrackedFile, LocalWriters)
+{
+    auto since = changes(0).generation;
+
+    // Only the blocks whose contents changed are reported, the size change
+    // makes the write visible whatever the mtime granularity
+    fill(7 * changeBlockSize, 1, 'x');
+    fill(9 * changeBlockSize, changeBlockSize, 'a');
+    fill(fileSize, changeBlockSize, 'y');
+    auto delta = changes(since);
+    EXPECT_EQ(delta.fileSize, fileSize + changeBlockSize);
+    ASSERT_EQ(delta.ranges.size(), 2u);
+    EXPECT_EQ(delta.ranges[0].offset, 7 * changeBlockSize);
+    EXPECT_EQ(delta.ranges[0].length, changeBlockSize);
+    EXPECT_EQ(delta.ranges[1].offset, fileSize);
+    EXPECT_EQ(delta.ranges[1].length, changeBlockSize);
+
+    // Ranges beyond the limit are returned by the next request
+    auto first = changes(since, 0, 1);
+    ASSERT_EQ(first.ranges.size(), 1u);
+    EXPECT_EQ(first.nextOffset, fileSize);
+    auto next = changes(since, first.nextOffset, 1);
+    ASSERT_EQ(next.ranges.size(), 1u);
+    EXPECT_EQ(next.ranges[0].offset, fileSize);
+    EXPECT_EQ(next.nextOffset, fileSize + changeBlockSize);
+}
+
+TEST_F(TrackedFile, Inotify)
+{
+    EventLoop loop;
+    ASSERT_EQ(tracker.watch(loop), 0);
+    auto since = changes(0).generation;
+
+    // The change is found when inotify reports it, before anyone asks
+    fill(3 * changeBlockSize, 16, 'z');
+    for (int i = 0; i < 50 && tracker.generation() == since; ++i)
+    {
+        loop.runOnce(100);
+        executor().wait();
+    }
+    ASSERT_NE(tracker.generation(), since);
+    auto delta = changes(since);
+    ASSERT_EQ(delta.ranges.size(), 1u);
+    EXPECT_EQ(delta.ranges[0].offset, 3 * changeBlockSize);
+
+    // A file that is replaced is tracked from scratch
+    close(fd);
+    fd = -1;
+    fs::remove(path);
+    loop.runOnce(100);
+    std::ofstream(path) << "new";
+    auto replaced = changes(delta.generation);
+    EXPECT_EQ(replaced.fileSize, 3u);
+    ASSERT_EQ(replaced.ranges.size(), 1u);
+    EXPECT_EQ(replaced.ranges[0].length, 3u);
+}
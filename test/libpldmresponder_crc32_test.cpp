@@ -0,0 +1,95 @@
+#include "libpldmresponder/crc32.hpp"
+
+#include <boost/crc.hpp>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+
+namespace
+{
+
+uint32_t reference(const uint8_t* data, size_t length)
+{
+    boost::crc_32_type result;
+    result.process_bytes(data, length);
+    return result.checksum();
+}
+
+std::vector<uint8_t> randomBytes(size_t length)
+{
+    std::mt19937 gen(length);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<uint8_t> data(length);
+    for (auto& byte : data)
+    {
+        byte = static_cast<uint8_t>(dist(gen));
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(CRC32, CheckValue)
+{
+    const char* check = "123456789";
+    ASSERT_EQ(crc32::compute(check, strlen(check)), 0xCBF43926);
+    ASSERT_EQ(crc32::compute(nullptr, 0), 0);
+}
+
+TEST(CRC32, MatchesReference)
+{
+    // Cover the byte-wise head and tail, the slicing-by-8 body and the
+    // folding path, at every alignment of the start of the buffer.
+    auto data = randomBytes(4096 + 8);
+    for (size_t length : {1, 7, 8, 15, 16, 63, 64, 65, 127, 128, 1000, 4096})
+    {
+        for (size_t align = 0; align < 8; ++align)
+        {
+            ASSERT_EQ(crc32::compute(data.data() + align, length),
+                      reference(data.data() + align, length))
+                << "length " << length << " align " << align;
+        }
+    }
+}
+
+TEST(CRC32, RunningCRC)
+{
+    auto data = randomBytes(1024);
+    auto crc = crc32::compute(data.data(), 100);
+    crc = crc32::compute(data.data() + 100, data.size() - 100, crc);
+    ASSERT_EQ(crc, reference(data.data(), data.size()));
+}
+
+TEST(CRC32, Combine)
+{
+    auto data = randomBytes(1024);
+    for (size_t split : {0, 1, 4, 100, 1023, 1024})
+    {
+        auto crc1 = crc32::compute(data.data(), split);
+        auto crc2 = crc32::compute(data.data() + split, data.size() - split);
+        ASSERT_EQ(crc32::combine(crc1, crc2, data.size() - split),
+                  reference(data.data(), data.size()));
+    }
+}
+
+TEST(CRC32, Patch)
+{
+    auto data = randomBytes(256);
+    auto crc = crc32::compute(data.data(), data.size());
+
+    for (size_t offset : {0, 17, 252})
+    {
+        uint32_t newValue = 0x12345678 + offset;
+        std::vector<uint8_t> oldValue(data.begin() + offset,
+                                      data.begin() + offset + sizeof(newValue));
+        memcpy(data.data() + offset, &newValue, sizeof(newValue));
+
+        crc = crc32::patch(crc, data.size(), offset, oldValue.data(),
+                           &newValue, sizeof(newValue));
+        ASSERT_EQ(crc, reference(data.data(), data.size()));
+    }
+}
@@ -0,0 +1,518 @@
+#include "libpldmresponder/capture.hpp"
+#include "libpldmresponder/dispatch.hpp"
+#include "libpldmresponder/file_cache.hpp"
+#include "libpldmresponder/file_table.hpp"
+#include "libpldmresponder/replay_cache.hpp"
+
+#include <unistd.h>
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "libpldm/base.h"
+#include "libpldm/file_io.h"
+
+#include <gtest/gtest.h>
+
+#define SD_JOURNAL_SUPPRESS_LOCATION
+
+#include <systemd/sd-journal.h>
+
+extern "C" {
+
+int sd_journal_send(const char* /*format*/, ...)
+{
+    return 0;
+}
+
+int sd_journal_send_with_location(const char* /*file*/, const char* /*line*/,
+                                  const char* /*func*/,
+                                  const char* /*format*/, ...)
+{
+    return 0;
+}
+}
+
+using namespace pldm::responder;
+
+namespace
+{
+
+std::vector<uint8_t> dispatchRequest(const std::vector<uint8_t>& requestMsg)
+{
+    auto request = reinterpret_cast<const pldm_msg*>(requestMsg.data());
+    auto [response, length] = dispatch::handle(request, requestMsg.size());
+    return std::vector<uint8_t>(response, response + length);
+}
+
+} // namespace
+
+TEST(Dispatch, GetPLDMTypes)
+{
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    encode_get_types_req(5, reinterpret_cast<pldm_msg*>(requestMsg.data()));
+
+    auto responseMsg = dispatchRequest(requestMsg);
+    ASSERT_EQ(responseMsg.size(),
+              sizeof(pldm_msg_hdr) + PLDM_GET_TYPES_RESP_BYTES);
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+    ASSERT_EQ(response->hdr.instance_id, 5);
+
+    uint8_t completionCode = 0xFF;
+    std::array<bitfield8_t, PLDM_MAX_TYPES / 8> types{};
+    decode_get_types_resp(response->payload, PLDM_GET_TYPES_RESP_BYTES,
+                          &completionCode, types.data());
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(types[0].byte, 0x01);
+    ASSERT_EQ(types[PLDM_IBM_OEM_TYPE / 8].byte,
+              1 << (PLDM_IBM_OEM_TYPE % 8));
+}
+
+TEST(Dispatch, GetPLDMCommands)
+{
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
+                                    PLDM_GET_COMMANDS_REQ_BYTES);
+    ver32_t version{0xF1, 0xF0, 0xF0, 0x00};
+    encode_get_commands_req(1, PLDM_IBM_OEM_TYPE, version,
+                            reinterpret_cast<pldm_msg*>(requestMsg.data()));
+
+    auto responseMsg = dispatchRequest(requestMsg);
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+
+    uint8_t completionCode = 0xFF;
+    std::array<bitfield8_t, PLDM_MAX_CMDS_PER_TYPE / 8> commands{};
+    decode_get_commands_resp(response->payload, PLDM_GET_COMMANDS_RESP_BYTES,
+                             &completionCode, commands.data());
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(commands[0].byte, (1 << PLDM_GET_FILE_TABLE) |
+                                    (1 << PLDM_READ_FILE) |
+                                    (1 << PLDM_WRITE_FILE) |
+                                    (1 << PLDM_READ_FILE_INTO_MEMORY) |
+                                    (1 << PLDM_WRITE_FILE_FROM_MEMORY));
+    ASSERT_EQ(commands[PLDM_GET_CHANGED_BLOCKS / 8].byte,
+              (1 << (PLDM_GET_CHANGED_BLOCKS % 8)) |
+                  (1 << (PLDM_GET_FILE_CHECKSUM % 8)) |
+                  (1 << (PLDM_FOLLOW_FILE % 8)));
+    for (size_t i = 1; i < commands.size(); ++i)
+    {
+        if (i != PLDM_GET_CHANGED_BLOCKS / 8)
+        {
+            ASSERT_EQ(commands[i].byte, 0);
+        }
+    }
+
+    encode_get_commands_req(1, 0x02, version,
+                            reinterpret_cast<pldm_msg*>(requestMsg.data()));
+    responseMsg = dispatchRequest(requestMsg);
+    response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+    ASSERT_EQ(response->payload[0], PLDM_ERROR_INVALID_PLDM_TYPE);
+}
+
+TEST(Dispatch, Unsupported)
+{
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    pldm_header_info header{};
+    header.msg_type = PLDM_REQUEST;
+    header.instance = 9;
+    header.pldm_type = PLDM_IBM_OEM_TYPE;
+    header.command = 0x7F;
+    pack_pldm_header(&header, &request->hdr);
+
+    ASSERT_FALSE(dispatch::isSupported(PLDM_IBM_OEM_TYPE, 0x7F));
+    auto responseMsg = dispatchRequest(requestMsg);
+    ASSERT_EQ(responseMsg.size(), sizeof(pldm_msg_hdr) + 1);
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+    ASSERT_EQ(response->hdr.request, 0);
+    ASSERT_EQ(response->hdr.instance_id, 9);
+    ASSERT_EQ(response->hdr.command, 0x7F);
+    ASSERT_EQ(response->payload[0], PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+
+    header.pldm_type = 0x05;
+    header.command = PLDM_GET_FILE_TABLE;
+    pack_pldm_header(&header, &request->hdr);
+    responseMsg = dispatchRequest(requestMsg);
+    response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+    ASSERT_EQ(response->payload[0], PLDM_ERROR_INVALID_PLDM_TYPE);
+}
+
+TEST(Dispatch, RequestCount)
+{
+    auto before = dispatch::requestCount(PLDM_BASE, PLDM_GET_PLDM_TYPES);
+
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    encode_get_types_req(0, reinterpret_cast<pldm_msg*>(requestMsg.data()));
+    dispatchRequest(requestMsg);
+    dispatchRequest(requestMsg);
+
+    ASSERT_EQ(dispatch::requestCount(PLDM_BASE, PLDM_GET_PLDM_TYPES),
+              before + 2);
+}
+
+TEST(Dispatch, CallerBuffer)
+{
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    encode_get_types_req(0, reinterpret_cast<pldm_msg*>(requestMsg.data()));
+    auto request = reinterpret_cast<const pldm_msg*>(requestMsg.data());
+
+    std::array<uint8_t, sizeof(pldm_msg_hdr)> small{};
+    size_t length = small.size();
+    auto rc =
+        dispatch::handle(request, requestMsg.size(), small.data(), length);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+    ASSERT_EQ(length, sizeof(pldm_msg_hdr) + PLDM_GET_TYPES_RESP_BYTES);
+
+    std::vector<uint8_t> responseMsg(length);
+    rc = dispatch::handle(request, requestMsg.size(), responseMsg.data(),
+                          length);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+}
+
+TEST(Dispatch, NotARequest)
+{
+    std::vector<uint8_t> responseMsg(sizeof(pldm_msg_hdr) + 1);
+    encode_cc_only_resp(0, PLDM_BASE, PLDM_GET_PLDM_TYPES, PLDM_SUCCESS,
+                        reinterpret_cast<pldm_msg*>(responseMsg.data()));
+    auto message = reinterpret_cast<const pldm_msg*>(responseMsg.data());
+
+    auto [response, length] = dispatch::handle(message, responseMsg.size());
+    ASSERT_EQ(length, 0);
+
+    std::array<uint8_t, 64> buffer{};
+    size_t bufferLength = buffer.size();
+    ASSERT_EQ(dispatch::handle(message, responseMsg.size(), buffer.data(),
+                               bufferLength),
+              PLDM_ERROR_INVALID_DATA);
+}
+
+TEST(ReplayCache, LookupStore)
+{
+    using namespace std::chrono_literals;
+    ReplayCache cache(5s);
+    auto now = ReplayCache::Clock::now();
+
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
+                                    PLDM_GET_COMMANDS_REQ_BYTES);
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    ver32_t version{0xF1, 0xF0, 0xF0, 0x00};
+    encode_get_commands_req(7, PLDM_IBM_OEM_TYPE, version, request);
+
+    Response response;
+    ASSERT_FALSE(cache.lookup(8, request, requestMsg.size(), response, now));
+
+    std::vector<uint8_t> responseMsg{0x07, 0x00, 0x05, 0x00};
+    cache.store(8, request, requestMsg.size(), responseMsg.data(),
+                responseMsg.size(), now);
+
+    ASSERT_TRUE(
+        cache.lookup(8, request, requestMsg.size(), response, now + 4s));
+    ASSERT_EQ(response, responseMsg);
+    ASSERT_EQ(cache.hits(), 1);
+
+    // Another requester, an expired response and another payload for the
+    // same instance id are not retries
+    ASSERT_FALSE(cache.lookup(9, request, requestMsg.size(), response, now));
+    ASSERT_FALSE(
+        cache.lookup(8, request, requestMsg.size(), response, now + 6s));
+    encode_get_commands_req(7, PLDM_BASE, version, request);
+    ASSERT_FALSE(cache.lookup(8, request, requestMsg.size(), response, now));
+    ASSERT_EQ(cache.hits(), 1);
+
+    cache.clear();
+    encode_get_commands_req(7, PLDM_IBM_OEM_TYPE, version, request);
+    ASSERT_FALSE(cache.lookup(8, request, requestMsg.size(), response, now));
+}
+
+TEST(ReplayCache, RetryWaitsForRunningRequest)
+{
+    using namespace std::chrono_literals;
+    ReplayCache cache(5s);
+    auto now = ReplayCache::Clock::now();
+
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
+                                    PLDM_GET_COMMANDS_REQ_BYTES);
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    ver32_t version{0xF1, 0xF0, 0xF0, 0x00};
+    encode_get_commands_req(7, PLDM_IBM_OEM_TYPE, version, request);
+
+    std::vector<Response> waited;
+    auto wait = [&waited](const Response& response) {
+        waited.push_back(response);
+    };
+
+    Response response;
+    ASSERT_EQ(cache.start(8, request, requestMsg.size(), response, wait, now),
+              ReplayCache::Start::Started);
+
+    // Retries wait for the running request, even past the window
+    ASSERT_EQ(cache.start(8, request, requestMsg.size(), response, wait,
+                          now + 6s),
+              ReplayCache::Start::Waiting);
+    ASSERT_EQ(cache.start(8, request, requestMsg.size(), response, wait,
+                          now + 7s),
+              ReplayCache::Start::Waiting);
+    ASSERT_TRUE(waited.empty());
+
+    // A failed request answers the retries that waited, but not later ones
+    std::vector<uint8_t> responseMsg{0x07, 0x00, 0x05, 0x01};
+    cache.finish(8, request, requestMsg.size(), responseMsg.data(),
+                 responseMsg.size(), false, now + 8s);
+    ASSERT_EQ(waited.size(), 2);
+    ASSERT_EQ(waited[0], responseMsg);
+    ASSERT_EQ(waited[1], responseMsg);
+    ASSERT_EQ(cache.start(8, request, requestMsg.size(), response, wait,
+                          now + 8s),
+              ReplayCache::Start::Started);
+
+    // A successful one is replayed after it finished
+    responseMsg[3] = PLDM_SUCCESS;
+    cache.finish(8, request, requestMsg.size(), responseMsg.data(),
+                 responseMsg.size(), true, now + 9s);
+    ASSERT_EQ(waited.size(), 2);
+    ASSERT_EQ(cache.start(8, request, requestMsg.size(), response, wait,
+                          now + 10s),
+              ReplayCache::Start::Replayed);
+    ASSERT_EQ(response, responseMsg);
+
+    // A new request for the instance id replaces a running one, which then
+    // leaves the slot alone
+    auto first = requestMsg;
+    ASSERT_EQ(cache.start(8, request, requestMsg.size(), response, wait,
+                          now + 20s),
+              ReplayCache::Start::Started);
+    encode_get_commands_req(7, PLDM_BASE, version, request);
+    ASSERT_EQ(cache.start(8, request, requestMsg.size(), response, wait,
+                          now + 21s),
+              ReplayCache::Start::Started);
+    cache.finish(8, reinterpret_cast<pldm_msg*>(first.data()), first.size(),
+                 responseMsg.data(), responseMsg.size(), true, now + 22s);
+    ASSERT_EQ(cache.start(8, request, requestMsg.size(), response, wait,
+                          now + 22s),
+              ReplayCache::Start::Waiting);
+    ASSERT_EQ(cache.hits(), 4);
+}
+
+TEST(Dispatch, ReplayRetries)
+{
+    replayCache().clear();
+    auto hits = replayCache().hits();
+
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
+                                    PLDM_GET_COMMANDS_REQ_BYTES);
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    ver32_t version{0xF1, 0xF0, 0xF0, 0x00};
+    encode_get_commands_req(3, PLDM_IBM_OEM_TYPE, version, request);
+
+    auto [first, firstLength] =
+        dispatch::handle(8, request, requestMsg.size());
+    std::vector<uint8_t> firstResponse(first, first + firstLength);
+
+    auto [second, secondLength] =
+        dispatch::handle(8, request, requestMsg.size());
+    ASSERT_EQ(std::vector<uint8_t>(second, second + secondLength),
+              firstResponse);
+    ASSERT_EQ(replayCache().hits(), hits + 1);
+
+    // Failed requests run again
+    encode_get_commands_req(4, 0x02, version, request);
+    dispatch::handle(8, request, requestMsg.size());
+    dispatch::handle(8, request, requestMsg.size());
+    ASSERT_EQ(replayCache().hits(), hits + 1);
+}
+
+TEST(Dispatch, Capture)
+{
+    char tmppldm[] = "/tmp/pldm_capture.XXXXXX";
+    std::filesystem::path dir(mkdtemp(tmppldm));
+    ASSERT_TRUE(captureWriter().open(dir / "capture"));
+
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    encode_get_types_req(6, request);
+    dispatch::handle(12, request, requestMsg.size());
+
+    // Responses are not recorded
+    std::vector<uint8_t> responseMsg(requestMsg);
+    reinterpret_cast<pldm_msg*>(responseMsg.data())->hdr.request = 0;
+    dispatch::handle(12, reinterpret_cast<pldm_msg*>(responseMsg.data()),
+                     responseMsg.size());
+    captureWriter().close();
+
+    CaptureReader reader;
+    CaptureRecord record;
+    ASSERT_TRUE(reader.open(dir / "capture"));
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(record.eid, 12);
+    ASSERT_EQ(record.message, requestMsg);
+    ASSERT_FALSE(reader.next(record));
+    std::filesystem::remove_all(dir);
+}
+
+TEST(Dispatch, OrderingKey)
+{
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
+                                    PLDM_RW_FILE_MEM_REQ_BYTES);
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    encode_rw_file_memory_req(0, PLDM_WRITE_FILE_FROM_MEMORY, 0x12345678, 0,
+                              16, 0, request);
+    ASSERT_EQ(dispatch::orderingKey(request, requestMsg.size()), 0x12345678);
+
+    requestMsg.resize(sizeof(pldm_msg_hdr));
+    encode_get_types_req(0, request);
+    ASSERT_FALSE(dispatch::orderingKey(request, requestMsg.size()));
+}
+
+TEST(Dispatch, Submit)
+{
+    Executor executor(2);
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    encode_get_types_req(6, reinterpret_cast<pldm_msg*>(requestMsg.data()));
+
+    std::vector<uint8_t> responseMsg;
+    dispatch::submit(executor, 8, requestMsg,
+                     [&responseMsg](const uint8_t* response, size_t length) {
+                         responseMsg.assign(response, response + length);
+                     });
+    executor.wait();
+
+    ASSERT_EQ(responseMsg.size(),
+              sizeof(pldm_msg_hdr) + PLDM_GET_TYPES_RESP_BYTES);
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+    ASSERT_EQ(response->hdr.instance_id, 6);
+    ASSERT_EQ(response->payload[0], PLDM_SUCCESS);
+}
+
+TEST(Dispatch, SubmitToEventLoop)
+{
+    EventLoop loop;
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    encode_get_types_req(2, reinterpret_cast<pldm_msg*>(requestMsg.data()));
+
+    std::vector<uint8_t> responseMsg;
+    dispatch::submit(loop, 8, requestMsg,
+                     [&](const uint8_t* response, size_t length) {
+                         responseMsg.assign(response, response + length);
+                         loop.stop();
+                     });
+    loop.run();
+
+    auto response = reinterpret_cast<pldm_msg*>(responseMsg.data());
+    ASSERT_EQ(response->hdr.instance_id, 2);
+    ASSERT_EQ(response->payload[0], PLDM_SUCCESS);
+}
+
+TEST(Dispatch, RetryWaitsForTransfer)
+{
+    char tmpdir[] = "/tmp/pldm_dispatch.XXXXXX";
+    fs::path dir(mkdtemp(tmpdir));
+    fs::path file = dir / "NVRAM-IMAGE";
+    std::ofstream(file) << std::string(4096, 'a');
+    fs::path config = dir / "configFile.json";
+    std::ofstream(config) << "[{\"path\": " << file << ", \"file_traits\": 1}]";
+    auto& table = pldm::filetable::buildFileTable(config);
+    replayCache().clear();
+    auto hits = replayCache().hits();
+
+    EventLoop loop;
+    std::vector<std::vector<uint8_t>> responses;
+    auto reply = [&](const uint8_t* response, size_t length) {
+        responses.emplace_back(response, response + length);
+    };
+
+    std::vector<uint8_t> readMsg(sizeof(pldm_msg_hdr) +
+                                 PLDM_RW_FILE_MEM_REQ_BYTES);
+    encode_rw_file_memory_req(5, PLDM_READ_FILE_INTO_MEMORY, 0, 0, 256, 0,
+                              reinterpret_cast<pldm_msg*>(readMsg.data()));
+
+    // The requester times out and retries while the transfer runs
+    size_t calls = 0;
+    dma::DMA::emulate(
+        [&](const fs::path&, uint32_t, uint32_t, uint64_t, bool) {
+            calls++;
+            loop.post([&] { dispatch::submit(loop, 9, readMsg, reply); });
+            return 0;
+        });
+    dispatch::submit(loop, 9, readMsg, reply);
+
+    while (responses.size() < 2)
+    {
+        loop.runOnce(1000);
+    }
+
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(responses[0], responses[1]);
+    auto response = reinterpret_cast<pldm_msg*>(responses[0].data());
+    ASSERT_EQ(response->hdr.instance_id, 5);
+    ASSERT_EQ(response->payload[0], PLDM_SUCCESS);
+    ASSERT_EQ(replayCache().hits(), hits + 1);
+
+    dma::DMA::emulate(nullptr);
+    pldm::filetable::fileCache().clear();
+    table.clear();
+    fs::remove_all(dir);
+}
+
+TEST(Dispatch, FileCommandWaitsOffTheLoop)
+{
+    char tmpdir[] = "/tmp/pldm_dispatch.XXXXXX";
+    fs::path dir(mkdtemp(tmpdir));
+    fs::path file = dir / "NVRAM-IMAGE";
+    std::ofstream(file) << std::string(4096, 'a');
+    fs::path config = dir / "configFile.json";
+    std::ofstream(config) << "[{\"path\": " << file << ", \"file_traits\": 1}]";
+    auto& table = pldm::filetable::buildFileTable(config);
+
+    EventLoop loop;
+    size_t replies = 0;
+    std::vector<uint8_t> writeResponse;
+
+    std::vector<uint8_t> writeMsg(sizeof(pldm_msg_hdr) +
+                                  PLDM_WRITE_FILE_REQ_BYTES + 16);
+    encode_write_file_req(4, 0, 0, 16,
+                          reinterpret_cast<pldm_msg*>(writeMsg.data()));
+
+    // The first chunk of the read fails with -EBUSY while it holds its range
+    // lock, the overlapping WriteFile arrives in between. Chunks run off the
+    // loop, the WriteFile is submitted on it.
+    size_t calls = 0;
+    dma::DMA::emulate([&](const fs::path&, uint32_t, uint32_t, uint64_t,
+                          bool) {
+        if (calls++)
+        {
+            return 0;
+        }
+        loop.post([&] {
+            dispatch::submit(loop, 9, writeMsg,
+                             [&](const uint8_t* response, size_t length) {
+                                 writeResponse.assign(response,
+                                                      response + length);
+                                 replies++;
+                             });
+        });
+        return -EBUSY;
+    });
+
+    std::vector<uint8_t> readMsg(sizeof(pldm_msg_hdr) +
+                                 PLDM_RW_FILE_MEM_REQ_BYTES);
+    encode_rw_file_memory_req(3, PLDM_READ_FILE_INTO_MEMORY, 0, 0, 256, 0,
+                              reinterpret_cast<pldm_msg*>(readMsg.data()));
+    dispatch::submit(loop, 9, readMsg,
+                     [&](const uint8_t*, size_t) { replies++; });
+
+    while (replies < 2)
+    {
+        loop.runOnce(1000);
+    }
+
+    ASSERT_EQ(calls, 2);
+    auto response = reinterpret_cast<pldm_msg*>(writeResponse.data());
+    ASSERT_EQ(response->hdr.instance_id, 4);
+    ASSERT_EQ(response->payload[0], PLDM_SUCCESS);
+
+    dma::DMA::emulate(nullptr);
+    pldm::filetable::fileCache().clear();
+    table.clear();
+    fs::remove_all(dir);
+}
@@ -0,0 +1,135 @@
+#include "libpldmresponder/dma_scheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::responder;
+
+namespace
+{
+
+constexpr uint64_t chunk = 1024 * 1024;
+
+/** @brief Run the queued tickets to completion, in the order the scheduler
+ *         starts them
+ */
+std::vector<DMAScheduler::Ticket>
+    drain(DMAScheduler& scheduler, std::vector<DMAScheduler::Ticket> tickets)
+{
+    std::vector<DMAScheduler::Ticket> order;
+    while (!tickets.empty())
+    {
+        auto iter = tickets.begin();
+        while (!scheduler.tryStart(*iter))
+        {
+            ++iter;
+            if (iter == tickets.end())
+            {
+                ADD_FAILURE() << "No ticket could start";
+                return order;
+            }
+        }
+        order.push_back(*iter);
+        tickets.erase(iter);
+        scheduler.finish();
+    }
+    return order;
+}
+
+} // namespace
+
+TEST(DMAScheduler, Classify)
+{
+    EXPECT_EQ(classify(16), Priority::Interactive);
+    EXPECT_EQ(classify(interactiveMaxLength), Priority::Interactive);
+    EXPECT_EQ(classify(interactiveMaxLength + 16), Priority::Bulk);
+}
+
+TEST(DMAScheduler, InteractiveSkipsBulkBacklog)
+{
+    DMAScheduler scheduler({8, 1});
+
+    // A bulk transfer is on the engine with more chunks queued
+    auto running = scheduler.submit(Priority::Bulk, 16 * chunk);
+    ASSERT_TRUE(scheduler.tryStart(running));
+    std::vector<DMAScheduler::Ticket> bulk;
+    for (int i = 0; i < 3; ++i)
+    {
+        bulk.push_back(scheduler.submit(Priority::Bulk, 16 * chunk));
+    }
+    auto small = scheduler.submit(Priority::Interactive, 4096);
+
+    // The engine runs one chunk at a time
+    EXPECT_FALSE(scheduler.tryStart(bulk[0]));
+    EXPECT_FALSE(scheduler.tryStart(small));
+    scheduler.finish();
+
+    // The small chunk goes next, ahead of the queued bulk chunks, which
+    // keep their order
+    auto order = drain(scheduler, {bulk[0], bulk[1], bulk[2], small});
+    std::vector<DMAScheduler::Ticket> expected{small, bulk[0], bulk[1],
+                                               bulk[2]};
+    EXPECT_EQ(order, expected);
+}
+
+TEST(DMAScheduler, WeightedShare)
+{
+    DMAScheduler scheduler({4, 1});
+
+    // Both classes backlogged with chunks of the same length: the bulk
+    // class gets one chunk in five, ahead of the interactive chunk with the
+    // same tag since it was queued first
+    std::vector<DMAScheduler::Ticket> tickets;
+    std::vector<DMAScheduler::Ticket> bulk;
+    for (int i = 0; i < 4; ++i)
+    {
+        bulk.push_back(scheduler.submit(Priority::Bulk, chunk));
+        tickets.push_back(bulk.back());
+    }
+    for (int i = 0; i < 16; ++i)
+    {
+        tickets.push_back(scheduler.submit(Priority::Interactive, chunk));
+    }
+
+    auto order = drain(scheduler, tickets);
+    ASSERT_EQ(order.size(), tickets.size());
+    size_t bulkSeen = 0;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        if (std::find(bulk.begin(), bulk.end(), order[i]) != bulk.end())
+        {
+            ++bulkSeen;
+            EXPECT_EQ(i + 1, bulkSeen * 5 - 1);
+        }
+    }
+    EXPECT_EQ(bulkSeen, bulk.size());
+}
+
+TEST(DMAScheduler, AcquireWaitsForTurn)
+{
+    DMAScheduler scheduler({8, 1});
+    auto running = scheduler.submit(Priority::Bulk, 16 * chunk);
+    ASSERT_TRUE(scheduler.tryStart(running));
+
+    std::atomic<bool> started{false};
+    std::thread waiter([&] {
+        auto turn = scheduler.acquire(Priority::Interactive, 4096);
+        started = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_FALSE(started);
+
+    scheduler.finish();
+    waiter.join();
+    EXPECT_TRUE(started);
+
+    // The waiter freed the engine when its turn ended
+    auto next = scheduler.submit(Priority::Bulk, chunk);
+    EXPECT_TRUE(scheduler.tryStart(next));
+    scheduler.finish();
+}
@@ -0,0 +1,143 @@
+#include "libpldmresponder/executor.hpp"
+
+#include <array>
+#include <chrono>
+#include <future>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#define SD_JOURNAL_SUPPRESS_LOCATION
+
+#include <systemd/sd-journal.h>
+
+extern "C" {
+
+int sd_journal_send(const char* /*format*/, ...)
+{
+    return 0;
+}
+
+int sd_journal_send_with_location(const char* /*file*/, const char* /*line*/,
+                                  const char* /*func*/,
+                                  const char* /*format*/, ...)
+{
+    return 0;
+}
+}
+
+using namespace pldm::responder;
+using namespace std::chrono_literals;
+
+TEST(TaskQueue, PushPop)
+{
+    TaskQueue queue(4);
+    std::vector<int> order;
+    ASSERT_TRUE(queue.empty());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        Task task = [&order, i] { order.push_back(i); };
+        ASSERT_TRUE(queue.push(task));
+    }
+    Task full = [] {};
+    ASSERT_FALSE(queue.push(full));
+    ASSERT_TRUE(full);
+
+    Task task;
+    while (queue.pop(task))
+    {
+        task();
+    }
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(order, std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST(Executor, KeyedTasksRunInOrder)
+{
+    Executor executor(2, 16);
+    std::array<std::vector<int>, 4> order;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        executor.post(i % order.size(),
+                      [&order, i] { order[i % order.size()].push_back(i); });
+    }
+    executor.wait();
+
+    for (size_t key = 0; key < order.size(); ++key)
+    {
+        ASSERT_EQ(order[key].size(), 250);
+        for (size_t i = 1; i < order[key].size(); ++i)
+        {
+            ASSERT_LT(order[key][i - 1], order[key][i]);
+        }
+    }
+}
+
+TEST(Executor, KeysRunInParallel)
+{
+    Executor executor(2);
+    std::promise<void> started;
+    auto startedFuture = started.get_future();
+    std::future_status status{};
+
+    // The task for key 0 can only finish if the task for key 1 runs while it
+    // is still running
+    executor.post(0, [&] { status = startedFuture.wait_for(5s); });
+    executor.post(1, [&] { started.set_value(); });
+    executor.wait();
+
+    ASSERT_EQ(status, std::future_status::ready);
+}
+
+TEST(Executor, IdleWorkersSteal)
+{
+    Executor executor(2);
+    std::promise<void> release;
+    auto releaseFuture = release.get_future().share();
+    std::atomic<int> count{0};
+
+    executor.post(0, [releaseFuture] { releaseFuture.wait(); });
+    for (int i = 0; i < 10; ++i)
+    {
+        executor.post([&count] { count++; });
+    }
+
+    // Half of the tasks are queued on the blocked worker
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (count < 10 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_EQ(count, 10);
+
+    release.set_value();
+    executor.wait();
+}
+
+TEST(Executor, SlowKeyDoesNotHoldUpOthers)
+{
+    Executor executor(2);
+    std::promise<void> release;
+    auto releaseFuture = release.get_future().share();
+    std::atomic<int> count{0};
+
+    // Keys that map to the same worker are not held up by a slow task of
+    // one of them
+    executor.post(0, [releaseFuture] { releaseFuture.wait(); });
+    for (uint32_t key = 2; key < 20; key += 2)
+    {
+        executor.post(key, [&count] { count++; });
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (count < 9 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_EQ(count, 9);
+
+    release.set_value();
+    executor.wait();
+}
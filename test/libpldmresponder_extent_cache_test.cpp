@@ -0,0 +1,117 @@
+#include "libpldmresponder/extent_cache.hpp"
+#include "temp_file.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::responder;
+
+namespace
+{
+
+constexpr size_t blockSize = 64 * 1024;
+
+class SparseFile : public pldm::test::TempFile
+{
+  protected:
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(TempFile::SetUp());
+
+        // A 32 block file with data in blocks 1 and 20, holes elsewhere
+        ASSERT_EQ(ftruncate(fd, 32 * blockSize), 0);
+        fill(blockSize, blockSize, 'a');
+        fill(20 * blockSize, blockSize, 'b');
+        extentCache().clear();
+    }
+};
+
+} // namespace
+
+TEST_F(SparseFile, MapExtents)
+{
+    struct stat st
+    {
+    };
+    ASSERT_EQ(fstat(fd, &st), 0);
+    auto extents = extentCache().lookup(fd, path, st);
+
+    // File systems without hole support report the file as one extent
+    uint64_t mapped = 0;
+    for (const auto& extent : *extents)
+    {
+        mapped += extent.length;
+    }
+    if (extents->size() == 1 && mapped == 32 * blockSize)
+    {
+        GTEST_SKIP() << "no hole support for " << path;
+    }
+    ASSERT_EQ(extents->size(), 2u);
+    EXPECT_EQ((*extents)[0].offset, blockSize);
+    EXPECT_EQ((*extents)[0].length, blockSize);
+    EXPECT_EQ((*extents)[1].offset, 20 * blockSize);
+    EXPECT_EQ((*extents)[1].length, blockSize);
+
+    // The map is kept until the file changes
+    EXPECT_EQ(extentCache().lookup(fd, path, st), extents);
+    fill(30 * blockSize, blockSize, 'c');
+    ASSERT_EQ(fstat(fd, &st), 0);
+    auto changed = extentCache().lookup(fd, path, st);
+    EXPECT_NE(changed, extents);
+    EXPECT_EQ(changed->size(), 3u);
+}
+
+TEST_F(SparseFile, ReadSparse)
+{
+    // A range across a hole and the start of a data extent
+    uint64_t offset = 19 * blockSize + 100;
+    uint32_t length = 2 * blockSize;
+    std::vector<char> buffer(length);
+    ASSERT_EQ(readSparse(fd, path, offset, length, buffer.data()),
+              static_cast<ssize_t>(length));
+
+    std::vector<char> expected(length);
+    ASSERT_EQ(pread(fd, expected.data(), length, offset),
+              static_cast<ssize_t>(length));
+    EXPECT_EQ(buffer, expected);
+
+    // A range past the end of the file is cut short
+    buffer.assign(length, 0);
+    EXPECT_EQ(readSparse(fd, path, 31 * blockSize, length, buffer.data()),
+              static_cast<ssize_t>(blockSize));
+    EXPECT_EQ(readSparse(fd, path, 32 * blockSize, length, buffer.data()), 0);
+}
+
+TEST_F(SparseFile, HoleFilledByWrite)
+{
+    struct stat st
+    {
+    };
+    ASSERT_EQ(fstat(fd, &st), 0);
+    auto extents = extentCache().lookup(fd, path, st);
+    if (extents->size() == 1)
+    {
+        GTEST_SKIP() << "no hole support for " << path;
+    }
+
+    // Fill the hole at block 10 within the same timestamp tick, the size
+    // and modification time of the file stay the same
+    fill(10 * blockSize, blockSize, 'c');
+    struct timespec times[2] = {st.st_atim, st.st_mtim};
+    ASSERT_EQ(futimens(fd, times), 0);
+    ASSERT_EQ(fstat(fd, &st), 0);
+    EXPECT_EQ(extentCache().lookup(fd, path, st), extents);
+
+    // The responder drops the map after its writes
+    extentCache().invalidate(path);
+    std::vector<char> buffer(blockSize);
+    ASSERT_EQ(readSparse(fd, path, 10 * blockSize, blockSize, buffer.data()),
+              static_cast<ssize_t>(blockSize));
+    EXPECT_EQ(buffer, std::vector<char>(blockSize, 'c'));
+    EXPECT_EQ(extentCache().lookup(fd, path, st)->size(), 3u);
+}
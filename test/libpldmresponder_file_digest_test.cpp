@@ -0,0 +1,143 @@
+#include "libpldmresponder/crc32.hpp"
+#include "libpldmresponder/file_digest.hpp"
+#include "temp_file.hpp"
+
+#include <endian.h>
+#include <openssl/evp.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::filetable;
+
+namespace
+{
+
+constexpr size_t blockCount = 4;
+constexpr uint32_t fileSize = blockCount * digestBlockSize + 100;
+
+class DigestedFile : public pldm::test::TempFile
+{
+  protected:
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(TempFile::SetUp());
+
+        data.resize(fileSize);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<char>(i * 7 + i / 251);
+        }
+        writeAt(0, data.data(), fileSize);
+    }
+
+    /** @brief Write a range of the file and of the expected contents */
+    void write(uint32_t offset, uint32_t length, char value)
+    {
+        std::fill_n(data.begin() + offset, length, value);
+        fill(offset, length, value);
+    }
+
+    /** @brief CRC-32 of a range, little endian */
+    Digest crc(uint32_t offset, uint32_t length)
+    {
+        auto value =
+            htole32(pldm::crc32::compute(data.data() + offset, length));
+        auto bytes = reinterpret_cast<const uint8_t*>(&value);
+        return Digest(bytes, bytes + sizeof(value));
+    }
+
+    /** @brief SHA-256 of a range */
+    Digest sha(uint32_t offset, uint32_t length)
+    {
+        Digest digest(maxDigestLength);
+        EVP_Digest(data.data() + offset, length, digest.data(), nullptr,
+                   EVP_sha256(), nullptr);
+        return digest;
+    }
+
+    Digest digest(DigestType type, uint32_t offset, uint32_t length)
+    {
+        Digest result;
+        EXPECT_EQ(cache.digest(1, path, type, offset, length, result), 0);
+        return result;
+    }
+
+    DigestCache cache;
+    std::vector<char> data;
+};
+
+} // namespace
+
+TEST_F(DigestedFile, Ranges)
+{
+    EXPECT_EQ(digest(DigestType::CRC32, 0, fileSize), crc(0, fileSize));
+    EXPECT_EQ(digest(DigestType::SHA256, 0, fileSize), sha(0, fileSize));
+
+    // Pieces that do not start or end on a block
+    EXPECT_EQ(digest(DigestType::CRC32, 1000, 3 * digestBlockSize),
+              crc(1000, 3 * digestBlockSize));
+    EXPECT_EQ(digest(DigestType::SHA256, 1000, 3 * digestBlockSize),
+              sha(1000, 3 * digestBlockSize));
+    EXPECT_EQ(digest(DigestType::SHA256, 10, 20), sha(10, 20));
+
+    // The length is clipped to the end of the file
+    uint32_t length = UINT32_MAX;
+    Digest result;
+    ASSERT_EQ(cache.digest(1, path, DigestType::CRC32, 5, length, result), 0);
+    EXPECT_EQ(length, fileSize - 5);
+    EXPECT_EQ(result, crc(5, fileSize - 5));
+
+    ASSERT_EQ(cache.digest(1, path, DigestType::CRC32, fileSize, length,
+                           result),
+              -ERANGE);
+}
+
+TEST_F(DigestedFile, CachedBlocks)
+{
+    digest(DigestType::CRC32, 0, fileSize);
+    auto hashed = cache.bytesHashed();
+    EXPECT_EQ(hashed, fileSize);
+
+    // Whole blocks are not hashed again
+    EXPECT_EQ(digest(DigestType::CRC32, 0, fileSize), crc(0, fileSize));
+    EXPECT_EQ(cache.bytesHashed(), hashed);
+
+    // Only the block written by the responder is hashed again
+    write(digestBlockSize + 10, 10, 'x');
+    cache.invalidate(1, path, digestBlockSize + 10, 10);
+    EXPECT_EQ(digest(DigestType::CRC32, 0, fileSize), crc(0, fileSize));
+    EXPECT_EQ(cache.bytesHashed(), hashed + digestBlockSize);
+
+    // The whole file is hashed again after a write by someone else
+    hashed = cache.bytesHashed();
+    write(0, 10, 'y');
+    struct timespec times[2] = {{0, UTIME_OMIT}, {1, 0}};
+    ASSERT_EQ(futimens(fd, times), 0);
+    EXPECT_EQ(digest(DigestType::CRC32, 0, fileSize), crc(0, fileSize));
+    EXPECT_EQ(cache.bytesHashed(), hashed + fileSize);
+
+    // SHA-256 digests are not cached, the range is hashed every time
+    hashed = cache.bytesHashed();
+    EXPECT_EQ(digest(DigestType::SHA256, 0, fileSize), sha(0, fileSize));
+    EXPECT_EQ(digest(DigestType::SHA256, 0, fileSize), sha(0, fileSize));
+    EXPECT_EQ(cache.bytesHashed(), hashed + 2 * fileSize);
+}
+
+TEST_F(DigestedFile, Growth)
+{
+    digest(DigestType::CRC32, 0, fileSize);
+    auto hashed = cache.bytesHashed();
+
+    // Appending makes the old last block whole
+    data.resize(fileSize + digestBlockSize);
+    write(fileSize, digestBlockSize, 'z');
+    cache.invalidate(1, path, fileSize, digestBlockSize);
+    EXPECT_EQ(digest(DigestType::CRC32, 0, data.size()),
+              crc(0, data.size()));
+    EXPECT_EQ(cache.bytesHashed(), hashed + digestBlockSize + 100);
+}
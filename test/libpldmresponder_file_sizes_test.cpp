@@ -0,0 +1,81 @@
+#include "libpldmresponder/file_sizes.hpp"
+#include "temp_file.hpp"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::filetable;
+using namespace pldm::responder;
+
+namespace
+{
+
+class FollowedFile : public pldm::test::TempFile
+{
+  protected:
+    void SetUp() override
+    {
+        ASSERT_NO_FATAL_FAILURE(TempFile::SetUp());
+        append("first\n");
+    }
+
+    void append(const std::string& data)
+    {
+        writeAt(lseek(fd, 0, SEEK_END), data.data(), data.size());
+    }
+
+    uint32_t size()
+    {
+        uint32_t result = 0;
+        ino_t inode = 0;
+        EXPECT_EQ(sizes.size(1, path, result, inode), 0);
+        return result;
+    }
+
+    SizeCache sizes;
+};
+
+} // namespace
+
+TEST_F(FollowedFile, WithoutInotify)
+{
+    EXPECT_EQ(size(), 6u);
+    append("second\n");
+    EXPECT_EQ(size(), 13u);
+
+    fs::remove(path);
+    uint32_t result = 0;
+    ino_t inode = 0;
+    EXPECT_EQ(sizes.size(1, path, result, inode), -ENOENT);
+}
+
+TEST_F(FollowedFile, Inotify)
+{
+    EventLoop loop;
+    ASSERT_EQ(sizes.watch(loop), 0);
+    EXPECT_EQ(size(), 6u);
+
+    // The cached size is used until inotify reports the change
+    append("second\n");
+    EXPECT_EQ(size(), 6u);
+    ASSERT_GT(loop.runOnce(1000), 0u);
+    EXPECT_EQ(size(), 13u);
+
+    // Writes by the responder are seen without waiting for inotify
+    append("third\n");
+    sizes.invalidate(1);
+    EXPECT_EQ(size(), 19u);
+    loop.runOnce(100);
+
+    // A log that is rotated is followed from the new file
+    close(fd);
+    fd = -1;
+    fs::remove(path);
+    loop.runOnce(100);
+    std::ofstream(path) << "new";
+    EXPECT_EQ(size(), 3u);
+}
@@ -1,8 +1,19 @@
+#include "libpldmresponder/change_tracker.hpp"
+#include "libpldmresponder/file_cache.hpp"
+#include "libpldmresponder/file_digest.hpp"
 #include "libpldmresponder/file_io.hpp"
+#include "libpldmresponder/file_sizes.hpp"
+#include "libpldmresponder/file_stats.hpp"
 #include "libpldmresponder/file_table.hpp"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <boost/crc.hpp>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <nlohmann/json.hpp>
 
 #include "libpldm/base.h"
@@ -186,6 +197,184 @@ TEST(TransferDataHost, GoodPath)
                         &length, sizeof(length)));
 }
 
+TEST(TransferDataHost, AsyncTransfersInterleave)
+{
+    using namespace pldm::responder::dma;
+    using ::testing::InSequence;
+
+    EventLoop loop;
+    auto dmaObj = std::make_shared<MockDMA>();
+    fs::path first("/tmp/first");
+    fs::path second("/tmp/second");
+
+    // Each transfer yields to the loop after a chunk, so the chunks of the
+    // two transfers alternate
+    {
+        InSequence seq;
+        EXPECT_CALL(*dmaObj, transferDataHost(first, 0, maxSize, 0, true));
+        EXPECT_CALL(*dmaObj, transferDataHost(second, 0, maxSize, 0, false));
+        EXPECT_CALL(*dmaObj,
+                    transferDataHost(first, maxSize, minSize, maxSize, true));
+        EXPECT_CALL(*dmaObj, transferDataHost(second, maxSize, minSize,
+                                              maxSize, false));
+    }
+
+    std::vector<Response> responses;
+    auto done = [&responses](const uint8_t* response, size_t length) {
+        responses.emplace_back(response, response + length);
+    };
+    AsyncTransfer<MockDMA>::start(loop, dmaObj, PLDM_READ_FILE_INTO_MEMORY,
+                                  first, 0, maxSize + minSize, 0, true, done);
+    AsyncTransfer<MockDMA>::start(loop, dmaObj, PLDM_WRITE_FILE_FROM_MEMORY,
+                                  second, 0, maxSize + minSize, 0, false,
+                                  done);
+
+    while (responses.size() < 2)
+    {
+        loop.runOnce(1000);
+    }
+
+    uint32_t length = maxSize + minSize;
+    for (const auto& response : responses)
+    {
+        auto responsePtr = reinterpret_cast<const pldm_msg*>(response.data());
+        ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+        ASSERT_EQ(0, memcmp(responsePtr->payload + 1, &length, sizeof(length)));
+    }
+}
+
+TEST(TransferDataHost, AsyncTransferError)
+{
+    using namespace pldm::responder::dma;
+
+    EventLoop loop;
+    auto dmaObj = std::make_shared<MockDMA>();
+    EXPECT_CALL(*dmaObj, transferDataHost(_, _, _, _, _))
+        .WillOnce(Return(-1));
+
+    Response response;
+    AsyncTransfer<MockDMA>::start(
+        loop, dmaObj, PLDM_READ_FILE_INTO_MEMORY, "", 0, 2 * maxSize, 0, true,
+        [&response](const uint8_t* data, size_t length) {
+            response.assign(data, data + length);
+        });
+    while (response.empty())
+    {
+        loop.runOnce(1000);
+    }
+
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR);
+
+    // A failure after the first chunk completes with the bytes transferred
+    EXPECT_CALL(*dmaObj, transferDataHost(_, _, _, _, _))
+        .WillOnce(Return(0))
+        .WillOnce(Return(-1));
+    response.clear();
+    AsyncTransfer<MockDMA>::start(
+        loop, dmaObj, PLDM_WRITE_FILE_FROM_MEMORY, "", 0, 3 * maxSize, 0,
+        false, [&response](const uint8_t* data, size_t length) {
+            response.assign(data, data + length);
+        });
+    while (response.empty())
+    {
+        loop.runOnce(1000);
+    }
+
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_PARTIAL_TRANSFER);
+    uint32_t transferred = 0;
+    memcpy(&transferred, responsePtr->payload + 1, sizeof(transferred));
+    ASSERT_EQ(le32toh(transferred), maxSize);
+}
+
+TEST(TransferDataHost, AsyncChunkRunsOffTheLoop)
+{
+    using namespace pldm::responder::dma;
+    using ::testing::Invoke;
+
+    EventLoop loop;
+    auto dmaObj = std::make_shared<MockDMA>();
+
+    // The chunk only completes once the loop has run a task posted after
+    // the transfer started, which it cannot do if the chunk runs on it
+    std::promise<void> served;
+    auto servedFuture = served.get_future();
+    EXPECT_CALL(*dmaObj, transferDataHost(_, 0, minSize, 0, true))
+        .WillOnce(Invoke([&servedFuture](const fs::path&, uint32_t, uint32_t,
+                                         uint64_t, bool) {
+            return servedFuture.wait_for(std::chrono::seconds(5)) ==
+                           std::future_status::ready
+                       ? 0
+                       : -EIO;
+        }));
+
+    Response response;
+    AsyncTransfer<MockDMA>::start(
+        loop, dmaObj, PLDM_READ_FILE_INTO_MEMORY, "/tmp/offloop", 0, minSize,
+        0, true, [&response](const uint8_t* data, size_t length) {
+            response.assign(data, data + length);
+        });
+    ASSERT_EQ(loop.runOnce(0), 1);
+    loop.post([&served] { served.set_value(); });
+    while (response.empty())
+    {
+        loop.runOnce(1000);
+    }
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+}
+
+TEST(EventLoop, PostAfter)
+{
+    EventLoop loop;
+    std::vector<int> order;
+    auto start = EventLoop::Clock::now();
+    loop.postAfter(std::chrono::milliseconds(20),
+                   [&order] { order.push_back(2); });
+    loop.postAfter(std::chrono::milliseconds(10),
+                   [&order] { order.push_back(1); });
+    loop.post([&order] { order.push_back(0); });
+
+    while (order.size() < 3)
+    {
+        loop.runOnce(1000);
+    }
+    ASSERT_EQ(order, std::vector<int>({0, 1, 2}));
+    ASSERT_GE(EventLoop::Clock::now() - start, std::chrono::milliseconds(20));
+}
+
+TEST(TransferDataHost, AsyncTransferWaitsForLock)
+{
+    using namespace pldm::responder::dma;
+
+    EventLoop loop;
+    auto dmaObj = std::make_shared<MockDMA>();
+    fs::path path("/tmp/locked");
+    ASSERT_TRUE(rangeLocks().tryLock(path, 0, minSize, true));
+
+    Response response;
+    AsyncTransfer<MockDMA>::start(
+        loop, dmaObj, PLDM_READ_FILE_INTO_MEMORY, path, 0, minSize, 0, true,
+        [&response](const uint8_t* data, size_t length) {
+            response.assign(data, data + length);
+        });
+
+    // The step runs once and then sleeps until the lock is released
+    ASSERT_EQ(loop.runOnce(0), 1);
+    ASSERT_EQ(loop.runOnce(10), 0);
+    ASSERT_EQ(loop.runOnce(10), 0);
+
+    EXPECT_CALL(*dmaObj, transferDataHost(path, 0, minSize, 0, true));
+    rangeLocks().unlock(path.string(), {0, minSize, true});
+    while (response.empty())
+    {
+        loop.runOnce(1000);
+    }
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+}
+
 TEST(TransferDataHost, BadPath)
 {
     using namespace pldm::responder::dma;
@@ -209,6 +398,206 @@ TEST(TransferDataHost, BadPath)
                                     0, length, 0, true);
     responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR);
+
+    // A failure after the first chunk reports the bytes transferred, so the
+    // host resumes at offset + length
+    length = 2 * maxSize + minSize;
+    EXPECT_CALL(dmaObj, transferDataHost(_, _, _, _, _))
+        .WillOnce(Return(0))
+        .WillOnce(Return(-1));
+    response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
+                                    0, length, 0, true);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_PARTIAL_TRANSFER);
+    uint32_t transferred = 0;
+    memcpy(&transferred, responsePtr->payload + 1, sizeof(transferred));
+    ASSERT_EQ(le32toh(transferred), maxSize);
+}
+
+TEST(TransferDataHost, RetryTransientFailures)
+{
+    using namespace pldm::responder::dma;
+
+    MockDMA dmaObj;
+    fs::path path("");
+    uint32_t length = minSize;
+    auto before = metrics::counters();
+
+    // A busy engine is retried and the transfer succeeds
+    EXPECT_CALL(dmaObj, transferDataHost(path, 0, length, 0, true))
+        .WillOnce(Return(-EBUSY))
+        .WillOnce(Return(-EAGAIN))
+        .WillOnce(Return(0));
+    auto response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY,
+                                         path, 0, length, 0, true);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+    auto after = metrics::counters();
+    EXPECT_EQ(after.retries, before.retries + 2);
+    EXPECT_EQ(after.recovered, before.recovered + 1);
+
+    // Retries run out
+    EXPECT_CALL(dmaObj, transferDataHost(_, _, _, _, _))
+        .Times(RetryPolicy::retries + 1)
+        .WillRepeatedly(Return(-EBUSY));
+    response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
+                                    0, length, 0, true);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR);
+
+    // Other errors and other policies are not retried
+    EXPECT_CALL(dmaObj, transferDataHost(_, _, _, _, _))
+        .WillOnce(Return(-EIO));
+    response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
+                                    0, length, 0, true);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR);
+
+    EXPECT_CALL(dmaObj, transferDataHost(_, _, _, _, _))
+        .WillOnce(Return(-EBUSY));
+    response = transferAll<MockDMA, NoRetry>(
+        &dmaObj, PLDM_READ_FILE_INTO_MEMORY, path, 0, length, 0, true);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR);
+
+    // Transfers on an event loop retry after the backoff too
+    EventLoop loop;
+    auto asyncObj = std::make_shared<MockDMA>();
+    EXPECT_CALL(*asyncObj, transferDataHost(_, _, _, _, _))
+        .WillOnce(Return(-EAGAIN))
+        .WillOnce(Return(0));
+    response.clear();
+    AsyncTransfer<MockDMA>::start(
+        loop, asyncObj, PLDM_WRITE_FILE_FROM_MEMORY, "", 0, minSize, 0, false,
+        [&response](const uint8_t* data, size_t length) {
+            response.assign(data, data + length);
+        });
+    while (response.empty())
+    {
+        loop.runOnce(1000);
+    }
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+    EXPECT_EQ(metrics::counters().recovered, before.recovered + 2);
+    EXPECT_EQ(admission().inFlight(), 0u);
+}
+
+namespace
+{
+
+/** @brief Retry policy that checks what the chunk holds during the backoff
+ */
+struct ProbeRetry
+{
+    static constexpr unsigned retries = 1;
+    static inline bool heldDuringBackoff = true;
+
+    static std::chrono::microseconds backoff(unsigned)
+    {
+        using namespace pldm::responder;
+        auto locked = rangeLocks().tryLock("", 0, dma::minSize, true);
+        if (locked)
+        {
+            rangeLocks().unlock("", {0, dma::minSize, true});
+        }
+        heldDuringBackoff = !locked || admission().inFlight();
+        return std::chrono::microseconds(0);
+    }
+
+    static constexpr bool retryable(int)
+    {
+        return true;
+    }
+};
+
+} // namespace
+
+TEST(TransferDataHost, RetryReleasesChunk)
+{
+    using namespace pldm::responder::dma;
+
+    MockDMA dmaObj;
+    fs::path path("");
+    EXPECT_CALL(dmaObj, transferDataHost(path, 0, minSize, 0, false))
+        .WillOnce(Return(-EBUSY))
+        .WillOnce(Return(0));
+    auto response = transferAll<MockDMA, ProbeRetry>(
+        &dmaObj, PLDM_WRITE_FILE_FROM_MEMORY, path, 0, minSize, 0, false);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+    ASSERT_FALSE(ProbeRetry::heldDuringBackoff);
+}
+
+TEST(TransferDataHost, AsyncRetryReleasesChunk)
+{
+    using namespace pldm::responder::dma;
+
+    EventLoop loop;
+    auto dmaObj = std::make_shared<MockDMA>();
+    EXPECT_CALL(*dmaObj, transferDataHost(fs::path(""), 0, minSize, 0, false))
+        .WillOnce(Return(-EBUSY))
+        .WillOnce(Return(0));
+    ProbeRetry::heldDuringBackoff = true;
+
+    Response response;
+    AsyncTransfer<MockDMA, ProbeRetry>::start(
+        loop, dmaObj, PLDM_WRITE_FILE_FROM_MEMORY, "", 0, minSize, 0, false,
+        [&response](const uint8_t* data, size_t length) {
+            response.assign(data, data + length);
+        });
+    while (response.empty())
+    {
+        loop.runOnce(1000);
+    }
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+    ASSERT_FALSE(ProbeRetry::heldDuringBackoff);
+    EXPECT_EQ(admission().inFlight(), 0u);
+}
+
+TEST(TransferDataHost, NotAdmitted)
+{
+    using namespace pldm::responder::dma;
+
+    // A chunk larger than the budget is admitted on its own, and holds the
+    // whole budget until it is released
+    constexpr uint64_t held = uint64_t(1) << 40;
+    ASSERT_TRUE(admission().tryAdmit(held, std::chrono::nanoseconds(0)));
+    auto before = metrics::counters().notAdmitted;
+
+    MockDMA dmaObj;
+    fs::path path("");
+    EXPECT_CALL(dmaObj, transferDataHost(_, _, _, _, _)).Times(0);
+    auto response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY,
+                                         path, 0, minSize, 0, true);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    EXPECT_EQ(responsePtr->payload[0], PLDM_ERROR_NOT_READY);
+
+    EventLoop loop;
+    auto asyncObj = std::make_shared<MockDMA>();
+    EXPECT_CALL(*asyncObj, transferDataHost(_, _, _, _, _)).Times(0);
+    response.clear();
+    AsyncTransfer<MockDMA>::start(
+        loop, asyncObj, PLDM_WRITE_FILE_FROM_MEMORY, "", 0, minSize, 0, false,
+        [&response](const uint8_t* data, size_t length) {
+            response.assign(data, data + length);
+        });
+    while (response.empty())
+    {
+        loop.runOnce(1000);
+    }
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    EXPECT_EQ(responsePtr->payload[0], PLDM_ERROR_NOT_READY);
+    EXPECT_EQ(metrics::counters().notAdmitted, before + 2);
+
+    // Once the budget is released the transfers run, and return their bytes
+    admission().release(held);
+    EXPECT_CALL(dmaObj, transferDataHost(_, 0, minSize, 0, true)).Times(1);
+    response = transferAll<MockDMA>(&dmaObj, PLDM_READ_FILE_INTO_MEMORY, path,
+                                    0, minSize, 0, true);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    EXPECT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+    EXPECT_EQ(admission().inFlight(), 0u);
 }
 
 TEST(ReadFileIntoMemory, BadPath)
@@ -469,6 +858,28 @@ TEST_F(TestFileTable, ValidateFileTable)
               std::equal(attrTable.begin(), attrTable.end(), table.begin()));
 }
 
+TEST_F(TestFileTable, UpdateFileSize)
+{
+    FileTable tableObj(fileTableConfig.c_str());
+
+    // Change the size of NVRAM-IMAGE-CKSUM from 16 to 32 bytes, the size
+    // field of the second entry is at offset 48 in the table.
+    tableObj.updateFileSize(1, 32);
+
+    Table expected(attrTable.begin(), attrTable.end() - sizeof(uint32_t));
+    expected[48] = 0x20;
+    boost::crc_32_type result;
+    result.process_bytes(expected.data(), expected.size());
+    uint32_t checkSum = result.checksum();
+    expected.insert(expected.end(), reinterpret_cast<uint8_t*>(&checkSum),
+                    reinterpret_cast<uint8_t*>(&checkSum) + sizeof(checkSum));
+
+    ASSERT_EQ(tableObj(), expected);
+
+    // Test invalid file handle
+    ASSERT_THROW(tableObj.updateFileSize(2, 32), std::out_of_range);
+}
+
 TEST_F(TestFileTable, GetFileTableCommand)
 {
     // Initialise the file table with a valid handle of 0 & 1
@@ -502,6 +913,85 @@ TEST_F(TestFileTable, GetFileTableCommand)
     table.clear();
 }
 
+TEST_F(TestFileTable, GetFileTableCommandCallerBuffer)
+{
+    auto& table = buildFileTable(fileTableConfig.c_str());
+
+    std::array<uint8_t, PLDM_GET_FILE_TABLE_REQ_BYTES> requestMsg{};
+    auto request =
+        reinterpret_cast<pldm_get_file_table_req*>(requestMsg.data());
+    request->table_type = PLDM_FILE_ATTRIBUTE_TABLE;
+
+    constexpr size_t responseSize =
+        sizeof(pldm_msg_hdr) + PLDM_GET_FILE_TABLE_MIN_RESP_BYTES;
+
+    // The buffer is too small for the table, the required size is returned
+    std::array<uint8_t, responseSize> smallBuffer{};
+    size_t responseLength = smallBuffer.size();
+    auto rc = getFileTable(requestMsg.data(), requestMsg.size(),
+                           smallBuffer.data(), responseLength);
+    ASSERT_EQ(rc, PLDM_ERROR_INVALID_LENGTH);
+    ASSERT_EQ(responseLength, responseSize + attrTable.size());
+
+    std::vector<uint8_t> buffer(responseLength);
+    rc = getFileTable(requestMsg.data(), requestMsg.size(), buffer.data(),
+                      responseLength);
+    ASSERT_EQ(rc, PLDM_SUCCESS);
+    ASSERT_EQ(responseLength, buffer.size());
+    auto responsePtr = reinterpret_cast<pldm_msg*>(buffer.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+    ASSERT_EQ(0, memcmp(buffer.data() + responseSize, attrTable.data(),
+                        attrTable.size()));
+
+    // The per-thread arena grows to fit the table
+    auto [data, length] = encodeResponse(getFileTable, requestMsg.data(),
+                                         requestMsg.size());
+    ASSERT_EQ(length, buffer.size());
+    ASSERT_EQ(0, memcmp(data, buffer.data(), length));
+    table.clear();
+}
+
+namespace
+{
+
+// Asks for more space than it is given, like a handler whose file keeps
+// growing between runs
+int growingHandler(const uint8_t*, size_t, uint8_t*, size_t& responseLength)
+{
+    responseLength += 16;
+    return PLDM_ERROR_INVALID_LENGTH;
+}
+
+// Asks for more space on the first two runs only
+int grownHandler(const uint8_t*, size_t, uint8_t* response,
+                 size_t& responseLength)
+{
+    static int runs = 0;
+    if (++runs < 3)
+    {
+        responseLength += 16;
+        return PLDM_ERROR_INVALID_LENGTH;
+    }
+    responseLength = sizeof(pldm_msg_hdr) + 1;
+    response[sizeof(pldm_msg_hdr)] = PLDM_SUCCESS;
+    return PLDM_SUCCESS;
+}
+
+} // namespace
+
+TEST(EncodeResponse, ResponseOutgrowsArena)
+{
+    auto [data, length] = encodeResponse(grownHandler, nullptr, 0);
+    ASSERT_EQ(length, sizeof(pldm_msg_hdr) + 1);
+    ASSERT_EQ(data[sizeof(pldm_msg_hdr)], PLDM_SUCCESS);
+
+    // The request fails rather than returning more than the arena holds
+    auto [error, errorLength] = encodeResponse(growingHandler, nullptr, 0);
+    ASSERT_EQ(errorLength, sizeof(pldm_msg_hdr) + 1);
+    ASSERT_LE(errorLength, responseArena().size());
+    ASSERT_EQ(error[sizeof(pldm_msg_hdr)], PLDM_ERROR);
+}
+
 TEST_F(TestFileTable, GetFileTableCommandReqLengthMismatch)
 {
     std::array<uint8_t, PLDM_GET_FILE_TABLE_REQ_BYTES> requestMsg{};
@@ -522,6 +1012,9 @@ TEST_F(TestFileTable, GetFileTableCommandBufferNull)
 
 TEST_F(TestFileTable, GetFileTableCommandOEMAttrTable)
 {
+    // Initialise the file table with a valid handle of 0 & 1
+    auto& table = buildFileTable(fileTableConfig.c_str());
+
     uint32_t transferHandle = 0;
     uint8_t opFlag = 0;
     uint8_t type = PLDM_OEM_FILE_ATTRIBUTE_TABLE;
@@ -533,7 +1026,615 @@ TEST_F(TestFileTable, GetFileTableCommandOEMAttrTable)
     request->operation_flag = opFlag;
     request->table_type = type;
 
+    auto response = getFileTable(requestMsg.data(), requestMsg.size());
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+
+    // Two entries followed by the checksum
+    constexpr size_t tableOffset =
+        sizeof(pldm_msg_hdr) + PLDM_GET_FILE_TABLE_MIN_RESP_BYTES;
+    ASSERT_EQ(response.size(),
+              tableOffset + 2 * sizeof(pldm_oem_file_attr_entry) +
+                  sizeof(uint32_t));
+
+    auto entries =
+        reinterpret_cast<pldm_oem_file_attr_entry*>(&response[tableOffset]);
+    for (uint32_t handle = 0; handle < 2; ++handle)
+    {
+        std::ifstream stream(table.at(handle).fsPath, std::ios::binary);
+        std::vector<char> contents((std::istreambuf_iterator<char>(stream)),
+                                   std::istreambuf_iterator<char>());
+        boost::crc_32_type result;
+        result.process_bytes(contents.data(), contents.size());
+
+        ASSERT_EQ(entries[handle].file_handle, handle);
+        ASSERT_EQ(entries[handle].checksum, result.checksum());
+        ASSERT_EQ(entries[handle].generation, entries[0].generation);
+        ASSERT_EQ(entries[handle].alignment, defaultAlignment);
+    }
+    table.clear();
+}
+
+TEST_F(TestFileTable, GetFileTableCommandInvalidType)
+{
+    std::array<uint8_t, PLDM_GET_FILE_TABLE_REQ_BYTES> requestMsg{};
+    auto request =
+        reinterpret_cast<pldm_get_file_table_req*>(requestMsg.data());
+    request->table_type = PLDM_OEM_FILE_ATTRIBUTE_TABLE + 1;
+
     auto response = getFileTable(requestMsg.data(), requestMsg.size());
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
     ASSERT_EQ(responsePtr->payload[0], PLDM_INVALID_FILE_TABLE_TYPE);
 }
+
+TEST_F(TestFileTable, RefreshFileStamp)
+{
+    FileTable tableObj(fileTableConfig.c_str());
+
+    // The first refresh computes the stamp, it is not a change
+    ASSERT_FALSE(tableObj.refresh(1));
+    auto stamp = tableObj.stamp(1);
+    ASSERT_TRUE(stamp.valid);
+    ASSERT_EQ(stamp.size, 16);
+
+    // The generation starts from the time the table was built
+    auto generation = stamp.generation;
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+                   .count();
+    ASSERT_LE(generation, now);
+    ASSERT_GE(generation, now - 60);
+
+    // Nothing changed on disk
+    ASSERT_FALSE(tableObj.refresh(1));
+
+    // Grow the file, the generation and the size in the file attribute table
+    // are updated
+    {
+        std::ofstream stream(cksumFile, std::ios::app | std::ios::binary);
+        stream << std::string(16, 'x');
+    }
+    ASSERT_TRUE(tableObj.refresh(1));
+    stamp = tableObj.stamp(1);
+    ASSERT_EQ(stamp.size, 32);
+    ASSERT_EQ(stamp.generation, generation + 1);
+    ASSERT_EQ(tableObj()[48], 0x20);
+
+    // Rewrite the file with the same size and mtime, as a write within the
+    // mtime granularity would. Only an invalidated stamp is recomputed.
+    struct stat st
+    {
+    };
+    ASSERT_EQ(stat(cksumFile.c_str(), &st), 0);
+    {
+        std::ofstream stream(cksumFile, std::ios::in | std::ios::binary);
+        stream << std::string(32, 'y');
+    }
+    std::array<timespec, 2> times{st.st_atim, st.st_mtim};
+    ASSERT_EQ(utimensat(AT_FDCWD, cksumFile.c_str(), times.data(), 0), 0);
+    ASSERT_FALSE(tableObj.refresh(1));
+
+    fileDigests().invalidate(1, cksumFile, 0, 32);
+    tableObj.invalidate(1);
+    ASSERT_TRUE(tableObj.refresh(1));
+    ASSERT_EQ(tableObj.stamp(1).generation, generation + 2);
+}
+
+TEST_F(TestFileTable, OEMTableAfterWrite)
+{
+    auto& table = buildFileTable(fileTableConfig.c_str());
+
+    std::array<uint8_t, PLDM_GET_FILE_TABLE_REQ_BYTES> tableMsg{};
+    auto tableReq = reinterpret_cast<pldm_get_file_table_req*>(tableMsg.data());
+    tableReq->table_type = PLDM_OEM_FILE_ATTRIBUTE_TABLE;
+    constexpr size_t tableOffset =
+        sizeof(pldm_msg_hdr) + PLDM_GET_FILE_TABLE_MIN_RESP_BYTES;
+
+    auto response = getFileTable(tableMsg.data(), tableMsg.size());
+    auto entries =
+        reinterpret_cast<pldm_oem_file_attr_entry*>(&response[tableOffset]);
+    auto generation = entries[1].generation;
+
+    // Write through the handler, which invalidates the stamp itself
+    const std::string data = "grown!";
+    std::vector<uint8_t> writeMsg(PLDM_WRITE_FILE_REQ_BYTES + data.size());
+    auto writeReq = reinterpret_cast<pldm_write_file_req*>(writeMsg.data());
+    writeReq->file_handle = 1;
+    writeReq->offset = 12;
+    writeReq->length = data.size();
+    memcpy(writeReq->file_data, data.data(), data.size());
+    auto writeResp = writeFile(writeMsg.data(), writeMsg.size());
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(writeResp.data())->payload[0],
+              PLDM_SUCCESS);
+
+    // The OEM table has the checksum and generation of the new contents
+    response = getFileTable(tableMsg.data(), tableMsg.size());
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_SUCCESS);
+    entries =
+        reinterpret_cast<pldm_oem_file_attr_entry*>(&response[tableOffset]);
+
+    std::ifstream stream(cksumFile, std::ios::binary);
+    std::vector<char> contents((std::istreambuf_iterator<char>(stream)),
+                               std::istreambuf_iterator<char>());
+    ASSERT_EQ(contents.size(), 18);
+    boost::crc_32_type result;
+    result.process_bytes(contents.data(), contents.size());
+    ASSERT_EQ(entries[1].checksum, result.checksum());
+    ASSERT_EQ(entries[1].generation, generation + 1);
+
+    fileCache().clear();
+    table.clear();
+}
+
+TEST_F(TestFileTable, ReadFileInline)
+{
+    auto& table = buildFileTable(fileTableConfig.c_str());
+
+    // Read past the end of NVRAM-IMAGE-CKSUM, the length is truncated to the
+    // 8 bytes left in the file
+    std::array<uint8_t, PLDM_READ_FILE_REQ_BYTES> requestMsg{};
+    auto request = reinterpret_cast<pldm_read_file_req*>(requestMsg.data());
+    request->file_handle = 1;
+    request->offset = 8;
+    request->length = 64;
+
+    auto response = readFile(requestMsg.data(), requestMsg.size());
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+    ASSERT_EQ(response.size(),
+              sizeof(pldm_msg_hdr) + PLDM_READ_FILE_RESP_BYTES + 8);
+
+    std::ifstream stream(cksumFile, std::ios::binary);
+    std::vector<char> contents((std::istreambuf_iterator<char>(stream)),
+                               std::istreambuf_iterator<char>());
+    auto readResp =
+        reinterpret_cast<pldm_read_file_resp*>(responsePtr->payload);
+    ASSERT_EQ(readResp->length, 8);
+    ASSERT_EQ(0, memcmp(readResp->file_data, contents.data() + 8, 8));
+
+    // Invalid file handle
+    request->file_handle = 2;
+    response = readFile(requestMsg.data(), requestMsg.size());
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_INVALID_FILE_HANDLE);
+
+    // Offset beyond the end of the file
+    request->file_handle = 1;
+    request->offset = 16;
+    response = readFile(requestMsg.data(), requestMsg.size());
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_DATA_OUT_OF_RANGE);
+
+    // Invalid payload length
+    response = readFile(requestMsg.data(), 0);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR_INVALID_LENGTH);
+
+    fileCache().clear();
+    table.clear();
+}
+
+TEST_F(TestFileTable, WriteFileInline)
+{
+    auto& table = buildFileTable(fileTableConfig.c_str());
+
+    // Prime the cache with the current contents
+    std::array<uint8_t, PLDM_READ_FILE_REQ_BYTES> readMsg{};
+    auto readReq = reinterpret_cast<pldm_read_file_req*>(readMsg.data());
+    readReq->file_handle = 1;
+    readReq->length = 16;
+    auto response = readFile(readMsg.data(), readMsg.size());
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+
+    const std::string data = "inline";
+    std::vector<uint8_t> writeMsg(PLDM_WRITE_FILE_REQ_BYTES + data.size());
+    auto writeReq = reinterpret_cast<pldm_write_file_req*>(writeMsg.data());
+    writeReq->file_handle = 1;
+    writeReq->offset = 4;
+    writeReq->length = data.size();
+    memcpy(writeReq->file_data, data.data(), data.size());
+
+    response = writeFile(writeMsg.data(), writeMsg.size());
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+    auto writeResp =
+        reinterpret_cast<pldm_write_file_resp*>(responsePtr->payload);
+    ASSERT_EQ(writeResp->length, data.size());
+
+    // The file and the cached copy both have the new data
+    std::ifstream stream(cksumFile, std::ios::binary);
+    std::vector<char> contents((std::istreambuf_iterator<char>(stream)),
+                               std::istreambuf_iterator<char>());
+    ASSERT_EQ(0, memcmp(contents.data() + 4, data.data(), data.size()));
+
+    response = readFile(readMsg.data(), readMsg.size());
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    auto readResp =
+        reinterpret_cast<pldm_read_file_resp*>(responsePtr->payload);
+    ASSERT_EQ(0, memcmp(readResp->file_data, contents.data(), 16));
+
+    // Length field does not match the data in the payload
+    response = writeFile(writeMsg.data(), writeMsg.size() - 1);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_ERROR_INVALID_LENGTH);
+
+    fileCache().clear();
+    table.clear();
+}
+
+TEST_F(TestFileTable, FileCacheExternalWrite)
+{
+    FileCache cache(64, 1024);
+    std::array<uint8_t, 16> buffer{};
+
+    ASSERT_EQ(cache.read(1, cksumFile, 0, buffer.size(), buffer.data()), 16);
+
+    // Rewrite the file behind the cache, with a different size so the change
+    // is seen regardless of the mtime granularity
+    {
+        std::ofstream stream(cksumFile, std::ios::trunc | std::ios::binary);
+        stream << "changed";
+    }
+    ASSERT_EQ(cache.read(1, cksumFile, 0, buffer.size(), buffer.data()), 7);
+    ASSERT_EQ(0, memcmp(buffer.data(), "changed", 7));
+
+    // Files larger than the per-file limit are read directly
+    ASSERT_EQ(cache.read(0, imageFile, 1000, buffer.size(), buffer.data()), 16);
+}
+
+TEST_F(TestFileTable, FileAccountingTopFiles)
+{
+    auto& table = buildFileTable(fileTableConfig.c_str());
+    FileAccounting accounting;
+
+    ASSERT_FALSE(accounting.stats(0).has_value());
+
+    accounting.record(0, false, 100, std::chrono::microseconds(10));
+    accounting.record(0, true, 50, std::chrono::microseconds(30));
+    accounting.record(1, false, 1000, std::chrono::microseconds(5));
+    accounting.record(7, false, 10, std::chrono::microseconds(1));
+
+    auto stats = accounting.stats(0);
+    ASSERT_TRUE(stats.has_value());
+    ASSERT_EQ(stats->reads, 1);
+    ASSERT_EQ(stats->writes, 1);
+    ASSERT_EQ(stats->bytesRead, 100);
+    ASSERT_EQ(stats->bytesWritten, 50);
+    ASSERT_EQ(stats->meanLatency, 20000);
+    ASSERT_GE(stats->p99Latency, 30000);
+    ASSERT_GT(stats->lastAccess, 0);
+
+    // Busiest files first, by bytes transferred
+    auto top = accounting.top(2);
+    ASSERT_EQ(top.size(), 2);
+    ASSERT_EQ(top[0].handle, 1);
+    ASSERT_EQ(top[1].handle, 0);
+    ASSERT_EQ(accounting.top(10).size(), 3);
+
+    // Files are named from the table, handles not in it are not
+    auto report = accounting.report(3, &table);
+    ASSERT_EQ(report.find("file handle=1 name=NVRAM-IMAGE-CKSUM reads=1 "
+                          "writes=0 bytes_read=1000 bytes_written=0 "),
+              0);
+    ASSERT_NE(report.find("\nfile handle=0 name=NVRAM-IMAGE reads=1 writes=1 "
+                          "bytes_read=100 bytes_written=50 mean_ns=20000 "),
+              std::string::npos);
+    ASSERT_NE(report.find("\nfile handle=7 name=- reads=1 writes=0 "
+                          "bytes_read=10 bytes_written=0 "),
+              std::string::npos);
+    ASSERT_LT(report.find("handle=0 "), report.find("handle=7 "));
+
+    accounting.clear();
+    ASSERT_TRUE(accounting.top(10).empty());
+    table.clear();
+}
+
+TEST_F(TestFileTable, FileAccountingInline)
+{
+    auto& table = buildFileTable(fileTableConfig.c_str());
+    fileAccounting().clear();
+
+    std::array<uint8_t, PLDM_READ_FILE_REQ_BYTES> readMsg{};
+    auto readReq = reinterpret_cast<pldm_read_file_req*>(readMsg.data());
+    readReq->file_handle = 1;
+    readReq->offset = 8;
+    readReq->length = 64;
+    auto response = pldm::responder::readFile(readMsg.data(), readMsg.size());
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_SUCCESS);
+
+    const std::string data = "inline";
+    std::vector<uint8_t> writeMsg(PLDM_WRITE_FILE_REQ_BYTES + data.size());
+    auto writeReq = reinterpret_cast<pldm_write_file_req*>(writeMsg.data());
+    writeReq->file_handle = 1;
+    writeReq->length = data.size();
+    memcpy(writeReq->file_data, data.data(), data.size());
+    response = pldm::responder::writeFile(writeMsg.data(), writeMsg.size());
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_SUCCESS);
+
+    // Requests rejected before reaching a file are not accounted
+    readReq->file_handle = 2;
+    pldm::responder::readFile(readMsg.data(), readMsg.size());
+
+    auto stats = fileAccounting().stats(1);
+    ASSERT_TRUE(stats.has_value());
+    ASSERT_EQ(stats->reads, 1);
+    ASSERT_EQ(stats->writes, 1);
+    ASSERT_EQ(stats->bytesRead, 8);
+    ASSERT_EQ(stats->bytesWritten, data.size());
+    ASSERT_FALSE(fileAccounting().stats(2).has_value());
+
+    fileAccounting().clear();
+    fileCache().clear();
+    table.clear();
+}
+
+TEST_F(TestFileTable, EmulatedDMA)
+{
+    auto& table = buildFileTable(fileTableConfig.c_str());
+
+    std::vector<std::tuple<std::string, uint32_t, uint32_t, bool>> transfers;
+    pldm::responder::dma::DMA::emulate(
+        [&transfers](const fs::path& path, uint32_t offset, uint32_t length,
+                     uint64_t, bool upstream) {
+            transfers.emplace_back(path.filename(), offset, length, upstream);
+            return 0;
+        });
+
+    std::array<uint8_t, PLDM_RW_FILE_MEM_REQ_BYTES> requestMsg{};
+    uint32_t fileHandle = 0;
+    uint32_t offset = 64;
+    uint32_t length = 128;
+    memcpy(requestMsg.data(), &fileHandle, sizeof(fileHandle));
+    memcpy(requestMsg.data() + sizeof(fileHandle), &offset, sizeof(offset));
+    memcpy(requestMsg.data() + sizeof(fileHandle) + sizeof(offset), &length,
+           sizeof(length));
+
+    auto response = pldm::responder::readFileIntoMemory(requestMsg.data(),
+                                                        requestMsg.size());
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(responsePtr->payload[0], PLDM_SUCCESS);
+    ASSERT_EQ(transfers.size(), 1);
+    ASSERT_EQ(transfers[0],
+              std::make_tuple(std::string("NVRAM-IMAGE"), 64u, 128u, true));
+
+    pldm::responder::dma::DMA::emulate(nullptr);
+    fileCache().clear();
+    table.clear();
+}
+
+TEST_F(TestFileTable, GetChangedBlocks)
+{
+    auto& table = buildFileTable(fileTableConfig.c_str());
+
+    auto getChanges = [](uint32_t fileHandle, uint64_t generation) {
+        std::array<uint8_t, PLDM_GET_CHANGED_BLOCKS_REQ_BYTES> requestMsg{};
+        auto request =
+            reinterpret_cast<pldm_get_changed_blocks_req*>(requestMsg.data());
+        request->file_handle = htole32(fileHandle);
+        request->generation = htole64(generation);
+        return pldm::responder::getChangedBlocks(requestMsg.data(),
+                                                 requestMsg.size());
+    };
+
+    // The whole file changed since generation 0
+    auto response = getChanges(1, 0);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    uint8_t completionCode = PLDM_ERROR;
+    uint64_t generation = 0;
+    uint32_t fileSize = 0;
+    uint32_t nextOffset = 0;
+    uint16_t rangeCount = 0;
+    size_t rangesOffset = 0;
+    ASSERT_EQ(decode_get_changed_blocks_resp(
+                  responsePtr->payload, response.size() - sizeof(pldm_msg_hdr),
+                  &completionCode, &generation, &fileSize, &nextOffset,
+                  &rangeCount, &rangesOffset),
+              PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(fileSize, 16);
+    ASSERT_EQ(nextOffset, 16);
+    ASSERT_EQ(rangeCount, 1);
+
+    // An inline write is reported since that generation
+    const std::string data = "inline";
+    std::vector<uint8_t> writeMsg(PLDM_WRITE_FILE_REQ_BYTES + data.size());
+    auto writeReq = reinterpret_cast<pldm_write_file_req*>(writeMsg.data());
+    writeReq->file_handle = 1;
+    writeReq->offset = 4;
+    writeReq->length = data.size();
+    memcpy(writeReq->file_data, data.data(), data.size());
+    response = writeFile(writeMsg.data(), writeMsg.size());
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_SUCCESS);
+
+    auto since = generation;
+    response = getChanges(1, since);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(decode_get_changed_blocks_resp(
+                  responsePtr->payload, response.size() - sizeof(pldm_msg_hdr),
+                  &completionCode, &generation, &fileSize, &nextOffset,
+                  &rangeCount, &rangesOffset),
+              PLDM_SUCCESS);
+    ASSERT_GT(generation, since);
+    ASSERT_EQ(rangeCount, 1);
+
+    // Nothing changed since the last generation
+    response = getChanges(1, generation);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(decode_get_changed_blocks_resp(
+                  responsePtr->payload, response.size() - sizeof(pldm_msg_hdr),
+                  &completionCode, &generation, &fileSize, &nextOffset,
+                  &rangeCount, &rangesOffset),
+              PLDM_SUCCESS);
+    ASSERT_EQ(rangeCount, 0);
+
+    response = getChanges(5, 0);
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_INVALID_FILE_HANDLE);
+
+    changeTracker().clear();
+    fileCache().clear();
+    table.clear();
+}
+
+TEST_F(TestFileTable, GetFileChecksum)
+{
+    auto& table = buildFileTable(fileTableConfig.c_str());
+
+    auto getChecksum = [](uint32_t fileHandle, uint32_t offset,
+                          uint32_t length, uint8_t type) {
+        std::array<uint8_t, PLDM_GET_FILE_CHECKSUM_REQ_BYTES> requestMsg{};
+        auto request =
+            reinterpret_cast<pldm_get_file_checksum_req*>(requestMsg.data());
+        request->file_handle = htole32(fileHandle);
+        request->offset = htole32(offset);
+        request->length = htole32(length);
+        request->checksum_type = type;
+        return pldm::responder::getFileChecksum(requestMsg.data(),
+                                                requestMsg.size());
+    };
+
+    std::ifstream stream(imageFile, std::ios::in | std::ios::binary);
+    std::vector<char> contents(std::istreambuf_iterator<char>(stream), {});
+    boost::crc_32_type result;
+    result.process_bytes(contents.data() + 10, contents.size() - 10);
+    uint32_t expected = htole32(result.checksum());
+
+    // The length is clipped to the end of the file
+    auto response = getChecksum(0, 10, UINT32_MAX, PLDM_CHECKSUM_CRC32);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    uint8_t completionCode = PLDM_ERROR;
+    uint32_t length = 0;
+    uint8_t digestLength = 0;
+    size_t digestOffset = 0;
+    ASSERT_EQ(decode_get_file_checksum_resp(
+                  responsePtr->payload, response.size() - sizeof(pldm_msg_hdr),
+                  &completionCode, &length, &digestLength, &digestOffset),
+              PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(length, contents.size() - 10);
+    ASSERT_EQ(digestLength, sizeof(expected));
+    ASSERT_EQ(memcmp(responsePtr->payload + digestOffset, &expected,
+                     sizeof(expected)),
+              0);
+
+    response = getChecksum(0, 0, 16, PLDM_CHECKSUM_SHA256);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(decode_get_file_checksum_resp(
+                  responsePtr->payload, response.size() - sizeof(pldm_msg_hdr),
+                  &completionCode, &length, &digestLength, &digestOffset),
+              PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(length, 16);
+    ASSERT_EQ(digestLength, maxDigestLength);
+
+    response = getChecksum(0, 0, 16, 2);
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_INVALID_CHECKSUM_TYPE);
+    response = getChecksum(0, contents.size(), 16, PLDM_CHECKSUM_CRC32);
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_DATA_OUT_OF_RANGE);
+    response = getChecksum(5, 0, 16, PLDM_CHECKSUM_CRC32);
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_INVALID_FILE_HANDLE);
+
+    fileDigests().clear();
+    table.clear();
+}
+
+TEST_F(TestFileTable, FollowFile)
+{
+    auto& table = buildFileTable(fileTableConfig.c_str());
+
+    auto follow = [](uint32_t fileHandle, uint32_t cursor, uint32_t fileId,
+                     uint32_t length) {
+        std::array<uint8_t, PLDM_FOLLOW_FILE_REQ_BYTES> requestMsg{};
+        auto request =
+            reinterpret_cast<pldm_follow_file_req*>(requestMsg.data());
+        request->file_handle = htole32(fileHandle);
+        request->cursor = htole32(cursor);
+        request->file_id = htole32(fileId);
+        request->length = htole32(length);
+        return pldm::responder::followFile(requestMsg.data(),
+                                           requestMsg.size());
+    };
+
+    // The host is caught up with the end of the file
+    auto fileSize = fs::file_size(cksumFile);
+    auto response = follow(1, fileSize, 0, 100);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    uint8_t completionCode = PLDM_ERROR;
+    uint32_t cursor = 0;
+    uint32_t fileId = 0;
+    uint32_t size = 0;
+    uint32_t length = 0;
+    size_t dataOffset = 0;
+    ASSERT_EQ(decode_follow_file_resp(
+                  responsePtr->payload, response.size() - sizeof(pldm_msg_hdr),
+                  &completionCode, &cursor, &fileId, &size, &length,
+                  &dataOffset),
+              PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(cursor, fileSize);
+    ASSERT_NE(fileId, 0);
+    ASSERT_EQ(size, fileSize);
+    ASSERT_EQ(length, 0);
+
+    // Only the appended bytes are returned
+    const std::string appended = "appended line\n";
+    std::ofstream(cksumFile, std::ios::app) << appended;
+    fileSizes().invalidate(1);
+    auto id = fileId;
+    response = follow(1, cursor, id, 100);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(decode_follow_file_resp(
+                  responsePtr->payload, response.size() - sizeof(pldm_msg_hdr),
+                  &completionCode, &cursor, &fileId, &size, &length,
+                  &dataOffset),
+              PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_EQ(cursor, fileSize + appended.size());
+    ASSERT_EQ(fileId, id);
+    ASSERT_EQ(size, fileSize + appended.size());
+    ASSERT_EQ(length, appended.size());
+    ASSERT_EQ(memcmp(responsePtr->payload + dataOffset, appended.data(),
+                     appended.size()),
+              0);
+
+    // A cursor past the end means the file was truncated
+    response = follow(1, cursor + 1, id, 100);
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_DATA_OUT_OF_RANGE);
+
+    // A log rotated to a file larger than the cursor is followed from its
+    // start
+    const std::string rotated(cursor + 200, 'r');
+    auto next = dir / "NVRAM-IMAGE-CKSUM.next";
+    std::ofstream(next) << rotated;
+    fs::rename(next, cksumFile);
+    response = follow(1, cursor, id, 100);
+    responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    ASSERT_EQ(decode_follow_file_resp(
+                  responsePtr->payload, response.size() - sizeof(pldm_msg_hdr),
+                  &completionCode, &cursor, &fileId, &size, &length,
+                  &dataOffset),
+              PLDM_SUCCESS);
+    ASSERT_EQ(completionCode, PLDM_SUCCESS);
+    ASSERT_NE(fileId, id);
+    ASSERT_EQ(size, rotated.size());
+    ASSERT_EQ(length, 100);
+    ASSERT_EQ(cursor, 100);
+    ASSERT_EQ(memcmp(responsePtr->payload + dataOffset, rotated.data(), 100),
+              0);
+
+    response = follow(5, 0, 0, 100);
+    ASSERT_EQ(reinterpret_cast<pldm_msg*>(response.data())->payload[0],
+              PLDM_INVALID_FILE_HANDLE);
+
+    fileSizes().clear();
+    table.clear();
+}
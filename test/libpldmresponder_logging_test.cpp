@@ -0,0 +1,111 @@
+#include "libpldmresponder/logging.hpp"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#define SD_JOURNAL_SUPPRESS_LOCATION
+
+#include <systemd/sd-journal.h>
+
+size_t messages = 0;
+
+extern "C" {
+
+int sd_journal_send(const char* /*format*/, ...)
+{
+    ++messages;
+    return 0;
+}
+
+int sd_journal_send_with_location(const char* /*file*/, const char* /*line*/,
+                                  const char* /*func*/,
+                                  const char* /*format*/, ...)
+{
+    ++messages;
+    return 0;
+}
+}
+
+using namespace pldm::responder::logging;
+using namespace phosphor::logging;
+using namespace std::chrono_literals;
+
+TEST(RateLimiter, BurstThenRate)
+{
+    RateLimiter limiter(3, 2);
+    auto now = RateLimiter::Clock::now();
+    uint64_t suppressed = 0;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(limiter.allow(suppressed, now));
+        ASSERT_EQ(suppressed, 0);
+    }
+    ASSERT_FALSE(limiter.allow(suppressed, now));
+    ASSERT_FALSE(limiter.allow(suppressed, now + 100ms));
+
+    // A token is refilled every 500ms, the message carries the count of
+    // messages suppressed before it
+    ASSERT_TRUE(limiter.allow(suppressed, now + 500ms));
+    ASSERT_EQ(suppressed, 2);
+    ASSERT_FALSE(limiter.allow(suppressed, now + 600ms));
+    ASSERT_TRUE(limiter.allow(suppressed, now + 1000ms));
+    ASSERT_EQ(suppressed, 1);
+
+    // The bucket does not fill past the burst
+    now += 1h;
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(limiter.allow(suppressed, now));
+        ASSERT_EQ(suppressed, 0);
+    }
+    ASSERT_FALSE(limiter.allow(suppressed, now));
+}
+
+TEST(PLDMLog, RateLimitedPerSite)
+{
+    messages = 0;
+    int evaluated = 0;
+    auto value = [&evaluated] { return ++evaluated; };
+
+    for (int i = 0; i < 100; ++i)
+    {
+        PLDM_LOG(ERR, "flood", entry("VALUE=%d", value()));
+    }
+    ASSERT_EQ(messages, 10);
+    ASSERT_EQ(evaluated, 10);
+
+    // Another call site has its own limit
+    PLDM_LOG(ERR, "other", entry("VALUE=%d", value()));
+    ASSERT_EQ(messages, 11);
+}
+
+TEST(PLDMLog, FlushSuppressed)
+{
+    // Drop the counts left by the other tests
+    flushSuppressed();
+    for (int i = 0; i < 15; ++i)
+    {
+        PLDM_LOG(ERR, "storm");
+    }
+
+    // The 5 messages suppressed at the end of the storm are reported once
+    messages = 0;
+    flushSuppressed();
+    ASSERT_EQ(messages, 1);
+    flushSuppressed();
+    ASSERT_EQ(messages, 1);
+}
+
+TEST(PLDMLog, CompiledOutBelowThreshold)
+{
+    static_assert(enabled(level::ERR));
+    static_assert(enabled(level::DEBUG) == (maxLevel == level::DEBUG));
+
+    messages = 0;
+    int evaluated = 0;
+    PLDM_LOG(DEBUG, "debug", entry("VALUE=%d", ++evaluated));
+    ASSERT_EQ(messages, enabled(level::DEBUG) ? 1 : 0);
+    ASSERT_EQ(evaluated, messages);
+}
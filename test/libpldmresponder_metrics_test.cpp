@@ -0,0 +1,164 @@
+#include "libpldmresponder/metrics.hpp"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::responder;
+using namespace std::chrono_literals;
+
+TEST(Histogram, Buckets)
+{
+    using metrics::Histogram;
+
+    // Small values have a bucket each, larger ones share a bucket with
+    // values within 12.5% of them
+    for (uint64_t value : {0, 1, 7, 8, 15, 16, 100, 1000, 123456789})
+    {
+        auto index = Histogram::bucketIndex(value);
+        ASSERT_GE(Histogram::bucketUpperBound(index), value);
+        if (index)
+        {
+            ASSERT_LT(Histogram::bucketUpperBound(index - 1), value);
+        }
+        ASSERT_LE(Histogram::bucketUpperBound(index) - value, value / 8);
+    }
+    ASSERT_EQ(Histogram::bucketIndex(UINT64_MAX), Histogram::bucketCount - 1);
+}
+
+TEST(Histogram, Percentiles)
+{
+    metrics::Histogram histogram;
+    ASSERT_EQ(histogram.percentile(50), 0);
+
+    for (uint64_t value = 1; value <= 1000; ++value)
+    {
+        histogram.record(value * 1000);
+    }
+    ASSERT_EQ(histogram.count(), 1000);
+    ASSERT_EQ(histogram.maxValue(), 1000000);
+    ASSERT_EQ(histogram.totalValue(), 500500000);
+
+    auto p50 = histogram.percentile(50);
+    ASSERT_GE(p50, 500000);
+    ASSERT_LE(p50, 500000 * 9 / 8);
+    auto p99 = histogram.percentile(99);
+    ASSERT_GE(p99, 990000);
+    ASSERT_LE(p99, 1000000);
+
+    histogram.clear();
+    ASSERT_EQ(histogram.count(), 0);
+}
+
+TEST(Histogram, NearestRank)
+{
+    metrics::Histogram histogram;
+    histogram.record(1000);
+    histogram.record(2000);
+    histogram.record(1000000);
+
+    // 90% of 3 values is rank 2.7, rounded up to the largest value
+    ASSERT_GE(histogram.percentile(90), 1000000);
+    ASSERT_LE(histogram.percentile(34), 2000 * 9 / 8);
+    ASSERT_GE(histogram.percentile(34), 2000);
+}
+
+TEST(Metrics, CommandsAndChunks)
+{
+    metrics::reset();
+    metrics::recordCommand(0x3F, 6, 0, 2us);
+    metrics::recordCommand(0x3F, 6, 0, 4us);
+    metrics::recordCommand(0x3F, 6, 2, 1us);
+    metrics::recordChunk(4096, true, true);
+    metrics::recordChunk(16, false, true);
+    metrics::recordChunk(16, false, false);
+    metrics::recordDedup(4096, 12288);
+
+    auto histogram = metrics::commandHistogram(0x3F, 6, 0);
+    ASSERT_NE(histogram, nullptr);
+    ASSERT_EQ(histogram->count(), 2);
+    ASSERT_EQ(metrics::commandHistogram(0x3F, 6, 2)->count(), 1);
+    ASSERT_EQ(metrics::commandHistogram(0x3F, 7, 0), nullptr);
+
+    auto counters = metrics::counters();
+    ASSERT_EQ(counters.bytesToHost, 4096);
+    ASSERT_EQ(counters.bytesFromHost, 16);
+    ASSERT_EQ(counters.chunks, 2);
+    ASSERT_EQ(counters.chunkErrors, 1);
+    ASSERT_EQ(counters.bytesWritten, 4096);
+    ASSERT_EQ(counters.bytesSkipped, 12288);
+
+    auto text = metrics::dump();
+    ASSERT_NE(text.find("command type=63 command=6 cc=0 count=2"),
+              std::string::npos);
+    ASSERT_NE(text.find("dma bytes_to_host=4096 bytes_from_host=16 chunks=2 "
+                        "chunk_errors=1"),
+              std::string::npos);
+    ASSERT_NE(text.find("dedup bytes_written=4096 bytes_skipped=12288"),
+              std::string::npos);
+
+    // Combinations beyond the pool are counted in the overflow histogram
+    for (int cc = 0; cc < 64; ++cc)
+    {
+        metrics::recordCommand(0, 1, cc, 1us);
+    }
+    ASSERT_NE(metrics::dump().find("command overflow"), std::string::npos);
+}
+
+TEST(Metrics, Sections)
+{
+    metrics::reset();
+    metrics::addSection([] { return std::string("section key=1\n"); });
+
+    auto text = metrics::dump();
+    ASSERT_NE(text.find("\nsection key=1\n"), std::string::npos);
+    ASSERT_GT(text.find("section key=1"), text.find("admission "));
+}
+
+TEST(Metrics, DumpToFileAndSocket)
+{
+    metrics::reset();
+    metrics::recordCommand(0, 4, 0, 1us);
+
+    char dir[] = "/tmp/pldm_metrics.XXXXXX";
+    std::string base(mkdtemp(dir));
+    auto filePath = base + "/metrics";
+    ASSERT_EQ(metrics::dumpToFile(filePath), 0);
+
+    std::ifstream file(filePath);
+    std::stringstream content;
+    content << file.rdbuf();
+    ASSERT_EQ(content.str(), metrics::dump());
+
+    EventLoop loop;
+    auto socketPath = base + "/metrics.sock";
+    ASSERT_EQ(metrics::serve(loop, socketPath), 0);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)),
+              0);
+    loop.runOnce(1000);
+
+    std::string received;
+    char buffer[256];
+    ssize_t count = 0;
+    while ((count = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        received.append(buffer, count);
+    }
+    close(fd);
+    ASSERT_EQ(received, metrics::dump());
+
+    unlink(socketPath.c_str());
+    unlink(filePath.c_str());
+    rmdir(base.c_str());
+}
@@ -0,0 +1,104 @@
+#include "libpldmresponder/range_lock.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::responder;
+using namespace std::chrono_literals;
+
+TEST(RangeLock, SharedRangesOverlap)
+{
+    RangeLockManager manager;
+    auto first = manager.lock("/tmp/file", 0, 100, false);
+    ASSERT_TRUE(manager.tryLock("/tmp/file", 50, 100, false));
+    ASSERT_FALSE(manager.tryLock("/tmp/file", 99, 1, true));
+    manager.unlock("/tmp/file", {50, 100, false});
+}
+
+TEST(RangeLock, ExclusiveRanges)
+{
+    RangeLockManager manager;
+    {
+        auto guard = manager.lock("/tmp/file", 100, 100, true);
+
+        // Adjacent ranges and other files do not conflict
+        ASSERT_TRUE(manager.tryLock("/tmp/file", 0, 100, true));
+        ASSERT_TRUE(manager.tryLock("/tmp/file", 200, 100, false));
+        ASSERT_TRUE(manager.tryLock("/tmp/other", 100, 100, true));
+        ASSERT_FALSE(manager.tryLock("/tmp/file", 199, 2, false));
+        ASSERT_FALSE(manager.tryLock("/tmp/file", 0, 101, true));
+
+        manager.unlock("/tmp/file", {0, 100, true});
+        manager.unlock("/tmp/file", {200, 100, false});
+        manager.unlock("/tmp/other", {100, 100, true});
+    }
+    ASSERT_TRUE(manager.tryLock("/tmp/file", 0, 300, true));
+    manager.unlock("/tmp/file", {0, 300, true});
+}
+
+TEST(RangeLock, WaitForConflictingLock)
+{
+    RangeLockManager manager;
+    std::atomic<bool> locked{false};
+
+    auto guard = std::make_unique<RangeLockManager::Guard>(
+        manager.lock("/tmp/file", 0, 4096, true));
+    std::thread waiter([&] {
+        auto other = manager.lock("/tmp/file", 1024, 16, false);
+        locked = true;
+    });
+
+    std::this_thread::sleep_for(50ms);
+    ASSERT_FALSE(locked);
+
+    guard.reset();
+    waiter.join();
+    ASSERT_TRUE(locked);
+}
+
+TEST(RangeLock, WaitingWriterHoldsReadersBack)
+{
+    RangeLockManager manager;
+    std::atomic<bool> locked{false};
+
+    auto reader = std::make_unique<RangeLockManager::Guard>(
+        manager.lock("/tmp/file", 0, 4096, false));
+    std::thread writer([&] {
+        auto other = manager.lock("/tmp/file", 1024, 16, true);
+        locked = true;
+    });
+    std::this_thread::sleep_for(50ms);
+    ASSERT_FALSE(locked);
+
+    // New readers of the range the writer waits for are refused, others are
+    // not
+    ASSERT_FALSE(manager.tryLock("/tmp/file", 0, 2048, false));
+    ASSERT_TRUE(manager.tryLock("/tmp/file", 2048, 16, false));
+    manager.unlock("/tmp/file", {2048, 16, false});
+
+    reader.reset();
+    writer.join();
+    ASSERT_TRUE(locked);
+    ASSERT_TRUE(manager.tryLock("/tmp/file", 0, 2048, false));
+    manager.unlock("/tmp/file", {0, 2048, false});
+}
+
+TEST(RangeLock, WaitingTryLockWriterHoldsReadersBack)
+{
+    RangeLockManager manager;
+    bool woken = false;
+
+    ASSERT_TRUE(manager.tryLock("/tmp/file", 0, 4096, false));
+    ASSERT_FALSE(manager.tryLock("/tmp/file", 1024, 16, true,
+                                 [&woken] { woken = true; }));
+    ASSERT_FALSE(manager.tryLock("/tmp/file", 1000, 100, false));
+
+    // Once woken the writer has to try again, readers are let in meanwhile
+    manager.unlock("/tmp/file", {0, 4096, false});
+    ASSERT_TRUE(woken);
+    ASSERT_TRUE(manager.tryLock("/tmp/file", 1000, 100, false));
+    manager.unlock("/tmp/file", {1000, 100, false});
+}
@@ -0,0 +1,227 @@
+#include "libpldmresponder/transport.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "libpldm/base.h"
+#include "libpldm/file_io.h"
+
+#include <gtest/gtest.h>
+
+#define SD_JOURNAL_SUPPRESS_LOCATION
+
+#include <systemd/sd-journal.h>
+
+extern "C" {
+
+int sd_journal_send(const char* /*format*/, ...)
+{
+    return 0;
+}
+
+int sd_journal_send_with_location(const char* /*file*/, const char* /*line*/,
+                                  const char* /*func*/,
+                                  const char* /*format*/, ...)
+{
+    return 0;
+}
+}
+
+using namespace pldm::responder;
+
+namespace
+{
+
+std::string socketName()
+{
+    return "@pldm_transport_test." + std::to_string(getpid());
+}
+
+std::vector<uint8_t> getTypesFrame(uint8_t eid, uint8_t instanceId)
+{
+    std::vector<uint8_t> frame{eid, transport::mctpTypePldm};
+    frame.resize(transport::frameHeaderSize + sizeof(pldm_msg_hdr));
+    encode_get_types_req(instanceId, reinterpret_cast<pldm_msg*>(
+                                         frame.data() +
+                                         transport::frameHeaderSize));
+    return frame;
+}
+
+} // namespace
+
+TEST(Transport, HandleFrame)
+{
+    uint8_t header[transport::frameHeaderSize]{};
+    auto frame = getTypesFrame(9, 3);
+    auto [response, length] =
+        transport::handleFrame(frame.data(), frame.size(), header);
+    ASSERT_EQ(length, sizeof(pldm_msg_hdr) + PLDM_GET_TYPES_RESP_BYTES);
+    EXPECT_EQ(header[0], 9);
+    EXPECT_EQ(header[1], transport::mctpTypePldm);
+    auto msg = reinterpret_cast<const pldm_msg*>(response);
+    EXPECT_EQ(msg->hdr.instance_id, 3);
+    EXPECT_EQ(msg->payload[0], PLDM_SUCCESS);
+
+    // Other message types and short frames are not answered
+    frame[1] = 0x7E;
+    EXPECT_EQ(transport::handleFrame(frame.data(), frame.size(), header).second,
+              0u);
+    EXPECT_EQ(transport::handleFrame(frame.data(), 1, header).second, 0u);
+}
+
+TEST(Transport, ServeConnections)
+{
+    auto name = socketName();
+    int listenFd = transport::listenSocket(name);
+    ASSERT_GE(listenFd, 0);
+
+    EventLoop loop;
+    transport::Server server(loop, listenFd);
+
+    std::vector<int> clients;
+    for (int i = 0; i < 2; ++i)
+    {
+        int fd = transport::connectSocket(name);
+        ASSERT_GE(fd, 0);
+        clients.push_back(fd);
+    }
+    loop.runOnce(1000);
+    EXPECT_EQ(server.connections(), 2u);
+
+    for (size_t i = 0; i < clients.size(); ++i)
+    {
+        auto frame = getTypesFrame(8 + i, i);
+        ASSERT_EQ(send(clients[i], frame.data(), frame.size(), 0),
+                  static_cast<ssize_t>(frame.size()));
+    }
+    loop.runOnce(1000);
+
+    for (size_t i = 0; i < clients.size(); ++i)
+    {
+        std::vector<uint8_t> response(transport::maxFrameSize);
+        auto length = recv(clients[i], response.data(), response.size(),
+                           MSG_DONTWAIT);
+        ASSERT_EQ(length, static_cast<ssize_t>(transport::frameHeaderSize +
+                                               sizeof(pldm_msg_hdr) +
+                                               PLDM_GET_TYPES_RESP_BYTES));
+        EXPECT_EQ(response[0], 8 + i);
+        auto msg = reinterpret_cast<const pldm_msg*>(
+            response.data() + transport::frameHeaderSize);
+        EXPECT_EQ(msg->hdr.instance_id, i);
+        EXPECT_EQ(msg->payload[0], PLDM_SUCCESS);
+    }
+
+    close(clients[0]);
+    loop.runOnce(1000);
+    EXPECT_EQ(server.connections(), 1u);
+    close(clients[1]);
+}
+
+TEST(Transport, ServeBatches)
+{
+    auto name = socketName() + ".batch";
+    int listenFd = transport::listenSocket(name);
+    ASSERT_GE(listenFd, 0);
+
+    EventLoop loop;
+    transport::Server server(loop, listenFd, 4);
+    int fd = transport::connectSocket(name);
+    ASSERT_GE(fd, 0);
+    loop.runOnce(1000);
+
+    // More requests than a batch, and a frame that is not answered
+    constexpr size_t count = 10;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto frame = getTypesFrame(9, i);
+        if (i == 5)
+        {
+            frame[1] = 0x7E;
+        }
+        ASSERT_EQ(send(fd, frame.data(), frame.size(), 0),
+                  static_cast<ssize_t>(frame.size()));
+    }
+    loop.runOnce(1000);
+
+    std::vector<uint8_t> response(transport::maxFrameSize);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (i == 5)
+        {
+            continue;
+        }
+        auto length =
+            recv(fd, response.data(), response.size(), MSG_DONTWAIT);
+        ASSERT_EQ(length, static_cast<ssize_t>(transport::frameHeaderSize +
+                                               sizeof(pldm_msg_hdr) +
+                                               PLDM_GET_TYPES_RESP_BYTES));
+        auto msg = reinterpret_cast<const pldm_msg*>(
+            response.data() + transport::frameHeaderSize);
+        EXPECT_EQ(msg->hdr.instance_id, i);
+    }
+    EXPECT_LT(recv(fd, response.data(), response.size(), MSG_DONTWAIT), 0);
+
+    // Requests sent before the requester hangs up are handled, and the
+    // connection is dropped
+    auto frame = getTypesFrame(9, 1);
+    ASSERT_EQ(send(fd, frame.data(), frame.size(), 0),
+              static_cast<ssize_t>(frame.size()));
+    shutdown(fd, SHUT_WR);
+    loop.runOnce(1000);
+    EXPECT_GT(recv(fd, response.data(), response.size(), MSG_DONTWAIT), 0);
+    EXPECT_EQ(server.connections(), 0u);
+    close(fd);
+}
+
+TEST(Transport, FileCommandsAndMTU)
+{
+    auto name = socketName() + ".file";
+    int listenFd = transport::listenSocket(name);
+    ASSERT_GE(listenFd, 0);
+
+    constexpr size_t mtu = 64;
+    EventLoop loop;
+    transport::Server server(loop, listenFd, 1, mtu);
+    int fd = transport::connectSocket(name);
+    ASSERT_GE(fd, 0);
+    loop.runOnce(1000);
+
+    // A frame larger than the MTU is dropped
+    std::vector<uint8_t> large(mtu + 1, 0);
+    large[1] = transport::mctpTypePldm;
+    ASSERT_EQ(send(fd, large.data(), large.size(), 0),
+              static_cast<ssize_t>(large.size()));
+
+    // A ReadFile is handled off the loop and answered on it, here with an
+    // error since the file table is empty
+    std::vector<uint8_t> frame{9, transport::mctpTypePldm};
+    frame.resize(transport::frameHeaderSize + sizeof(pldm_msg_hdr) +
+                 PLDM_READ_FILE_REQ_BYTES);
+    encode_read_file_req(
+        7, 0, 0, 16,
+        reinterpret_cast<pldm_msg*>(frame.data() +
+                                    transport::frameHeaderSize));
+    ASSERT_EQ(send(fd, frame.data(), frame.size(), 0),
+              static_cast<ssize_t>(frame.size()));
+
+    std::vector<uint8_t> response(transport::maxFrameSize);
+    ssize_t length = -1;
+    for (int i = 0; i < 100 && length < 0; ++i)
+    {
+        loop.runOnce(10);
+        length = recv(fd, response.data(), response.size(), MSG_DONTWAIT);
+    }
+    ASSERT_GT(length, static_cast<ssize_t>(transport::frameHeaderSize +
+                                           sizeof(pldm_msg_hdr)));
+    EXPECT_EQ(response[0], 9);
+    auto msg = reinterpret_cast<const pldm_msg*>(response.data() +
+                                                 transport::frameHeaderSize);
+    EXPECT_EQ(msg->hdr.instance_id, 7);
+    EXPECT_EQ(msg->hdr.command, PLDM_READ_FILE);
+    EXPECT_NE(msg->payload[0], PLDM_SUCCESS);
+    EXPECT_LT(recv(fd, response.data(), response.size(), MSG_DONTWAIT), 0);
+    close(fd);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdlib.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace pldm
+{
+
+namespace test
+{
+
+/** @class TempFile
+ *
+ *  Fixture that creates an empty temporary file before each test and
+ *  removes it after, for the tests of the caches that are kept per file.
+ *  A test that replaces or removes the file closes fd and sets it to -1.
+ */
+class TempFile : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char name[] = "/tmp/pldm_test_XXXXXX";
+        fd = mkstemp(name);
+        ASSERT_GE(fd, 0);
+        path = name;
+    }
+
+    void TearDown() override
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        std::filesystem::remove(path);
+    }
+
+    /** @brief Write all of a buffer to the file
+     *
+     * @param[in] offset - offset in the file
+     * @param[in] data - bytes to write
+     * @param[in] length - number of bytes to write
+     */
+    void writeAt(off_t offset, const void* data, size_t length)
+    {
+        ASSERT_EQ(pwrite(fd, data, length, offset),
+                  static_cast<ssize_t>(length));
+    }
+
+    /** @brief Write a range of the file with one byte value
+     *
+     * @param[in] offset - offset in the file
+     * @param[in] length - number of bytes to write
+     * @param[in] value - value of the bytes
+     */
+    void fill(off_t offset, size_t length, char value)
+    {
+        std::vector<char> data(length, value);
+        writeAt(offset, data.data(), length);
+    }
+
+    int fd = -1;
+    std::filesystem::path path;
+};
+
+} // namespace test
+} // namespace pldm
@@ -0,0 +1,90 @@
+/** @file metrics_bench.cpp
+ *
+ *  Measures the overhead that the metrics add to each request: a timer and a
+ *  histogram update per command, from one and from several threads, next to
+ *  the cost of dispatching the cheapest command.
+ *
+ *  Usage: metrics_bench [iterations]
+ */
+
+#include "libpldmresponder/dispatch.hpp"
+#include "libpldmresponder/metrics.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "libpldm/base.h"
+
+using namespace pldm::responder;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+double nsPerOp(Clock::duration elapsed, size_t ops)
+{
+    return std::chrono::duration<double, std::nano>(elapsed).count() / ops;
+}
+
+double recordCost(size_t iterations, size_t threads)
+{
+    std::vector<std::thread> workers;
+    auto start = Clock::now();
+    for (size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([iterations, t] {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                metrics::Timer timer;
+                metrics::recordCommand(PLDM_IBM_OEM_TYPE, 6 + (t & 1),
+                                       PLDM_SUCCESS, timer.elapsed());
+            }
+        });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    return nsPerOp(Clock::now() - start, iterations);
+}
+
+double dispatchCost(size_t iterations)
+{
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    encode_get_types_req(0, reinterpret_cast<pldm_msg*>(requestMsg.data()));
+    auto request = reinterpret_cast<const pldm_msg*>(requestMsg.data());
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        dispatch::handle(request, requestMsg.size());
+    }
+    return nsPerOp(Clock::now() - start, iterations);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t iterations = (argc > 1) ? strtoul(argv[1], nullptr, 0) : 10000000;
+    size_t threads = std::max(2u, std::thread::hardware_concurrency());
+
+    auto single = recordCost(iterations, 1);
+    auto contended = recordCost(iterations, threads);
+    metrics::reset();
+    auto handled = dispatchCost(iterations);
+
+    printf("timer + histogram update, 1 thread:    %8.1f ns\n", single);
+    printf("timer + histogram update, %zu threads: %8.1f ns\n", threads,
+           contended);
+    printf("GetPLDMTypes through dispatch:         %8.1f ns\n", handled);
+
+    // A DMA chunk of 16 MB takes milliseconds, the metrics are a fixed cost
+    // per request and per chunk
+    printf("overhead for a 1 ms request:           %8.4f %%\n",
+           contended / 1e6 * 100);
+    return 0;
+}
@@ -0,0 +1,560 @@
+/** @file pldm_loadgen.cpp
+ *
+ *  Load generator: sends a mix of File I/O requests, built with the libpldm
+ *  encoders, to a responder over a socket that stands in for the MCTP demux
+ *  daemon, keeping a number of requests outstanding. Reports the throughput,
+ *  the p50, p99 and p99.9 latencies and the error rate of each command.
+ *
+ *  The files and their sizes are read from the file table of the responder.
+ *  Writes modify the files, so run the responder on a copy of the file tree,
+ *  see pldm_responder -r.
+ *
+ *  Usage: pldm_loadgen [-n requests] [-c outstanding] [-m mix] [-z sizes]
+ *                      [-f handles] [-e eid] [-t timeout] socket
+ *    -n requests     number of requests to send (10000)
+ *    -c outstanding  requests in flight, at most 32 (8)
+ *    -m mix          commands and their weights, of table, read, write,
+ *                    readmem and writemem (read=8,write=1,table=1)
+ *    -z sizes        transfer sizes and their weights (4096)
+ *    -f handles      file handles to access (all files)
+ *    -e eid          endpoint id of the requester (9)
+ *    -t timeout      time to wait for a response in ms (1000)
+ */
+
+#include "libpldmresponder/metrics.hpp"
+#include "libpldmresponder/transport.hpp"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "libpldm/base.h"
+#include "libpldm/file_io.h"
+
+using namespace pldm::responder;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+// Instance ids are 5 bits, so at most 32 requests are outstanding
+constexpr size_t maxOutstanding = 32;
+
+enum Command
+{
+    GetTable,
+    Read,
+    Write,
+    ReadMemory,
+    WriteMemory,
+    CommandCount
+};
+
+constexpr std::array<const char*, CommandCount> commandNames = {
+    "table", "read", "write", "readmem", "writemem"};
+
+struct File
+{
+    uint32_t handle;
+    uint32_t size;
+};
+
+struct Stats
+{
+    metrics::Histogram latency;
+    uint64_t sent = 0;
+    uint64_t errors = 0;
+    uint64_t timeouts = 0;
+    uint64_t bytes = 0;
+};
+
+struct Pending
+{
+    bool active = false;
+    Command command = GetTable;
+    uint32_t length = 0;
+    Clock::time_point sent;
+};
+
+/** @brief Parse a comma separated list of name or number, with an optional
+ *         weight after '=' or ':'
+ */
+std::vector<std::pair<std::string, uint32_t>> parseList(const std::string& list)
+{
+    std::vector<std::pair<std::string, uint32_t>> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        auto separator = item.find_first_of("=:");
+        uint32_t weight = 1;
+        if (separator != std::string::npos)
+        {
+            weight = strtoul(item.c_str() + separator + 1, nullptr, 0);
+            item.resize(separator);
+        }
+        items.emplace_back(item, weight);
+    }
+    return items;
+}
+
+/** @brief Send a frame and wait for the response to it */
+std::vector<uint8_t> transact(int fd, uint8_t eid,
+                              const std::vector<uint8_t>& request)
+{
+    std::vector<uint8_t> frame{eid, transport::mctpTypePldm};
+    frame.insert(frame.end(), request.begin(), request.end());
+    if (send(fd, frame.data(), frame.size(), MSG_NOSIGNAL) < 0)
+    {
+        return {};
+    }
+
+    std::vector<uint8_t> response(transport::maxFrameSize);
+    pollfd pfd{fd, POLLIN, 0};
+    if (poll(&pfd, 1, 5000) <= 0)
+    {
+        return {};
+    }
+    auto length = recv(fd, response.data(), response.size(), 0);
+    if (length <= static_cast<ssize_t>(transport::frameHeaderSize))
+    {
+        return {};
+    }
+    return std::vector<uint8_t>(response.begin() + transport::frameHeaderSize,
+                                response.begin() + length);
+}
+
+/** @brief Read the files and their sizes from the file table */
+std::vector<File> readFileTable(int fd, uint8_t eid)
+{
+    std::vector<uint8_t> request(sizeof(pldm_msg_hdr) +
+                                 PLDM_GET_FILE_TABLE_REQ_BYTES);
+    encode_get_file_table_req(0, 0, PLDM_GET_FIRSTPART,
+                              PLDM_FILE_ATTRIBUTE_TABLE,
+                              reinterpret_cast<pldm_msg*>(request.data()));
+    auto response = transact(fd, eid, request);
+    if (response.size() <= sizeof(pldm_msg_hdr))
+    {
+        return {};
+    }
+
+    uint8_t completionCode = 0;
+    uint32_t nextHandle = 0;
+    uint8_t transferFlag = 0;
+    size_t offset = 0;
+    size_t length = 0;
+    auto payload = response.data() + sizeof(pldm_msg_hdr);
+    if (decode_get_file_table_resp(payload,
+                                   response.size() - sizeof(pldm_msg_hdr),
+                                   &completionCode, &nextHandle, &transferFlag,
+                                   &offset, &length) != PLDM_SUCCESS ||
+        completionCode != PLDM_SUCCESS)
+    {
+        return {};
+    }
+
+    // Each entry is the handle, the length of the name, the name, the size
+    // and the traits. The entries are followed by up to 3 pad bytes and the
+    // checksum, shorter than an entry.
+    constexpr size_t minEntrySize = 14;
+    auto table = payload + offset;
+    std::vector<File> files;
+    size_t position = 0;
+    while (length - position >= minEntrySize)
+    {
+        uint32_t handle = 0;
+        uint16_t nameLength = 0;
+        uint32_t size = 0;
+        memcpy(&handle, table + position, sizeof(handle));
+        memcpy(&nameLength, table + position + 4, sizeof(nameLength));
+        nameLength = le16toh(nameLength);
+        if (position + minEntrySize + nameLength > length)
+        {
+            break;
+        }
+        memcpy(&size, table + position + 6 + nameLength, sizeof(size));
+        files.push_back({le32toh(handle), le32toh(size)});
+        position += minEntrySize + nameLength;
+    }
+    return files;
+}
+
+class LoadGenerator
+{
+  public:
+    LoadGenerator(int fd, uint8_t eid, std::vector<File> files,
+                  std::vector<std::pair<Command, uint32_t>> mix,
+                  std::vector<std::pair<uint32_t, uint32_t>> sizes) :
+        fd(fd),
+        eid(eid), files(std::move(files)), mix(std::move(mix)),
+        sizes(std::move(sizes))
+    {
+        std::vector<uint32_t> weights;
+        for (const auto& [command, weight] : this->mix)
+        {
+            weights.push_back(weight);
+        }
+        pickCommand = std::discrete_distribution<size_t>(weights.begin(),
+                                                         weights.end());
+        weights.clear();
+        for (const auto& [size, weight] : this->sizes)
+        {
+            weights.push_back(weight);
+        }
+        pickSize = std::discrete_distribution<size_t>(weights.begin(),
+                                                      weights.end());
+    }
+
+    /** @brief Send requests, keeping outstanding in flight, until count have
+     *         completed or timed out
+     */
+    void run(size_t count, size_t outstanding,
+             std::chrono::milliseconds timeout)
+    {
+        std::vector<uint8_t> frame(transport::maxFrameSize);
+        size_t sent = 0;
+        size_t completed = 0;
+        size_t inFlight = 0;
+        uint8_t nextInstance = 0;
+
+        while (completed < count)
+        {
+            while (sent < count && inFlight < outstanding)
+            {
+                while (pending[nextInstance].active)
+                {
+                    nextInstance = (nextInstance + 1) % maxOutstanding;
+                }
+                if (!send(nextInstance))
+                {
+                    ++completed;
+                }
+                else
+                {
+                    ++inFlight;
+                }
+                ++sent;
+                nextInstance = (nextInstance + 1) % maxOutstanding;
+            }
+
+            pollfd pfd{fd, POLLIN, 0};
+            poll(&pfd, 1, 10);
+            ssize_t length = 0;
+            while ((length = recv(fd, frame.data(), frame.size(),
+                                  MSG_DONTWAIT)) > 0)
+            {
+                if (receive(frame.data(), length))
+                {
+                    --inFlight;
+                    ++completed;
+                }
+            }
+
+            auto now = Clock::now();
+            for (auto& request : pending)
+            {
+                if (request.active && now - request.sent > timeout)
+                {
+                    request.active = false;
+                    stats[request.command].timeouts++;
+                    --inFlight;
+                    ++completed;
+                }
+            }
+        }
+    }
+
+    /** @brief Print the statistics of each command */
+    void report(std::chrono::duration<double> elapsed) const
+    {
+        uint64_t total = 0;
+        uint64_t bytes = 0;
+        for (const auto& command : stats)
+        {
+            total += command.sent;
+            bytes += command.bytes;
+        }
+        printf("requests=%llu seconds=%.3f requests_per_second=%.0f "
+               "mb_per_second=%.1f\n",
+               static_cast<unsigned long long>(total), elapsed.count(),
+               total / elapsed.count(), bytes / elapsed.count() / 1e6);
+
+        for (size_t i = 0; i < CommandCount; ++i)
+        {
+            const auto& command = stats[i];
+            if (!command.sent)
+            {
+                continue;
+            }
+            printf("%s sent=%llu errors=%llu timeouts=%llu error_rate=%.3f%% "
+                   "p50_us=%.1f p99_us=%.1f p999_us=%.1f\n",
+                   commandNames[i],
+                   static_cast<unsigned long long>(command.sent),
+                   static_cast<unsigned long long>(command.errors),
+                   static_cast<unsigned long long>(command.timeouts),
+                   100.0 * (command.errors + command.timeouts) / command.sent,
+                   command.latency.percentile(50) / 1e3,
+                   command.latency.percentile(99) / 1e3,
+                   command.latency.percentile(99.9) / 1e3);
+        }
+    }
+
+  private:
+    /** @brief Build and send a request
+     *
+     * @return bool - true if the request was sent
+     */
+    bool send(uint8_t instance)
+    {
+        auto command = mix[pickCommand(random)].first;
+        const auto& file =
+            files[std::uniform_int_distribution<size_t>(0, files.size() - 1)(
+                random)];
+        uint32_t length = sizes[pickSize(random)].first;
+        length = std::min(length, file.size);
+        if (command == ReadMemory || command == WriteMemory)
+        {
+            // DMA transfers are whole multiples of 16 bytes
+            length &= ~15u;
+        }
+        uint32_t offset = 0;
+        if (file.size > length)
+        {
+            offset = std::uniform_int_distribution<uint32_t>(
+                0, (file.size - length) / 16)(random) * 16;
+        }
+
+        std::vector<uint8_t> frame{eid, transport::mctpTypePldm};
+        size_t payloadLength = 0;
+        switch (command)
+        {
+            case GetTable:
+                payloadLength = PLDM_GET_FILE_TABLE_REQ_BYTES;
+                break;
+            case Read:
+                payloadLength = PLDM_READ_FILE_REQ_BYTES;
+                break;
+            case Write:
+                payloadLength = PLDM_WRITE_FILE_REQ_BYTES + length;
+                break;
+            default:
+                payloadLength = PLDM_RW_FILE_MEM_REQ_BYTES;
+                break;
+        }
+        frame.resize(frame.size() + sizeof(pldm_msg_hdr) + payloadLength,
+                     0x5A);
+        auto request = reinterpret_cast<pldm_msg*>(
+            frame.data() + transport::frameHeaderSize);
+
+        switch (command)
+        {
+            case GetTable:
+                encode_get_file_table_req(instance, 0, PLDM_GET_FIRSTPART,
+                                          PLDM_FILE_ATTRIBUTE_TABLE, request);
+                break;
+            case Read:
+                encode_read_file_req(instance, file.handle, offset, length,
+                                     request);
+                break;
+            case Write:
+                encode_write_file_req(instance, file.handle, offset, length,
+                                      request);
+                break;
+            case ReadMemory:
+                encode_rw_file_memory_req(instance, PLDM_READ_FILE_INTO_MEMORY,
+                                          file.handle, offset, length, 0,
+                                          request);
+                break;
+            case WriteMemory:
+                encode_rw_file_memory_req(
+                    instance, PLDM_WRITE_FILE_FROM_MEMORY, file.handle, offset,
+                    length, 0, request);
+                break;
+            default:
+                break;
+        }
+
+        auto& stat = stats[command];
+        stat.sent++;
+        if (::send(fd, frame.data(), frame.size(), MSG_NOSIGNAL) < 0)
+        {
+            stat.errors++;
+            return false;
+        }
+        pending[instance] = {true, command, length, Clock::now()};
+        return true;
+    }
+
+    /** @brief Account a response
+     *
+     * @return bool - true if it completed an outstanding request
+     */
+    bool receive(const uint8_t* frame, size_t length)
+    {
+        if (length <= transport::frameHeaderSize + sizeof(pldm_msg_hdr))
+        {
+            return false;
+        }
+        auto response = reinterpret_cast<const pldm_msg*>(
+            frame + transport::frameHeaderSize);
+        auto& request = pending[response->hdr.instance_id];
+        if (!request.active)
+        {
+            return false;
+        }
+        request.active = false;
+
+        auto& stat = stats[request.command];
+        stat.latency.record(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - request.sent)
+                .count());
+        if (response->payload[0] != PLDM_SUCCESS)
+        {
+            stat.errors++;
+        }
+        else
+        {
+            stat.bytes += request.length;
+        }
+        return true;
+    }
+
+    int fd;
+    uint8_t eid;
+    std::vector<File> files;
+    std::vector<std::pair<Command, uint32_t>> mix;
+    std::vector<std::pair<uint32_t, uint32_t>> sizes;
+    std::discrete_distribution<size_t> pickCommand;
+    std::discrete_distribution<size_t> pickSize;
+    std::mt19937 random{1};
+    std::array<Pending, maxOutstanding> pending{};
+    std::array<Stats, CommandCount> stats{};
+};
+
+void usage(const char* name)
+{
+    fprintf(stderr,
+            "Usage: %s [-n requests] [-c outstanding] [-m mix] [-z sizes] "
+            "[-f handles] [-e eid] [-t timeout] socket\n",
+            name);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t count = 10000;
+    size_t outstanding = 8;
+    std::string mixList = "read=8,write=1,table=1";
+    std::string sizeList = "4096";
+    std::string handleList;
+    uint8_t eid = 9;
+    std::chrono::milliseconds timeout(1000);
+
+    int opt = 0;
+    while ((opt = getopt(argc, argv, "n:c:m:z:f:e:t:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                count = strtoul(optarg, nullptr, 0);
+                break;
+            case 'c':
+                outstanding = strtoul(optarg, nullptr, 0);
+                break;
+            case 'm':
+                mixList = optarg;
+                break;
+            case 'z':
+                sizeList = optarg;
+                break;
+            case 'f':
+                handleList = optarg;
+                break;
+            case 'e':
+                eid = strtoul(optarg, nullptr, 0);
+                break;
+            case 't':
+                timeout =
+                    std::chrono::milliseconds(strtoul(optarg, nullptr, 0));
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (argc - optind != 1 || !outstanding || outstanding > maxOutstanding)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::pair<Command, uint32_t>> mix;
+    for (const auto& [name, weight] : parseList(mixList))
+    {
+        auto iter = std::find(commandNames.begin(), commandNames.end(), name);
+        if (iter == commandNames.end())
+        {
+            fprintf(stderr, "Unknown command %s\n", name.c_str());
+            return EXIT_FAILURE;
+        }
+        mix.emplace_back(static_cast<Command>(iter - commandNames.begin()),
+                         weight);
+    }
+    std::vector<std::pair<uint32_t, uint32_t>> sizes;
+    for (const auto& [size, weight] : parseList(sizeList))
+    {
+        sizes.emplace_back(strtoul(size.c_str(), nullptr, 0), weight);
+    }
+
+    int fd = transport::connectSocket(argv[optind]);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Failed to connect to %s: %s\n", argv[optind],
+                strerror(-fd));
+        return EXIT_FAILURE;
+    }
+
+    auto files = readFileTable(fd, eid);
+    if (!handleList.empty())
+    {
+        std::vector<File> selected;
+        for (const auto& [handle, weight] : parseList(handleList))
+        {
+            auto value = strtoul(handle.c_str(), nullptr, 0);
+            for (const auto& file : files)
+            {
+                if (file.handle == value)
+                {
+                    selected.push_back(file);
+                }
+            }
+        }
+        files = std::move(selected);
+    }
+    if (files.empty())
+    {
+        fprintf(stderr, "No files to access\n");
+        return EXIT_FAILURE;
+    }
+
+    LoadGenerator generator(fd, eid, std::move(files), std::move(mix),
+                            std::move(sizes));
+    auto start = Clock::now();
+    generator.run(count, outstanding, timeout);
+    generator.report(Clock::now() - start);
+    close(fd);
+    return EXIT_SUCCESS;
+}
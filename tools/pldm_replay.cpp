@@ -0,0 +1,149 @@
+/** @file pldm_replay.cpp
+ *
+ *  Replays a capture of the requests received by the responder into the
+ *  handlers, as fast as possible or at the pacing of the capture, and reports
+ *  the throughput and the latency distribution of each command.
+ *
+ *  DMA transfers are emulated: reads from files go to a buffer standing in
+ *  for host memory, and writes to files take their data from it. The files
+ *  come from the file table config; with -r each pathname in it is taken
+ *  relative to a copy of the BMC file tree, without it the files are copied
+ *  to a temporary directory for the replay. Either way the replay does not
+ *  modify the original files, and writes outside the copy fail.
+ *
+ *  Usage: pldm_replay [-p] [-r root] capture config
+ *    -p       replay at the pacing of the capture, through the replay cache
+ *    -r root  directory the pathnames of the file table config are under
+ */
+
+#include "libpldmresponder/capture.hpp"
+#include "libpldmresponder/dispatch.hpp"
+#include "libpldmresponder/file_table.hpp"
+#include "libpldmresponder/metrics.hpp"
+#include "sandbox.hpp"
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace pldm::responder;
+using namespace pldm::tools;
+using Clock = std::chrono::steady_clock;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+void usage(const char* name)
+{
+    fprintf(stderr, "Usage: %s [-p] [-r root] capture config\n", name);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    bool paced = false;
+    fs::path root;
+    int opt = 0;
+    while ((opt = getopt(argc, argv, "pr:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'p':
+                paced = true;
+                break;
+            case 'r':
+                root = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (argc - optind != 2)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    CaptureReader reader;
+    if (!reader.open(argv[optind]))
+    {
+        fprintf(stderr, "%s is not a capture file\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    // Without a copy of the BMC file tree the files of the table are copied,
+    // so that the original files are never written
+    CopiedFiles copied(root.empty() ? copyFiles(argv[optind + 1])
+                                    : fs::path{});
+    if (root.empty())
+    {
+        if (copied.path().empty())
+        {
+            fprintf(stderr, "Failed to copy the files of %s\n",
+                    argv[optind + 1]);
+            return EXIT_FAILURE;
+        }
+        root = copied.path();
+    }
+
+    fs::path config = sandboxConfig(argv[optind + 1], root);
+    if (config.empty())
+    {
+        fprintf(stderr, "Failed to rebase %s under %s\n", argv[optind + 1],
+                root.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // The handlers use the table built first
+    auto& table = pldm::filetable::buildFileTable(config);
+    fs::remove(config);
+    if (table.isEmpty())
+    {
+        fprintf(stderr, "No files in the file table\n");
+        return EXIT_FAILURE;
+    }
+
+    emulateDMA(root);
+    metrics::reset();
+
+    size_t requests = 0;
+    size_t unanswered = 0;
+    CaptureRecord record;
+    auto start = Clock::now();
+    while (reader.next(record))
+    {
+        if (paced)
+        {
+            std::this_thread::sleep_until(
+                start + std::chrono::nanoseconds(record.time));
+        }
+
+        // Without the pacing the instance ids of a capture are reused within
+        // the expiration interval, so the replay cache is only used when
+        // paced
+        auto request = reinterpret_cast<const pldm_msg*>(record.message.data());
+        auto response =
+            paced ? dispatch::handle(record.eid, request, record.message.size())
+                  : dispatch::handle(request, record.message.size());
+        ++requests;
+        if (!response.second)
+        {
+            ++unanswered;
+        }
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    printf("requests=%zu unanswered=%zu seconds=%.3f "
+           "requests_per_second=%.0f\n",
+           requests, unanswered, elapsed.count(),
+           elapsed.count() ? requests / elapsed.count() : 0);
+    printf("%s", metrics::dump().c_str());
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,230 @@
+/** @file pldm_responder.cpp
+ *
+ *  Stand-in responder: serves the handlers on a socket that stands in for
+ *  the MCTP demux daemon, for load tests of the responder off the BMC.
+ *
+ *  DMA transfers are emulated unless -d is given. With -r each pathname in
+ *  the file table config is taken relative to a copy of the BMC file tree,
+ *  without it the files are copied to a temporary directory that is removed
+ *  at exit. Either way writes do not modify the original files, and
+ *  emulated writes outside the copy fail.
+ *
+ *  Usage: pldm_responder [-b batch] [-c capture] [-d] [-m mtu] [-r root]
+ *                        [-s metrics] socket config
+ *    -b batch    requests received per system call (1)
+ *    -c capture  file the requests received are recorded to, for
+ *                pldm_replay
+ *    -m mtu      largest frame received, as negotiated with the requesters
+ *                (65536)
+ *    -d          transfer through the XDMA device
+ *    -r root     directory the pathnames of the file table config are under
+ *    -s metrics  socket the metrics are served on, followed by the
+ *                accounting of the busiest files
+ */
+
+#include "libpldmresponder/capture.hpp"
+#include "libpldmresponder/change_tracker.hpp"
+#include "libpldmresponder/event_loop.hpp"
+#include "libpldmresponder/file_sizes.hpp"
+#include "libpldmresponder/file_stats.hpp"
+#include "libpldmresponder/file_table.hpp"
+#include "libpldmresponder/logging.hpp"
+#include "libpldmresponder/metrics.hpp"
+#include "libpldmresponder/transport.hpp"
+#include "sandbox.hpp"
+
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+
+using namespace pldm::responder;
+using namespace pldm::tools;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+// How often the counts of suppressed log messages are reported, and the
+// recorded requests are flushed to the capture file
+constexpr std::chrono::seconds logFlushInterval(10);
+
+// Number of files in the file accounting section of the metrics
+constexpr size_t topFiles = 10;
+
+void usage(const char* name)
+{
+    fprintf(stderr,
+            "Usage: %s [-b batch] [-c capture] [-d] [-m mtu] [-r root] "
+            "[-s metrics] socket config\n",
+            name);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t batch = 1;
+    size_t mtu = transport::maxFrameSize;
+    bool device = false;
+    fs::path root;
+    std::string metricsPath;
+    fs::path capturePath;
+    int opt = 0;
+    while ((opt = getopt(argc, argv, "b:c:dm:r:s:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'b':
+                batch = strtoul(optarg, nullptr, 0);
+                break;
+            case 'c':
+                capturePath = optarg;
+                break;
+            case 'd':
+                device = true;
+                break;
+            case 'm':
+                mtu = strtoul(optarg, nullptr, 0);
+                break;
+            case 'r':
+                root = optarg;
+                break;
+            case 's':
+                metricsPath = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (argc - optind != 2)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Without a copy of the BMC file tree the files of the table are copied,
+    // so that the original files are never written
+    CopiedFiles copied(root.empty() ? copyFiles(argv[optind + 1])
+                                    : fs::path{});
+    if (root.empty())
+    {
+        if (copied.path().empty())
+        {
+            fprintf(stderr, "Failed to copy the files of %s\n",
+                    argv[optind + 1]);
+            return EXIT_FAILURE;
+        }
+        root = copied.path();
+    }
+
+    fs::path config = sandboxConfig(argv[optind + 1], root);
+    if (config.empty())
+    {
+        fprintf(stderr, "Failed to rebase %s under %s\n", argv[optind + 1],
+                root.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // The handlers use the table built first
+    auto& table = pldm::filetable::buildFileTable(config);
+    fs::remove(config);
+    if (table.isEmpty())
+    {
+        fprintf(stderr, "No files in the file table\n");
+        return EXIT_FAILURE;
+    }
+    if (!device)
+    {
+        emulateDMA(root);
+    }
+
+    EventLoop loop;
+    int fd = transport::listenSocket(argv[optind]);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Failed to listen on %s: %s\n", argv[optind],
+                strerror(-fd));
+        return EXIT_FAILURE;
+    }
+    transport::Server server(loop, fd, batch, mtu);
+
+    if (!metricsPath.empty())
+    {
+        metrics::addSection([&table] {
+            std::shared_lock<std::shared_mutex> lock(
+                pldm::filetable::fileTableMutex());
+            return pldm::filetable::fileAccounting().report(topFiles, &table);
+        });
+        auto rc = metrics::serve(loop, metricsPath);
+        if (rc < 0)
+        {
+            fprintf(stderr, "Failed to serve the metrics on %s: %s\n",
+                    metricsPath.c_str(), strerror(-rc));
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!capturePath.empty() && !captureWriter().open(capturePath))
+    {
+        fprintf(stderr, "Failed to open the capture file %s\n",
+                capturePath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // Pick up changes to the files by local writers for GetChangedBlocks
+    auto rc = pldm::filetable::changeTracker().watch(loop);
+    if (rc < 0)
+    {
+        fprintf(stderr, "Failed to watch the files for changes: %s\n",
+                strerror(-rc));
+        return EXIT_FAILURE;
+    }
+
+    // Keep the sizes of followed logs current for FollowFile
+    rc = pldm::filetable::fileSizes().watch(loop);
+    if (rc < 0)
+    {
+        fprintf(stderr, "Failed to watch the files for growth: %s\n",
+                strerror(-rc));
+        return EXIT_FAILURE;
+    }
+
+    // Stop on SIGINT and SIGTERM, so that the sockets are closed
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &signals, nullptr);
+    int signalFd = signalfd(-1, &signals, SFD_CLOEXEC);
+    if (signalFd < 0 ||
+        loop.addIO(signalFd, EPOLLIN, [&loop](uint32_t) { loop.stop(); }) < 0)
+    {
+        fprintf(stderr, "Failed to watch for signals\n");
+        return EXIT_FAILURE;
+    }
+
+    // Report the messages suppressed at the end of a storm of log messages,
+    // and keep the capture file current in case the responder is killed
+    std::function<void()> flushLogs = [&loop, &flushLogs] {
+        logging::flushSuppressed();
+        captureWriter().flush();
+        loop.postAfter(logFlushInterval, flushLogs);
+    };
+    loop.postAfter(logFlushInterval, flushLogs);
+
+    loop.run();
+    close(signalFd);
+    logging::flushSuppressed();
+    captureWriter().close();
+    return EXIT_SUCCESS;
+}
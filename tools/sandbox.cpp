@@ -0,0 +1,152 @@
+#include "sandbox.hpp"
+
+#include "libpldmresponder/block_hashes.hpp"
+#include "libpldmresponder/file_io.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+namespace pldm
+{
+
+namespace tools
+{
+
+using namespace pldm::responder;
+
+namespace
+{
+
+/** @brief directory the files of the sandbox are under, canonical */
+fs::path sandboxRoot;
+
+/** @brief Check if a file is in the sandbox, following symbolic links */
+bool inSandbox(const fs::path& path)
+{
+    std::error_code ec;
+    auto canonical = fs::weakly_canonical(path, ec);
+    if (ec)
+    {
+        return false;
+    }
+    auto [rootEnd, pathEnd] = std::mismatch(
+        sandboxRoot.begin(), sandboxRoot.end(), canonical.begin(),
+        canonical.end());
+    return rootEnd == sandboxRoot.end() && pathEnd != canonical.end();
+}
+
+int emulateTransfer(const fs::path& path, uint32_t offset, uint32_t length,
+                    uint64_t /*address*/, bool upstream)
+{
+    static std::vector<uint8_t> hostMemory(dma::maxSize);
+
+    if (!upstream && !inSandbox(path))
+    {
+        return -EACCES;
+    }
+
+    int fd = open(path.c_str(), upstream ? O_RDONLY : O_RDWR);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+    utils::CustomFD file(fd);
+
+    if (!upstream)
+    {
+        auto skipped =
+            writeChanged(file(), path, offset, length,
+                         reinterpret_cast<const char*>(hostMemory.data()));
+        if (skipped < 0)
+        {
+            return skipped;
+        }
+        metrics::recordDedup(length - skipped, skipped);
+        return 0;
+    }
+
+    auto rc = pread(file(), hostMemory.data(), length, offset);
+    if (rc < 0)
+    {
+        return -errno;
+    }
+    return (static_cast<uint32_t>(rc) == length) ? 0 : -EIO;
+}
+
+} // namespace
+
+fs::path sandboxConfig(const fs::path& config, const fs::path& root)
+{
+    std::ifstream input(config);
+    auto entries = nlohmann::json::parse(input, nullptr, false);
+    if (entries.is_discarded() || !entries.is_array())
+    {
+        return {};
+    }
+
+    for (auto& entry : entries)
+    {
+        fs::path path = entry.value("path", "");
+        entry["path"] = (root / path.relative_path()).string();
+    }
+
+    auto copy = fs::temp_directory_path() /
+                ("pldm_sandbox." + std::to_string(getpid()) + ".json");
+    std::ofstream output(copy);
+    output << entries;
+    return output ? copy : fs::path{};
+}
+
+fs::path copyFiles(const fs::path& config)
+{
+    std::ifstream input(config);
+    auto entries = nlohmann::json::parse(input, nullptr, false);
+    if (entries.is_discarded() || !entries.is_array())
+    {
+        return {};
+    }
+
+    auto dir = (fs::temp_directory_path() / "pldm_sandbox.XXXXXX").string();
+    if (!mkdtemp(dir.data()))
+    {
+        return {};
+    }
+
+    // Files that do not exist are left out of the copy, as they are left out
+    // of the file table
+    for (const auto& entry : entries)
+    {
+        fs::path path = entry.value("path", "");
+        std::error_code ec;
+        if (path.empty() || !fs::is_regular_file(path, ec))
+        {
+            continue;
+        }
+        auto copy = dir / path.relative_path();
+        fs::create_directories(copy.parent_path(), ec);
+        if (!fs::copy_file(path, copy, fs::copy_options::overwrite_existing,
+                           ec))
+        {
+            fs::remove_all(dir, ec);
+            return {};
+        }
+    }
+    return dir;
+}
+
+void emulateDMA(const fs::path& root)
+{
+    sandboxRoot = fs::weakly_canonical(root);
+    dma::DMA::emulate(emulateTransfer);
+}
+
+} // namespace tools
+} // namespace pldm
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+namespace pldm
+{
+
+namespace tools
+{
+
+namespace fs = std::filesystem;
+
+/** @brief Write a copy of a file table config with the pathnames taken
+ *         relative to a root directory, so that tools work on a copy of the
+ *         BMC file tree
+ *
+ *  @param[in] config - file table config
+ *  @param[in] root - directory the pathnames are under
+ *
+ *  @return pathname of the copy, or an empty path on failure. The caller
+ *          removes the copy.
+ */
+fs::path sandboxConfig(const fs::path& config, const fs::path& root);
+
+/** @brief Copy the files of a file table config into a new temporary
+ *         directory, each under its pathname relative to the directory, for
+ *         tools given no copy of the BMC file tree
+ *
+ *  @param[in] config - file table config
+ *
+ *  @return pathname of the directory, to pass to sandboxConfig, or an empty
+ *          path on failure. The caller removes the directory.
+ */
+fs::path copyFiles(const fs::path& config);
+
+/** @class CopiedFiles
+ *
+ *  Removes a directory made by copyFiles, and the files in it, when it goes
+ *  out of scope
+ */
+class CopiedFiles
+{
+  public:
+    explicit CopiedFiles(fs::path dir) : dir(std::move(dir))
+    {
+    }
+
+    CopiedFiles(const CopiedFiles&) = delete;
+    CopiedFiles& operator=(const CopiedFiles&) = delete;
+
+    ~CopiedFiles()
+    {
+        std::error_code ec;
+        if (!dir.empty())
+        {
+            fs::remove_all(dir, ec);
+        }
+    }
+
+    /** @brief Get the pathname of the directory, empty if there is none */
+    const fs::path& path() const
+    {
+        return dir;
+    }
+
+  private:
+    fs::path dir;
+};
+
+/** @brief Emulate the DMA transfers of the handlers with a buffer that
+ *         stands in for host memory: reads from files go to the buffer and
+ *         writes to files take their data from it
+ *
+ *  Writes to files outside the sandbox fail with -EACCES, so that a config
+ *  that points outside of it cannot modify the original files.
+ *
+ *  @param[in] root - directory the files of the sandbox are under
+ */
+void emulateDMA(const fs::path& root);
+
+} // namespace tools
+} // namespace pldm
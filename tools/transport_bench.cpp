@@ -0,0 +1,192 @@
+/** @file transport_bench.cpp
+ *
+ *  Measures the messages per second the socket transport serves, receiving
+ *  and answering one message per system call next to a batch of messages
+ *  per recvmmsg and sendmmsg. Each client keeps a window of GetPLDMCommands
+ *  requests outstanding, so that the cost measured is the transport and
+ *  not the handler. Every request carries a distinct version, so that none
+ *  is answered from the replay cache.
+ *
+ *  Usage: transport_bench [-n requests] [-c clients] [-w window] [-b batch]
+ *    -n requests  requests sent by each client (200000)
+ *    -c clients   number of connections (4)
+ *    -w window    requests each client keeps outstanding (32)
+ *    -b batch     batch size compared to single messages (32)
+ */
+
+#include "libpldmresponder/event_loop.hpp"
+#include "libpldmresponder/transport.hpp"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libpldm/base.h"
+
+using namespace pldm::responder;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+/** @brief Send requests, window at a time, and wait for their responses
+ *
+ *  @return bool - true if every request was answered
+ */
+bool runClient(const std::string& name, size_t requests, size_t window)
+{
+    int fd = transport::connectSocket(name);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> frame{9, transport::mctpTypePldm};
+    frame.resize(transport::frameHeaderSize + sizeof(pldm_msg_hdr) +
+                 PLDM_GET_COMMANDS_REQ_BYTES);
+    auto request =
+        reinterpret_cast<pldm_msg*>(frame.data() + transport::frameHeaderSize);
+    std::vector<uint8_t> response(transport::maxFrameSize);
+
+    size_t done = 0;
+    bool ok = true;
+    while (ok && done < requests)
+    {
+        auto count = std::min(window, requests - done);
+        for (size_t i = 0; i < count; ++i)
+        {
+            // The handler does not check the version
+            uint32_t sequence = done + i;
+            ver32_t version{};
+            memcpy(&version, &sequence, sizeof(version));
+            encode_get_commands_req(sequence % 32, PLDM_BASE, version,
+                                    request);
+            if (send(fd, frame.data(), frame.size(), MSG_NOSIGNAL) < 0)
+            {
+                ok = false;
+            }
+        }
+        for (size_t i = 0; ok && i < count; ++i)
+        {
+            if (recv(fd, response.data(), response.size(), 0) <= 0)
+            {
+                ok = false;
+            }
+        }
+        done += count;
+    }
+    close(fd);
+    return ok;
+}
+
+/** @brief Serve clients with a batch size
+ *
+ *  @return messages per second, 0 on failure
+ */
+double messageRate(size_t batch, size_t clients, size_t requests,
+                   size_t window)
+{
+    auto name = "@pldm_transport_bench." + std::to_string(getpid()) + "." +
+                std::to_string(batch);
+    int listenFd = transport::listenSocket(name);
+    if (listenFd < 0)
+    {
+        return 0;
+    }
+
+    EventLoop loop;
+    transport::Server server(loop, listenFd, batch);
+    std::thread serving([&loop] { loop.run(); });
+
+    std::vector<std::thread> threads;
+    std::vector<char> results(clients);
+    auto start = Clock::now();
+    for (size_t c = 0; c < clients; ++c)
+    {
+        threads.emplace_back([&, c] {
+            results[c] = runClient(name, requests, window);
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    loop.stop();
+    serving.join();
+    for (auto result : results)
+    {
+        if (!result)
+        {
+            return 0;
+        }
+    }
+    return clients * requests / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t requests = 200000;
+    size_t clients = 4;
+    size_t window = 32;
+    size_t batch = 32;
+
+    int opt = 0;
+    while ((opt = getopt(argc, argv, "n:c:w:b:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                requests = strtoul(optarg, nullptr, 0);
+                break;
+            case 'c':
+                clients = strtoul(optarg, nullptr, 0);
+                break;
+            case 'w':
+                window = strtoul(optarg, nullptr, 0);
+                break;
+            case 'b':
+                batch = strtoul(optarg, nullptr, 0);
+                break;
+            default:
+                fprintf(stderr,
+                        "Usage: %s [-n requests] [-c clients] [-w window] "
+                        "[-b batch]\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (!window || !clients)
+    {
+        fprintf(stderr, "The window and number of clients must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    auto single = messageRate(1, clients, requests, window);
+    auto batched = messageRate(batch, clients, requests, window);
+    if (!single || !batched)
+    {
+        fprintf(stderr, "Requests were not answered\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("clients=%zu window=%zu requests=%zu\n", clients, window,
+           clients * requests);
+    auto label = "batch of up to " +
+                 std::to_string(std::min(batch, transport::maxBatch)) + ":";
+    printf("%-24s %10.0f messages/s\n", "single message per call:", single);
+    printf("%-24s %10.0f messages/s\n", label.c_str(), batched);
+    printf("%-24s %10.2fx\n", "speedup:", batched / single);
+    return EXIT_SUCCESS;
+}